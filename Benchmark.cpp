@@ -0,0 +1,447 @@
+/*
+ * Event Registration and Ticketing System - Benchmark
+ * Generates a synthetic users.txt / events.txt / tickets.txt dataset and times
+ * the loaders, savers, booking, journal replay, search, ticket lookup, gate check-in, reports and
+ * bulk repricing on it.
+ *
+ * Compile:  g++ -std=c++11 -O2 -pthread Benchmark.cpp -o Benchmark
+ * Run:      ./Benchmark [tickets] [events] [users] [bookings] [seed] > results.json
+ *
+ * The dataset files are written to a new eventbench.XXXXXX folder under $TMPDIR
+ * (or /tmp), never the current directory, and the folder is left for inspection.
+ * Results are printed to stdout as one JSON object.
+ */
+
+ #define EVENT_SYSTEM_NO_MAIN
+ #ifndef EVENT_SYSTEM_MAX_USERS
+ #define EVENT_SYSTEM_MAX_USERS 65536  // user handles keep the slot in the low 16 bits
+ #endif
+ #ifndef EVENT_SYSTEM_MAX_EVENTS
+ #define EVENT_SYSTEM_MAX_EVENTS 10000
+ #endif
+ #ifndef EVENT_SYSTEM_MAX_TICKETS
+ #define EVENT_SYSTEM_MAX_TICKETS 20000000
+ #endif
+ #include "Project.cpp"
+ #include <chrono>
+ #include <random>
+ #include <sstream>
+ #include <vector>
+ #include <unistd.h>  //for mkdtemp and chdir
+ 
+ // Function Prototypes - Benchmark Functions
+ string enterDatasetDirectory();
+ void generateDataset(int ticketTotal, int eventTotal, int userTotal, unsigned int seed);
+ double elapsedMicros(chrono::steady_clock::time_point start);
+ string timingToJSON(string name, vector<double>& samples);
+ 
+ int main(int argc, char* argv[]) {
+     int ticketTotal = argc > 1 ? atoi(argv[1]) : 100000;
+     int eventTotal = argc > 2 ? atoi(argv[2]) : 100;
+     int userTotal = argc > 3 ? atoi(argv[3]) : 10000;
+     int bookingTotal = argc > 4 ? atoi(argv[4]) : 200;
+     unsigned int seed = argc > 5 ? (unsigned int)atoi(argv[5]) : 42;
+     
+     if (ticketTotal < 1 || ticketTotal + bookingTotal > getMaxTickets() || eventTotal < 1 ||
+         eventTotal > getMaxEvents() || userTotal < 1 || userTotal > getMaxUsers() || bookingTotal < 1) {
+         cerr << "Sizes out of range (max " << getMaxTickets() << " tickets, " << getMaxEvents()
+              << " events, " << getMaxUsers() << " users)" << endl;
+         return 1;
+     }
+     string directory = enterDatasetDirectory();
+     if (directory == "") {
+         cerr << "Could not create a folder for the dataset" << endl;
+         return 1;
+     }
+     cerr << "Dataset folder: " << directory << endl;
+     
+     vector<string> results;
+     vector<double> samples;
+     chrono::steady_clock::time_point start = chrono::steady_clock::now();
+     generateDataset(ticketTotal, eventTotal, userTotal, seed);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("generateDataset", samples));
+     
+     // Heap arrays sized to the dataset, the interactive program keeps these on the stack
+     int ticketCapacity = ticketTotal + bookingTotal;
+     vector<string> usernames(userTotal), passwords(userTotal), emails(userTotal);
+     vector<int> userGenerations(userTotal), userFreeList(userTotal);
+     int userFreeCount = 0;
+     int userCount = 0;
+     
+     vector<string> eventNames(eventTotal), eventVenues(eventTotal), eventCategories(eventTotal);
+     vector<int> eventDates(eventTotal), eventCapacities(eventTotal), eventAvailable(eventTotal);
+     vector<double> eventPrices(eventTotal), eventRevenue(eventTotal);
+     vector<int> eventDateIndex(eventTotal), eventPriceIndex(eventTotal), availableEvents(eventTotal);
+     vector<int> availablePos(eventTotal), eventSeatsSold(eventTotal);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> eventGenerations(eventTotal), eventFreeList(eventTotal);
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows());
+     vector<int> eventTiers(eventTotal), eventTierSeatLimits(eventTotal), eventTierDateLimits(eventTotal);
+     int availableCount = 0;
+     int eventFreeCount = 0;
+     int eventCount = 0;
+     
+     vector<int> ticketIDs(ticketCapacity), ticketUserIDs(ticketCapacity), ticketEventIDs(ticketCapacity);
+     vector<int> ticketQuantities(ticketCapacity), ticketDates(ticketCapacity), ticketHours(ticketCapacity);
+     vector<int> ticketSeats(ticketCapacity), ticketTiers(ticketCapacity);
+     vector<int> ticketDateIndex(ticketCapacity);
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(ticketCapacity);
+     int ticketCount = 0;
+     
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     
+     vector<long long> userRateTimes(userTotal), eventRateTimes(eventTotal);
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     
+     start = chrono::steady_clock::now();
+     loadUsersFromTXT(&usernames[0], &passwords[0], &emails[0], &userGenerations[0], &userFreeList[0],
+                      userFreeCount, userCount);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("loadUsersFromTXT", samples));
+     
+     start = chrono::steady_clock::now();
+     loadEventsFromTXT(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0],
+                       &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], &eventFreeList[0],
+                       eventFreeCount, eventCount);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("loadEventsFromTXT", samples));
+     loadSeatMaps(&eventSeatMaps[0], &eventGenerations[0], eventCount);
+     
+     start = chrono::steady_clock::now();
+     loadTicketsFromTXT(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                        &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                        ticketCount, &usernames[0], &userGenerations[0], userCount);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("loadTicketsFromTXT", samples));
+     
+     buildDateIndex(&eventDateIndex[0], &eventDates[0], eventCount);
+     buildPriceIndex(&eventPriceIndex[0], &eventPrices[0], eventCount);
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildDateIndex(&ticketDateIndex[0], &ticketDates[0], ticketCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], ticketCount);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], ticketCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], ticketCount,
+                       &eventCapacities[0], &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0],
+                       &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0],
+                  &ticketHours[0], ticketCount, &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0],
+                  &eventGenerations[0], eventCount);
+     
+     start = chrono::steady_clock::now();
+     saveTicketsToTXT(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                      &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                      ticketCount, 0);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("saveTicketsToTXT", samples));
+     
+     // A booking only dirties the last partition
+     start = chrono::steady_clock::now();
+     saveTicketsToTXT(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                      &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                      ticketCount, ticketCount - 1);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("saveTicketsToTXTLastPartition", samples));
+     
+     // Startup cost with tickets.idx present, then lookups that page single segments back in
+     vector<long long> ticketSegmentOffsets(getMaxTicketSegments());
+     vector<int> ticketSegmentMinIDs(getMaxTicketSegments()), ticketSegmentMaxIDs(getMaxTicketSegments());
+     bool* ticketSegmentLoaded = new bool[getMaxTicketSegments()];
+     int ticketSegmentCount = 0;
+     int indexedTicketCount = 0;
+     start = chrono::steady_clock::now();
+     loadTicketIndex(&ticketSegmentOffsets[0], &ticketSegmentMinIDs[0], &ticketSegmentMaxIDs[0],
+                     ticketSegmentLoaded, ticketSegmentCount, indexedTicketCount);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("loadTicketIndex", samples));
+     
+     mt19937 lookups(seed + 2);
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         int ticketID = ticketIDs[lookups() % ticketCount];
+         start = chrono::steady_clock::now();
+         findTicketSegment(ticketID, &ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                           &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                           &ticketIDTable[0], &ticketSegmentMinIDs[0], &ticketSegmentMaxIDs[0], ticketSegmentLoaded,
+                           ticketSegmentCount, indexedTicketCount, false, &usernames[0], &userGenerations[0],
+                           userCount);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("findTicketSegment", samples));
+     delete[] ticketSegmentLoaded;
+     
+     // The reporting functions print straight to cout, send that to a buffer while timing
+     ostringstream sink;
+     streambuf* console = cout.rdbuf(sink.rdbuf());
+     mt19937 random(seed + 1);
+     
+     // Bookings arrive a second apart on the limiter clock, so each one goes through the whole path
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         int user = (int)(random() % userCount);
+         int eventIndex = (int)(random() % eventCount);
+         start = chrono::steady_clock::now();
+         bookTicket(makeHandle(user, userGenerations[user]), eventIndex, 1, &eventNames[0], &eventPrices[0],
+                    &eventAvailable[0], &availableEvents[0], &availablePos[0], availableCount,
+                    &eventCapacities[0], &eventSeatMaps[0], &eventDates[0], &eventTiers[0],
+                    &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0],
+                    &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0], eventFreeCount, eventCount,
+                    &ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0],
+                    &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0], &ticketDateIndex[0],
+                    &ticketIDTable[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], ticketCount, 0,
+                    i * 1000LL, &userRateTimes[0], &eventRateTimes[0], &purchaseKeys[0], &purchaseCounts[0]);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("bookTicket", samples));
+     
+     // What a booking used to cost on disk (every event partition) against one events.avail record
+     vector<int> dirtyPartitions(getMaxEventPartitions(), 1);
+     start = chrono::steady_clock::now();
+     saveEventsToTXT(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0],
+                     &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], &eventSeatMaps[0],
+                     eventCount, &dirtyPartitions[0]);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("saveEventsToTXT", samples));
+     
+     // An admin edit to one event
+     dirtyPartitions.assign(getMaxEventPartitions(), 0);
+     dirtyPartitions[0] = 1;
+     start = chrono::steady_clock::now();
+     saveEventsToTXT(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0],
+                     &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], &eventSeatMaps[0],
+                     eventCount, &dirtyPartitions[0]);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("saveEventsToTXTOnePartition", samples));
+     
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         int eventIndex = (int)(random() % eventCount);
+         start = chrono::steady_clock::now();
+         writeSeatRecord(eventIndex, eventAvailable[eventIndex]);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("writeSeatRecord", samples));
+     
+     // Each booking above appended to the journal, then replayed by a follower as upserts over rows it already has
+     ofstream journal;
+     startJournal(journal);
+     int bookedFrom = max(ticketCount - bookingTotal, 0);
+     samples.clear();
+     for (int i = bookedFrom; i < ticketCount; i++) {
+         start = chrono::steady_clock::now();
+         journalTickets(i, i + 1, &ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                        &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0], journal);
+         samples.push_back(elapsedMicros(start));
+     }
+     journal.close();
+     results.push_back(timingToJSON("journalTickets", samples));
+     
+     vector<long long> metricBuckets(getMetricCount() * getMetricBucketCount());
+     vector<long long> metricStats(getMetricCount() * getMetricStatCount());
+     long long replicaState[9] = {0, 0, 0, 0, 0, 0, 0, getWallMillis(), -1};
+     ifstream replay("journal.txt");
+     string line;
+     samples.clear();
+     while (getline(replay, line)) {
+         start = chrono::steady_clock::now();
+         applyJournalLine(line, &usernames[0], &emails[0], &userGenerations[0], userCount, &eventNames[0],
+                          &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0], &eventCapacities[0],
+                          &eventAvailable[0], &eventGenerations[0], eventCount, &ticketIDs[0], &ticketUserIDs[0],
+                          &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0],
+                          &ticketSeats[0], &ticketTiers[0], &ticketIDTable[0], ticketCount, replicaState,
+                          &metricBuckets[0], &metricStats[0]);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("applyJournalLine", samples));
+     
+     // Block search over seat maps the bookings above have already fragmented
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         int eventIndex = (int)(random() % eventCount);
+         start = chrono::steady_clock::now();
+         findSeatBlock(eventIndex, 1 + (int)(random() % 8), &eventSeatMaps[0], &eventCapacities[0]);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("findSeatBlock", samples));
+     
+     // A day's worth of kiosk keys through the fixed table, half of them retries of a recent key
+     vector<unsigned long long> requestKeyHashes(getRequestKeyTableSize());
+     vector<int> requestKeyTicketIDs(getRequestKeyTableSize());
+     vector<long long> requestKeyTimes(getRequestKeyTableSize());
+     clearRequestKeys(&requestKeyHashes[0], &requestKeyTicketIDs[0], &requestKeyTimes[0]);
+     samples.clear();
+     for (int i = 0; i < bookingTotal * 10; i++) {
+         int keyNumber = (i % 2 == 0) ? i : i - 1 - 2 * (int)(random() % 8);
+         unsigned long long keyHash = hashRequestKey("kiosk-" + to_string(keyNumber), keyNumber % 1000);
+         start = chrono::steady_clock::now();
+         if (findRequestKey(keyHash, i / 10, &requestKeyHashes[0], &requestKeyTicketIDs[0], 
+                            &requestKeyTimes[0]) == -1) {
+             rememberRequestKey(keyHash, 1001 + i, i / 10, &requestKeyHashes[0], &requestKeyTicketIDs[0], 
+                                &requestKeyTimes[0]);
+         }
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("requestKeyLookup", samples));
+     
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         string name = "Event " + to_string(random() % (eventCount * 2));
+         start = chrono::steady_clock::now();
+         searchEventByName(name, &eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0],
+                           &eventPrices[0], &eventCapacities[0], &eventAvailable[0], eventCount);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("searchEventByName", samples));
+     
+     samples.clear();
+     for (int i = 0; i < bookingTotal; i++) {
+         int ticketID = ticketIDs[random() % ticketCount];
+         start = chrono::steady_clock::now();
+         viewTicketByID(ticketID, &ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                        &ticketCosts[0], &ticketDates[0], &ticketSeats[0], &ticketTiers[0], &eventNames[0],
+                        &usernames[0], &emails[0], ticketCount, &eventGenerations[0], eventCount, &userGenerations[0], userCount);
+         samples.push_back(elapsedMicros(start));
+         sink.str("");
+     }
+     results.push_back(timingToJSON("viewTicketByID", samples));
+     
+     // Gate scans, one in five a forged ID above every issued one and a few repeats of tickets already admitted
+     vector<unsigned long long> checkInBloom(getBloomFilterWords()), checkInBitmap(getCheckInWords());
+     long long checkInState[9] = {-1, 0, 0, 0, 0, 0, 0, 0, 0};
+     start = chrono::steady_clock::now();
+     syncCheckInTables(&checkInBloom[0], &checkInBitmap[0], &ticketIDs[0], ticketCount, 0, checkInState);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("syncCheckInTables", samples));
+     samples.clear();
+     int highestID = ticketIDs[ticketCount - 1];
+     for (int i = 0; i < bookingTotal * 10; i++) {
+         int ticketID = i % 5 == 0 ? highestID + 1 + (int)(random() % 1000000) : ticketIDs[random() % ticketCount];
+         start = chrono::steady_clock::now();
+         checkInTicket(ticketID, -1, &checkInBloom[0], &checkInBitmap[0], &ticketIDTable[0], &ticketIDs[0],
+                       &ticketEventIDs[0], &ticketQuantities[0], &eventGenerations[0], eventCount, checkInState);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("checkInTicket", samples));
+     
+     start = chrono::steady_clock::now();
+     generateReports(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                     &ticketCosts[0], &eventNames[0], &eventPrices[0], ticketCount, &eventGenerations[0],
+                     eventCount);
+     samples.assign(1, elapsedMicros(start));
+     results.push_back(timingToJSON("generateReports", samples));
+     
+     // A bulk reprice of one category: the predicate pass, then one masked pass over the prices and one index sort
+     vector<int> selected(eventTotal), waitlistHeads(eventTotal), waitlistSizes(eventTotal);
+     samples.clear();
+     for (int i = 0; i < 10; i++) {
+         start = chrono::steady_clock::now();
+         selectEvents("Music", "", 0, numeric_limits<int>::max(), &eventCategories[0], &eventVenues[0], &eventDates[0],
+                      &eventGenerations[0], eventCount, &selected[0]);
+         bulkUpdateEvents(0, i % 2 == 0 ? 1.1 : 1 / 1.1, &selected[0], &eventNames[0], &eventDates[0], &eventVenues[0],
+                          &eventCategories[0], &eventPrices[0], &eventCapacities[0], &eventAvailable[0],
+                          &eventDateIndex[0], &eventPriceIndex[0], &availableEvents[0], &availablePos[0],
+                          availableCount, &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                          &leaderboardPos[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventTiers[0],
+                          &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventSeatMaps[0], &waitlistHeads[0],
+                          &waitlistSizes[0], &eventGenerations[0], &eventFreeList[0], eventFreeCount, eventCount);
+         samples.push_back(elapsedMicros(start));
+     }
+     results.push_back(timingToJSON("bulkUpdateEvents", samples));
+     
+     cout.rdbuf(console);
+     
+     cout << "{\n  \"tickets\": " << ticketTotal << ",\n  \"events\": " << eventTotal
+          << ",\n  \"users\": " << userTotal << ",\n  \"bookings\": " << bookingTotal
+          << ",\n  \"seed\": " << seed << ",\n  \"results\": [\n";
+     for (int i = 0; i < (int)results.size(); i++) {
+         cout << "    " << results[i] << (i + 1 < (int)results.size() ? ",\n" : "\n");
+     }
+     cout << "  ]\n}" << endl;
+     return 0;
+ }
+ 
+ // Benchmark Functions
+ string enterDatasetDirectory() {
+     // A fresh folder per run so the generated files can never overwrite a real data set
+     const char* base = getenv("TMPDIR");
+     string pattern = string(base != NULL && base[0] != '\0' ? base : "/tmp") + "/eventbench.XXXXXX";
+     vector<char> path(pattern.begin(), pattern.end());
+     path.push_back('\0');
+     if (mkdtemp(&path[0]) == NULL || chdir(&path[0]) != 0) {
+         return "";
+     }
+     return string(&path[0]);
+ }
+ 
+ void generateDataset(int ticketTotal, int eventTotal, int userTotal, unsigned int seed) {
+     mt19937 random(seed);
+     
+     ofstream users("users.txt");
+     for (int i = 0; i < userTotal; i++) {
+         users << "user" << i << "|pass" << i << "|user" << i << "@example.com|0\n";
+     }
+     users.close();
+     
+     // Zipf-like popularity, event k is picked with weight 1/(k+1) so a few events sell most seats
+     vector<double> weights(eventTotal);
+     vector<double> prices(eventTotal);
+     for (int i = 0; i < eventTotal; i++) {
+         weights[i] = 1.0 / (i + 1);
+         prices[i] = 10 + (int)(random() % 191);
+     }
+     discrete_distribution<int> pickEvent(weights.begin(), weights.end());
+     vector<long long> seatsSold(eventTotal, 0);
+     
+     // Bookings spread over the last year, ticket IDs start where generateTicketID would
+     int today = getCurrentDate();
+     ofstream tickets("tickets.txt");
+     for (int i = 0; i < ticketTotal; i++) {
+         int eventIndex = pickEvent(random);
+         int quantity = 1 + (int)(random() % 4);
+         seatsSold[eventIndex] += quantity;
+         tickets << (1001 + i) << "|" << (int)(random() % userTotal) << "|" << eventIndex << "|" << quantity
+                 << "|" << compactNumber(prices[eventIndex] * quantity) << "|"
+                 << formatDate(today - (int)(random() % 365)) << "|" << (int)(random() % 24) << "\n";
+     }
+     tickets.close();
+     
+     // Capacities leave room so every event can still take the timed bookings
+     string categories[4] = {"Music", "Conference", "Sports", "Other"};
+     ofstream events("events.txt");
+     for (int i = 0; i < eventTotal; i++) {
+         long long available = 1000 + random() % 1000;
+         events << "Event " << i << "|" << formatDate(today - 180 + (int)(random() % 365)) << "|Venue "
+                << (i % 20) << "|" << categories[i % 4] << "|" << to_string(prices[i]) << "|"
+                << (seatsSold[i] + available) << "|" << available << "|0\n";
+     }
+     events.close();
+ }
+ 
+ double elapsedMicros(chrono::steady_clock::time_point start) {
+     return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+ }
+ 
+ string timingToJSON(string name, vector<double>& samples) {
+     vector<double> sorted(samples);
+     sort(sorted.begin(), sorted.end());
+     double total = 0.0;
+     for (int i = 0; i < (int)sorted.size(); i++) {
+         total += sorted[i];
+     }
+     int count = (int)sorted.size();
+     
+     ostringstream json;
+     json << "{\"name\": \"" << name << "\", \"iterations\": " << count
+          << ", \"total_us\": " << total << ", \"mean_us\": " << total / count
+          << ", \"p50_us\": " << sorted[count / 2] << ", \"p99_us\": " << sorted[(count * 99) / 100]
+          << ", \"max_us\": " << sorted[count - 1] << "}";
+     return json.str();
+ }
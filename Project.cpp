@@ -14,6 +14,13 @@
  #include <fstream>
  #include <string>
  #include <limits>  //for input buffer
+ #include <ctime>   //for the system clock in getCurrentDate
+ #include <algorithm>  //for stable_sort when building the date index
+ #include <chrono>  //for the steady clock behind the latency metrics
+ #include <thread>  //for loading the data files in parallel (link with -pthread)
+ #include <mutex>  //for handing snapshots to the persistence worker
+ #include <condition_variable>
+ #include <cstdlib>  //for strtod in the column readers
    //These are the settings of windows to use term colors library else compile give us error.
   // needed so COMMON_LVB_UNDERSCORE is defined
  #ifdef _WIN32
@@ -25,10 +32,79 @@
  using namespace std;
  using namespace termcolor;
  
+ // Table sizes, the benchmark build raises these with -D to load large synthetic datasets
+ #ifndef EVENT_SYSTEM_MAX_USERS
+ #define EVENT_SYSTEM_MAX_USERS 100
+ #endif
+ #ifndef EVENT_SYSTEM_MAX_EVENTS
+ #define EVENT_SYSTEM_MAX_EVENTS 100
+ #endif
+ #ifndef EVENT_SYSTEM_MAX_TICKETS
+ #define EVENT_SYSTEM_MAX_TICKETS 500
+ #endif
+ // Most tickets one customer may hold for one event, a flash sale can lower it with -DEVENT_SYSTEM_TICKET_CAP
+ #ifndef EVENT_SYSTEM_TICKET_CAP
+ #define EVENT_SYSTEM_TICKET_CAP 10
+ #endif
+ // Build with -DEVENT_SYSTEM_NO_METRICS to turn the latency metrics into empty calls,
+ // and with -DEVENT_SYSTEM_TRACE to write a Chrome trace of the session to trace.json on exit
+ 
  // Function Prototypes - Constants (Replaced global variables with functions)
  const int getMaxUsers();
  const int getMaxEvents();
  const int getMaxTickets();
+ const int getBrowsePageSize();
+ const int getLeaderboardMetricCount();
+ const int getLeaderboardSize();
+ const int getRollupHours();
+ const int getRollupDays();
+ const int getEventRollupHours();
+ const int getEventRollupDays();
+ const int getRollupSize();
+ const int getHandleSlotSpan();
+ const int getGenerationLimit();
+ const int getMetricCount();
+ const int getMetricSubBuckets();
+ const int getMetricBucketCount();
+ const int getMetricStatCount();
+ const int getTraceCapacity();
+ const int getTraceRingCount();
+ const bool isTraceEnabled();
+ const int getTicketSegmentSize();
+ const int getMaxTicketSegments();
+ const int getEventPartitionSize();
+ const int getMaxEventPartitions();
+ const int getMaxQueryTerms();
+ const int getMaxLoadThreads();
+ const int getMinLoadBytesPerThread();
+ const int getPersistDelayMillis();
+ const int getSeatRecordWidth();
+ const int getTicketIDTableSize();
+ const int getWaitlistCapacity();
+ const int getWaitlistScanLimit();
+ const int getSeatsPerRow();
+ const int getMaxSeatRows();
+ const int getRowsPerSection();
+ const int getSeatMapRecordWidth();
+ const int getEarlyBirdDays();
+ const int getLastSeatsCount();
+ const int getRequestKeyTableSize();
+ const int getRequestKeyProbes();
+ const int getRequestKeySeconds();
+ const int getTicketCapPerUser();
+ const int getPurchaseTableSize();
+ const int getUserBookingBurst();
+ const int getUserBookingInterval();
+ const int getEventBookingBurst();
+ const int getEventBookingInterval();
+ const int getJournalPollMillis();
+ const int getUserColumnCount();
+ const int getEventColumnCount();
+ const int getTicketColumnCount();
+ const int getBloomFilterWords();
+ const int getBloomHashCount();
+ const int getCheckInSpan();
+ const int getCheckInWords();
  string getAdminUsername();
  string getAdminPassword();
  
@@ -38,29 +114,122 @@
  void displayMainMenu();
  void displayAdminMenu();
  void displayUserMenu();
+ void displayReplicaMenu();
  string getUserChoice();
  void pauseScreen();
+ void printEventList(string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[], int eventCount);
+ void printUserList(string usernames[], string emails[], int userGenerations[], int userCount);
  
  // Function Prototypes - Authentication
  bool adminLogin();
  string userLogin(string usernames[], string passwords[], int userCount);
- bool userSignup(string usernames[], string passwords[], string emails[], int& userCount);
+ bool userSignup(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                 int userFreeList[], int& userFreeCount, int& userCount);
  
  // Function Prototypes - File Handling (TXT Format)
- void loadUsersFromTXT(string usernames[], string passwords[], string emails[], int& userCount);
- void saveUsersToTXT(string usernames[], string passwords[], string emails[], int userCount);
- void loadEventsFromTXT(string eventNames[], string eventDates[], string eventVenues[], 
+ void loadUsersFromTXT(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                       int userFreeList[], int& userFreeCount, int& userCount);
+ long long saveUsersToTXT(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                          int userCount);
+ void loadEventsFromTXT(string eventNames[], int eventDates[], string eventVenues[], 
                         string eventCategories[], double eventPrices[], int eventCapacities[], 
-                        int eventAvailable[], int& eventCount);
- void saveEventsToTXT(string eventNames[], string eventDates[], string eventVenues[], 
-                      string eventCategories[], double eventPrices[], int eventCapacities[], 
-                      int eventAvailable[], int eventCount);
- void loadTicketsFromTXT(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                         int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                         string ticketDates[], int& ticketCount);
- void saveTicketsToTXT(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                       int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                       string ticketDates[], int ticketCount);
+                        int eventAvailable[], int eventGenerations[], int eventFreeList[], 
+                        int& eventFreeCount, int& eventCount);
+ bool parseEventLine(string line, int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[]);
+ void loadEventPartitionRange(int firstPartition, int lastPartition, int partitionSize, int eventCount, 
+                              string eventNames[], int eventDates[], string eventVenues[], 
+                              string eventCategories[], double eventPrices[], int eventCapacities[], 
+                              int eventAvailable[], int eventGenerations[]);
+ long long saveEventsToTXT(string eventNames[], int eventDates[], string eventVenues[], 
+                           string eventCategories[], double eventPrices[], int eventCapacities[], 
+                           int eventAvailable[], int eventGenerations[], unsigned long long eventSeatMaps[], 
+                           int eventCount, int dirtyPartitions[]);
+ string formatEventLine(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                        string eventCategories[], double eventPrices[], int eventCapacities[], 
+                        int eventAvailable[], int eventGenerations[], int eventCount);
+ string getEventPartitionFileName(int partition);
+ string getTicketPartitionFileName(int partition);
+ long long getFileSize(string filename);
+ bool replaceFile(string temporary, string target);
+ string formatSeatRecord(int available);
+ void loadWaitlistFromTXT(int waitlistUserIDs[], int waitlistQuantities[], int waitlistHeads[], 
+                          int waitlistSizes[], int eventGenerations[], int eventCount);
+ long long saveWaitlistToTXT(int waitlistEventIDs[], int waitlistUserIDs[], int waitlistQuantities[], 
+                             int waitlistRows);
+ void loadSeatRecords(int eventAvailable[], int eventGenerations[], int eventCount);
+ long long writeSeatRecord(int eventIndex, int available);
+ string formatSeatMapRecord(unsigned long long rowWords[]);
+ void loadSeatMaps(unsigned long long eventSeatMaps[], int eventGenerations[], int eventCount);
+ long long writeSeatMapRecord(int eventIndex, unsigned long long rowWords[]);
+ void loadTicketsFromTXT(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                         double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                         int ticketTiers[], int& ticketCount, string usernames[], int userGenerations[], 
+                         int userCount);
+ long long saveTicketsToTXT(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                            int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                            int ticketHours[], int ticketSeats[], int ticketTiers[], int ticketCount, 
+                            int firstDirty);
+ string formatTicketLine(int i, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                         int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                         int ticketSeats[], int ticketTiers[]);
+ bool parseTicketLine(string line, int position, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                      int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                      int ticketSeats[], int ticketTiers[], string usernames[], int userGenerations[], 
+                      int userCount);
+ bool loadTicketIndex(long long ticketSegmentOffsets[], int ticketSegmentMinIDs[], 
+                      int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], 
+                      int& ticketSegmentCount, int& ticketCount);
+ void loadTicketSegment(int segment, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                        int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                        int ticketSeats[], int ticketTiers[], bool ticketSegmentLoaded[], int ticketCount, 
+                        string usernames[], int userGenerations[], int userCount);
+ bool ensureTicketsLoaded(bool& ticketsLoaded, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                          int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                          int ticketSeats[], int ticketTiers[], long long ticketSegmentOffsets[], 
+                          bool ticketSegmentLoaded[], int ticketSegmentCount, int ticketCount, 
+                          string usernames[], int userGenerations[], int userCount);
+ int findTicketSegment(int ticketID, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                       int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                       int ticketSeats[], int ticketTiers[], int ticketIDTable[], int ticketSegmentMinIDs[], 
+                       int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], int ticketSegmentCount, 
+                       int ticketCount, bool ticketsLoaded, string usernames[], int userGenerations[], 
+                       int userCount);
+ int getLoadThreadCount(long long bytes);
+ void countTicketLines(long long begin, long long end, int& lineCount);
+ void parseTicketRange(long long begin, long long end, int firstPosition, int ticketIDs[], 
+                       int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                       double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                       int ticketTiers[], string usernames[], int userGenerations[], int userCount, 
+                       int& lineCount, int& rejected);
+ void loadTicketSegmentRange(int firstSegment, int lastSegment, int ticketIDs[], int ticketUserIDs[], 
+                             int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                             int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                             bool ticketSegmentLoaded[], int ticketCount, string usernames[], 
+                             int userGenerations[], int userCount);
+ 
+ // Function Prototypes - Record Schema Functions (a row is one line of '|' separated columns, column c runs from
+ // starts[c] up to ends[c]; the row helpers move or clear every column of one table row at once)
+ int splitColumns(string& line, int starts[], int ends[], int maxColumns);
+ int readIntColumn(string& line, int start, int end);
+ bool isDigitColumn(string& line, int start, int end, int maxDigits);
+ double readDoubleColumn(string& line, int start, int end);
+ int readDateColumn(string& line, int start, int end);
+ void moveUserRow(int from, int to, string usernames[], string passwords[], string emails[], 
+                  int userGenerations[]);
+ void clearUserRow(int slot, string usernames[], string passwords[], string emails[]);
+ void moveEventRow(int from, int to, string eventNames[], int eventDates[], string eventVenues[], 
+                   string eventCategories[], double eventPrices[], int eventCapacities[], 
+                   int eventAvailable[], int eventGenerations[]);
+ void clearEventRow(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                    string eventCategories[], double eventPrices[], int eventCapacities[], 
+                    int eventAvailable[]);
+ void moveTicketRow(int from, int to, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                    int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                    int ticketSeats[], int ticketTiers[]);
  
  // Function Prototypes - Validation Functions
  bool isUsernameUnique(string username, string usernames[], int userCount);
@@ -70,99 +239,729 @@
  double getValidDouble(string prompt);
  void clearInputBuffer();
  
- // Function Prototypes - Utility Functions
- string getCurrentDate();
+ // Function Prototypes - Utility Functions (dates are packed as days since 01-01-1970)
+ int getCurrentDate();
+ int getCurrentHour();
+ long long getCurrentMillis();
+ long long getWallMillis();
+ int dateToDays(int day, int month, int year);
+ int parseDate(string date);
+ string formatDate(int days);
+ string compactNumber(double value);
  
  // Function Prototypes - Event Management Functions
- string addEvent(string name, string date, string venue, string category, double price, 
-                 int capacity, string eventNames[], string eventDates[], string eventVenues[], 
+ string addEvent(string name, int date, string venue, string category, double price, 
+                 int capacity, string eventNames[], int eventDates[], string eventVenues[], 
                  string eventCategories[], double eventPrices[], int eventCapacities[], 
-                 int eventAvailable[], int& eventCount);
- string updateEvent(int index, string name, string date, string venue, string category, 
+                 int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                 int availableEvents[], int availablePos[], int& availableCount, 
+                 double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                 int leaderboardPos[], int eventGenerations[], int eventFreeList[], 
+                 int& eventFreeCount, int& eventCount);
+ string updateEvent(int index, string name, int date, string venue, string category, 
                     double price, int capacity, int available, string eventNames[], 
-                    string eventDates[], string eventVenues[], string eventCategories[], 
-                    double eventPrices[], int eventCapacities[], int eventAvailable[]);
- string deleteEvent(int index, string eventNames[], string eventDates[], string eventVenues[], 
+                    int eventDates[], string eventVenues[], string eventCategories[], 
+                    double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                    int eventDateIndex[], int eventPriceIndex[], int availableEvents[], 
+                    int availablePos[], int& availableCount, double eventRevenue[], 
+                    int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                    int eventGenerations[], int eventFreeCount, int eventCount);
+ string deleteEvent(int index, string eventNames[], int eventDates[], string eventVenues[], 
                     string eventCategories[], double eventPrices[], int eventCapacities[], 
-                    int eventAvailable[], int& eventCount);
- string viewAllEvents(string eventNames[], string eventDates[], string eventVenues[], 
+                    int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                    int availableEvents[], int availablePos[], int& availableCount, 
+                    double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                    int leaderboardPos[], int rollupKeys[], double rollupRevenue[], 
+                    int rollupTickets[], int eventGenerations[], int eventFreeList[], 
+                    int& eventFreeCount, int eventCount);
+ string viewAllEvents(string eventNames[], int eventDates[], string eventVenues[], 
                       string eventCategories[], double eventPrices[], int eventCapacities[], 
-                      int eventAvailable[], int eventCount);
- string searchEventByName(string name, string eventNames[], string eventDates[], 
+                      int eventAvailable[], int eventGenerations[], int eventCount);
+ string searchEventByName(string name, string eventNames[], int eventDates[], 
                           string eventVenues[], string eventCategories[], double eventPrices[], 
                           int eventCapacities[], int eventAvailable[], int eventCount);
- string searchEventByCategory(string category, string eventNames[], string eventDates[], 
+ string searchEventByCategory(string category, string eventNames[], int eventDates[], 
                               string eventVenues[], string eventCategories[], double eventPrices[], 
                               int eventCapacities[], int eventAvailable[], int eventCount);
  
+ // Function Prototypes - Date Index Functions (index holds ids sorted by date)
+ void buildDateIndex(int dateIndex[], int dates[], int count);
+ int lowerBoundDate(int date, int dateIndex[], int dates[], int count);
+ void insertDateIndex(int id, int dateIndex[], int dates[], int count);
+ void removeDateIndex(int id, int dateIndex[], int dates[], int count);
+ string viewUpcomingEvents(string eventNames[], int eventDates[], string eventVenues[], 
+                           string eventCategories[], double eventPrices[], int eventCapacities[], 
+                           int eventAvailable[], int eventDateIndex[], int eventCount);
+ string searchEventsByDateRange(int fromDate, int toDate, string eventNames[], int eventDates[], 
+                                string eventVenues[], string eventCategories[], double eventPrices[], 
+                                int eventCapacities[], int eventAvailable[], int eventDateIndex[], 
+                                int eventCount);
+ string viewTicketsSoldOnDate(int date, int ticketIDs[], int ticketUserIDs[], 
+                              int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                              int ticketDates[], int ticketDateIndex[], string eventNames[], 
+                              string usernames[], int ticketCount, int eventGenerations[], 
+                              int eventCount, int userGenerations[], int userCount);
+ 
+ // Function Prototypes - Price & Availability Index Functions
+ void buildPriceIndex(int priceIndex[], double prices[], int count);
+ int lowerBoundPrice(double price, int priceIndex[], double prices[], int count);
+ int upperBoundPrice(double price, int priceIndex[], double prices[], int count);
+ void insertPriceIndex(int id, int priceIndex[], double prices[], int count);
+ void removePriceIndex(int id, int priceIndex[], double prices[], int count);
+ void buildAvailableSet(int eventAvailable[], double eventPrices[], int eventCount, int availableEvents[], 
+                        int availablePos[], int& availableCount);
+ void sortAvailableSet(double eventPrices[], int availableEvents[], int availablePos[], int availableCount);
+ void syncAvailableSet(int eventIndex, int eventAvailable[], double eventPrices[], int availableEvents[], 
+                       int availablePos[], int& availableCount);
+ void removeAvailableEvent(int eventIndex, int availableEvents[], int availablePos[], int& availableCount);
+ string browseEventsByPrice(double minPrice, double maxPrice, bool onlyAvailable, int page, 
+                            string eventNames[], int eventDates[], string eventVenues[], 
+                            string eventCategories[], double eventPrices[], int eventCapacities[], 
+                            int eventAvailable[], int eventPriceIndex[], int availableEvents[], 
+                            int availableCount, int eventCount);
+ 
+ // Function Prototypes - Query Functions (field 0 = name, 1 = category, 2 = venue, 3 = date range, 4 = price range,
+ // 5 = has seats; terms in the same group are ANDed and the groups are ORed)
+ bool matchesQueryTerm(int eventIndex, int field, string text, double low, double high, string eventNames[], 
+                       int eventDates[], string eventVenues[], string eventCategories[], double eventPrices[], 
+                       int eventAvailable[]);
+ int estimateQueryTerm(int field, double low, double high, int eventDates[], int eventDateIndex[], 
+                       double eventPrices[], int eventPriceIndex[], int availableCount, int liveCount, 
+                       int& first, int& last);
+ int queryEvents(int termFields[], int termGroups[], string termTexts[], double termLows[], 
+                 double termHighs[], int termCount, int groupCount, string eventNames[], int eventDates[], 
+                 string eventVenues[], string eventCategories[], double eventPrices[], int eventAvailable[], 
+                 int eventDateIndex[], int eventPriceIndex[], int availableEvents[], int availableCount, 
+                 int eventGenerations[], int eventFreeCount, int eventCount, int results[]);
+ string formatQueryResults(int results[], int resultCount, string eventNames[], int eventDates[], 
+                           string eventVenues[], string eventCategories[], double eventPrices[], 
+                           int eventCapacities[], int eventAvailable[], int eventGenerations[], int eventCount);
+ 
+ // Function Prototypes - Leaderboard Functions (metric 0 = revenue, 1 = seats sold, 2 = sell-through)
+ double getLeaderboardScore(int metric, int eventIndex, double eventRevenue[], int eventSeatsSold[], 
+                            int eventCapacities[], int eventAvailable[]);
+ string getLeaderboardMetricName(int metric);
+ bool ranksAhead(int metric, int a, int b, double eventRevenue[], int eventSeatsSold[], 
+                 int eventCapacities[], int eventAvailable[]);
+ void buildLeaderboards(int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                        int ticketCount, int eventCapacities[], int eventAvailable[], 
+                        double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                        int leaderboardPos[], int eventGenerations[], int eventCount);
+ void rankLeaderboards(int eventCapacities[], int eventAvailable[], double eventRevenue[], 
+                       int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                       int eventGenerations[], int eventCount);
+ void updateLeaderboards(int eventIndex, int eventCapacities[], int eventAvailable[], 
+                         double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                         int leaderboardPos[], int eventCount);
+ void removeFromLeaderboards(int eventIndex, int leaderboardRanks[], int leaderboardPos[], int eventCount);
+ string viewLeaderboard(int metric, string eventNames[], int eventCapacities[], int eventAvailable[], 
+                        double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                        int eventCount);
+ 
+ // Function Prototypes - Sales Rollup Functions (level 0 = hour buckets, 1 = day buckets, eventIndex -1 = all events)
+ int getRollupRingStart(int level, int eventIndex);
+ int getRollupRingSize(int level, int eventIndex);
+ void clearRollups(int rollupKeys[], double rollupRevenue[], int rollupTickets[]);
+ void addToRollup(int level, int eventIndex, int key, double revenue, int quantity, 
+                  int rollupKeys[], double rollupRevenue[], int rollupTickets[]);
+ void recordSale(int eventIndex, int date, int hour, double revenue, int quantity, 
+                 int rollupKeys[], double rollupRevenue[], int rollupTickets[]);
+ void buildRollups(int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                   int ticketDates[], int ticketHours[], int ticketCount, int rollupKeys[], 
+                   double rollupRevenue[], int rollupTickets[], int eventGenerations[], int eventCount);
+ int readRollup(int level, int eventIndex, int key, int rollupKeys[], double rollupRevenue[], 
+                int rollupTickets[], double& revenue);
+ string viewSalesRollups(int eventIndex, string eventNames[], int rollupKeys[], 
+                         double rollupRevenue[], int rollupTickets[]);
+ 
+ // Function Prototypes - Metrics Functions (HDR-style log-linear latency histograms, one row of buckets per metric)
+ // Metrics: 0 bookTicket, 1-3 load users/events/tickets, 4-6 save users/events/tickets,
+ //          7 search by name, 8 search by category, 9 search by date range, 10 browse by price, 11 reports,
+//          12 event queries, 13 replication lag (journal write to follower apply), 14 gate check-in,
+ //          15 seat and seat map records, 16 save waitlists. The persistence worker records 4-6, 15 and 16
+ //          under persistLock, so the front end takes that lock to read them
+ long long getMicros();
+ int getMetricBucket(long long micros);
+ long long getMetricBucketLimit(int bucket);
+ string getMetricName(int metric);
+ void clearMetrics(long long metricBuckets[], long long metricStats[]);
+ void recordMetric(int metric, long long micros, long long bytes, long long metricBuckets[], 
+                   long long metricStats[]);
+ long long getMetricPercentile(int metric, double percentile, long long metricBuckets[], 
+                               long long metricStats[]);
+ string viewMetrics(long long metricBuckets[], long long metricStats[]);
+ string dumpMetricsToFile(string filename, long long metricBuckets[], long long metricStats[]);
+ 
+ // Function Prototypes - Trace Functions (traceSpans holds one ring of getTraceCapacity() spans per thread, ring r
+ // starts at r * getTraceCapacity() * 5 and each span is metric, start, duration, bytes, thread id; traceCounts[r]
+ // counts the spans ring r has taken. recordTrace() and finishTimedCall() get the caller's own ring and count)
+ void recordTrace(int metric, long long start, long long micros, long long bytes, long long traceSpans[], 
+                  long long& traceCount);
+ void finishTimedCall(int metric, long long start, long long bytes, long long metricBuckets[], 
+                      long long metricStats[], long long traceSpans[], long long& traceCount);
+ void finishLockedCall(int metric, long long start, long long bytes, long long metricBuckets[], 
+                       long long metricStats[], long long traceSpans[], long long& traceCount, mutex& metricLock);
+ string writeTraceToFile(string filename, long long traceSpans[], long long traceCounts[]);
+ 
+ // Function Prototypes - Slot Map Functions (handle = generation * span + slot, an odd generation marks a deleted slot)
+ int makeHandle(int slot, int generation);
+ int resolveHandle(int handle, int generations[], int count);
+ bool isSlotLive(int slot, int generations[], int count);
+ int allocateSlot(int generations[], int freeList[], int& freeCount, int& count, int maxCount);
+ void releaseSlot(int slot, int generations[], int freeList[], int& freeCount);
+ bool hasOldGeneration(int generations[], int count);
+ void remapHandles(int handles[], int handleCount, int newSlots[], int generations[], int count);
+ bool compactEvents(string eventNames[], int eventDates[], string eventVenues[], 
+                    string eventCategories[], double eventPrices[], int eventCapacities[], 
+                    int eventAvailable[], int eventGenerations[], int& eventFreeCount, 
+                    int& eventCount, int ticketEventIDs[], int ticketCount, int waitlistUserIDs[], 
+                    int waitlistQuantities[], int waitlistHeads[], int waitlistSizes[], 
+                    unsigned long long eventSeatMaps[]);
+ bool compactUsers(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                   int& userFreeCount, int& userCount, int ticketUserIDs[], int ticketCount, 
+                   int waitlistUserIDs[]);
+ 
  // Function Prototypes - User Management Functions
  string addUser(string username, string password, string email, string usernames[], 
-                string passwords[], string emails[], int& userCount);
- string deleteUser(int index, string usernames[], string passwords[], string emails[], int& userCount);
- string viewAllUsers(string usernames[], string emails[], int userCount);
+                string passwords[], string emails[], int userGenerations[], int userFreeList[], 
+                int& userFreeCount, int& userCount);
+ string deleteUser(int index, string usernames[], string passwords[], string emails[], 
+                   int userGenerations[], int userFreeList[], int& userFreeCount, int userCount);
+ string viewAllUsers(string usernames[], string emails[], int userGenerations[], int userCount);
  int findUserIndex(string username, string usernames[], int userCount);
  string getUserEmail(string username, string usernames[], string emails[], int userCount);
+ string resolveUsername(int userHandle, string usernames[], int userGenerations[], int userCount);
+ string resolveEmail(int userHandle, string emails[], int userGenerations[], int userCount);
  
  // Function Prototypes - Ticket Management Functions
- int generateTicketID(int ticketIDs[], int ticketCount);
- string bookTicket(string username, string email, int eventIndex, int quantity, 
-                   string eventNames[], double eventPrices[], int eventAvailable[], 
-                   int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                   int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                   string ticketDates[], int& ticketCount);
- string viewUserTickets(string username, int ticketIDs[], string ticketUsernames[], 
-                        string ticketEmails[], int ticketEventIDs[], int ticketQuantities[], 
-                        double ticketCosts[], string ticketDates[], string eventNames[], 
-                        int ticketCount, int eventCount);
- string viewTicketByID(int ticketID, int ticketIDs[], string ticketUsernames[], 
-                       string ticketEmails[], int ticketEventIDs[], int ticketQuantities[], 
-                       double ticketCosts[], string ticketDates[], string eventNames[], 
-                       int ticketCount, int eventCount);
- string viewAllRegistrations(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
+ int generateTicketID(int ticketIDs[], int ticketIDTable[], int ticketCount, int lastArchivedTicketID);
+ string bookTicket(int userHandle, int eventIndex, int quantity, string eventNames[], double eventPrices[], 
+                   int eventAvailable[], int availableEvents[], int availablePos[], int& availableCount, 
+                   int eventCapacities[], unsigned long long eventSeatMaps[], int eventDates[], 
+                   int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[], 
+                   double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                   int eventGenerations[], int eventFreeCount, int eventCount, int ticketIDs[], 
+                   int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                   int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                   int ticketDateIndex[], int ticketIDTable[], int rollupKeys[], double rollupRevenue[], 
+                   int rollupTickets[], int& ticketCount, int lastArchivedTicketID, long long now, 
+                   long long userRateTimes[], long long eventRateTimes[], long long purchaseKeys[], 
+                   int purchaseCounts[]);
+ string formatBookingResult(int ticketIndex, string eventNames[], int ticketIDs[], int ticketEventIDs[], 
+                            int ticketQuantities[], double ticketCosts[], int ticketSeats[], int ticketTiers[], 
+                            int eventGenerations[], int eventCount);
+ string viewUserTickets(int userHandle, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                        int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketSeats[], 
+                        int ticketTiers[], string eventNames[], int ticketCount, int eventGenerations[], 
+                        int eventCount);
+ string viewTicketByID(int ticketID, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                       int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketSeats[], 
+                       int ticketTiers[], string eventNames[], string usernames[], string emails[], 
+                       int ticketCount, int eventGenerations[], int eventCount, int userGenerations[], 
+                       int userCount);
+ string viewAllRegistrations(int ticketIDs[], int ticketUserIDs[], 
                              int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                             string ticketDates[], string eventNames[], int ticketCount, 
-                             int eventCount);
+                             int ticketDates[], string eventNames[], string usernames[], 
+                             string emails[], int ticketCount, int eventGenerations[], int eventCount, 
+                             int userGenerations[], int userCount);
  
  // Function Prototypes - Report Functions
- void generateReports(int ticketIDs[], string ticketUsernames[], int ticketEventIDs[], 
+ void generateReports(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
                       int ticketQuantities[], double ticketCosts[], string eventNames[], 
-                      double eventPrices[], int ticketCount, int eventCount);
+                      double eventPrices[], int ticketCount, int eventGenerations[], 
+                      int eventCount);
  double calculateTotalRevenue(int ticketIDs[], double ticketCosts[], int ticketCount);
- int calculateTotalBookings(int ticketIDs[], int ticketCount);
- int calculateEventBookings(int eventIndex, int ticketEventIDs[], int ticketCount);
+ int calculateTotalBookings(int ticketIDs[], int ticketQuantities[], int ticketCount);
+ int calculateEventBookings(int eventHandle, int ticketEventIDs[], int ticketQuantities[], int ticketCount);
+ 
+ // Function Prototypes - Cancellation & Waitlist Functions (each event owns a ring of getWaitlistCapacity()
+ // requests starting at eventIndex * getWaitlistCapacity(); waitlistHeads[] is the oldest request, waitlistSizes[] the count)
+ void buildTicketIDTable(int ticketIDTable[], int ticketIDs[], int ticketCount);
+ void insertTicketID(int ticketIndex, int ticketIDTable[], int ticketIDs[]);
+ int findTicketIndex(int ticketID, int ticketIDTable[], int ticketIDs[]);
+ string cancelTicket(int ticketID, int userHandle, int ticketIDTable[], int ticketIDs[], int ticketUserIDs[], 
+                     int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                     int ticketHours[], int ticketSeats[], int eventAvailable[], double eventPrices[], 
+                     int availableEvents[], int availablePos[], int& availableCount, int eventCapacities[], 
+                     unsigned long long eventSeatMaps[], double eventRevenue[], int eventSeatsSold[], 
+                     int leaderboardRanks[], int leaderboardPos[], int rollupKeys[], double rollupRevenue[], 
+                     int rollupTickets[], int eventGenerations[], int eventFreeCount, int eventCount, 
+                     long long purchaseKeys[], int purchaseCounts[], int& eventIndex);
+ string joinWaitlist(int eventIndex, int userHandle, int quantity, int waitlistUserIDs[], 
+                     int waitlistQuantities[], int waitlistHeads[], int waitlistSizes[]);
+ int countWaitingRequests(int waitlistSizes[], int eventCount);
+ bool isWaitlistShortOfSeats(int eventIndex, int eventAvailable[], int waitlistQuantities[], int waitlistHeads[], 
+                             int waitlistSizes[]);
+ void removeWaitlistRequest(int eventIndex, int offset, int waitlistUserIDs[], int waitlistQuantities[], 
+                            int waitlistHeads[], int waitlistSizes[]);
+ string promoteWaitlist(int eventIndex, string eventNames[], double eventPrices[], int eventAvailable[], 
+                        int availableEvents[], int availablePos[], int& availableCount, int eventCapacities[], 
+                        unsigned long long eventSeatMaps[], int eventDates[], int eventTiers[], 
+                        int eventTierSeatLimits[], int eventTierDateLimits[], double eventRevenue[], 
+                        int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                        int eventGenerations[], int eventFreeCount, int eventCount, int ticketIDs[], 
+                        int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                        double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                        int ticketTiers[], int ticketDateIndex[], int ticketIDTable[], int rollupKeys[], 
+                        double rollupRevenue[], int rollupTickets[], int& ticketCount, 
+                        int lastArchivedTicketID, int waitlistUserIDs[], int waitlistQuantities[], 
+                        int waitlistHeads[], int waitlistSizes[], string usernames[], int userGenerations[], 
+                        int userCount, long long userRateTimes[], long long eventRateTimes[], 
+                        long long purchaseKeys[], int purchaseCounts[]);
+ 
+ // Function Prototypes - Seat Map Functions (row r of an event is the word eventSeatMaps[eventIndex * getMaxSeatRows() + r],
+ // bit c set = seat c taken; a seat number is row * getSeatsPerRow() + column, -1 = general admission)
+ int getSeatRowCount(int capacity);
+ unsigned long long getSeatRowMask(int row, int capacity);
+ int findSeatBlock(int eventIndex, int quantity, unsigned long long eventSeatMaps[], int eventCapacities[]);
+ int getLargestSeatBlock(int eventIndex, unsigned long long eventSeatMaps[], int eventCapacities[]);
+ void setSeats(int eventIndex, int firstSeat, int quantity, bool taken, unsigned long long eventSeatMaps[]);
+ void clearSeatMap(int eventIndex, unsigned long long eventSeatMaps[]);
+ string formatSeats(int firstSeat, int quantity);
+ void printSeatMap(int eventIndex, unsigned long long eventSeatMaps[], int eventCapacities[]);
+ 
+ // Function Prototypes - Price Tier Functions (tier 0 = early bird, 1 = standard, 2 = last seats; the tier is cached
+ // per event and only re-evaluated once eventAvailable drops to eventTierSeatLimits[] or today reaches eventTierDateLimits[])
+ string getPriceTierName(int tier);
+ double getPriceTierMultiplier(int tier);
+ int getLastSeatsLimit(int capacity);
+ double getTierPrice(int eventIndex, double eventPrices[], int eventTiers[]);
+ int getSeatsAtTierPrice(int eventIndex, int quantity, int eventAvailable[], int eventTiers[], 
+                         int eventTierSeatLimits[]);
+ double getOrderCost(int eventIndex, int quantity, double eventPrices[], int eventAvailable[], int eventTiers[], 
+                     int eventTierSeatLimits[]);
+ void updatePriceTier(int eventIndex, int today, int eventDates[], int eventCapacities[], int eventAvailable[], 
+                      int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[]);
+ void buildPriceTiers(int today, int eventDates[], int eventCapacities[], int eventAvailable[], 
+                      int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[], 
+                      int eventGenerations[], int eventCount);
+ 
+ // Function Prototypes - Request Key Functions (kiosk retries carry the same request key; slot i remembers a key
+ // hash, the ticket ID it booked and when, a key lives in one of getRequestKeyProbes() slots after its home slot)
+ unsigned long long hashRequestKey(string requestKey, int userHandle);
+ void clearRequestKeys(unsigned long long requestKeyHashes[], int requestKeyTicketIDs[], 
+                       long long requestKeyTimes[]);
+ int findRequestKey(unsigned long long keyHash, long long now, unsigned long long requestKeyHashes[], 
+                    int requestKeyTicketIDs[], long long requestKeyTimes[]);
+ void rememberRequestKey(unsigned long long keyHash, int ticketID, long long now, 
+                         unsigned long long requestKeyHashes[], int requestKeyTicketIDs[], 
+                         long long requestKeyTimes[]);
+ string repeatBooking(int ticketID, int eventIndex, int ticketIDTable[], string eventNames[], int ticketIDs[], 
+                      int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketSeats[], 
+                      int ticketTiers[], int eventGenerations[], int eventCount);
+ 
+ // Function Prototypes - Purchase Limit Functions (token buckets kept as one time per user slot and event slot, the
+ // time the bucket is next full; purchaseKeys[] holds user handle << 32 | event handle, -1 = empty, purchaseCounts[]
+ // the seats that user holds for that event)
+ void clearRateLimits(long long rateTimes[], int count);
+ bool takeRateToken(long long& rateTime, long long now, int interval, int burst);
+ long long makePurchaseKey(int userHandle, int eventHandle);
+ int findPurchaseSlot(long long key, long long purchaseKeys[]);
+ int getPurchaseCount(int userHandle, int eventHandle, long long purchaseKeys[], int purchaseCounts[]);
+ void addPurchaseCount(int userHandle, int eventHandle, int quantity, long long purchaseKeys[], 
+                       int purchaseCounts[]);
+ void buildPurchaseCounts(long long purchaseKeys[], int purchaseCounts[], int ticketUserIDs[], 
+                          int ticketEventIDs[], int ticketQuantities[], int ticketCount);
  
- // Main Function
- int main() {
+ // Function Prototypes - Check-In Functions (checkInBloom holds getBloomHashCount() bits per issued ticket ID, bit
+ // ID - first of checkInBitmap is set once that ticket is through the gate; checkInState holds tickets in the filter
+ // (-1 until built), the archived ID it was built at, then admitted, duplicate, unknown, void, wrong event and out
+ // of range scans, then first, the lowest live ticket ID; result 0 = admitted, 1 = already checked in, 2 = unknown,
+ // 3 = cancelled, 4 = wrong event, 5 = out of range)
+ unsigned long long hashTicketID(int ticketID);
+ void addToBloomFilter(int ticketID, unsigned long long checkInBloom[]);
+ bool mayContainTicketID(int ticketID, unsigned long long checkInBloom[]);
+ void syncCheckInTables(unsigned long long checkInBloom[], unsigned long long checkInBitmap[], int ticketIDs[], 
+                        int ticketCount, int lastArchivedTicketID, long long checkInState[]);
+ void loadCheckInLog(unsigned long long checkInBitmap[], int firstTicketID);
+ int checkInTicket(int ticketID, int gateEvent, unsigned long long checkInBloom[], unsigned long long checkInBitmap[], 
+                   int ticketIDTable[], int ticketIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                   int eventGenerations[], int eventCount, long long checkInState[]);
+ string getCheckInResultName(int result);
+ string checkInBatch(string scans, int gateEvent, unsigned long long checkInBloom[], 
+                     unsigned long long checkInBitmap[], int ticketIDTable[], int ticketIDs[], int ticketEventIDs[], 
+                     int ticketQuantities[], int eventGenerations[], int eventCount, long long checkInState[], 
+                     ofstream& checkInLog, long long metricBuckets[], long long metricStats[]);
+ 
+ // Function Prototypes - Bulk Update Functions (selected[i] is 1 for every live slot the predicate matches, 0 otherwise;
+ // action 0 = scale price by amount, 1 = add amount seats, 2 = delete)
+ int selectEvents(string category, string venue, int fromDate, int toDate, string eventCategories[], 
+                  string eventVenues[], int eventDates[], int eventGenerations[], int eventCount, int selected[]);
+ int removeSelected(int index[], int count, int selected[]);
+ string bulkUpdateEvents(int action, double amount, int selected[], string eventNames[], int eventDates[], 
+                         string eventVenues[], string eventCategories[], double eventPrices[], 
+                         int eventCapacities[], int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                         int availableEvents[], int availablePos[], int& availableCount, double eventRevenue[], 
+                         int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], int rollupKeys[], 
+                         double rollupRevenue[], int rollupTickets[], int eventTiers[], int eventTierSeatLimits[], 
+                         int eventTierDateLimits[], unsigned long long eventSeatMaps[], int waitlistHeads[], 
+                         int waitlistSizes[], int eventGenerations[], int eventFreeList[], int& eventFreeCount, 
+                         int eventCount);
+ 
+ // Function Prototypes - Persistence Functions (two snapshot buffers per table: the front end fills the pending
+ // one while the worker writes the other; persistState holds pending buffer, dirty tables (1 users, 2 events,
+ // 4 tickets, 8 seat counts only, 16 waitlists), writing, stop, writes done and bytes written)
+ void snapshotUsers(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                    int userCount, string snapshotUsernames[], string snapshotPasswords[], 
+                    string snapshotEmails[], int snapshotUserGenerations[], int snapshotCounts[], 
+                    long long persistState[], mutex& persistLock, condition_variable& persistSignal);
+ void snapshotEvents(int changedSlot, string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[], unsigned long long eventSeatMaps[], 
+                     int eventCount, string snapshotEventNames[], 
+                     int snapshotEventDates[], string snapshotEventVenues[], string snapshotEventCategories[], 
+                     double snapshotEventPrices[], int snapshotEventCapacities[], int snapshotEventAvailable[], 
+                     int snapshotEventGenerations[], unsigned long long snapshotEventSeatMaps[], 
+                     int snapshotCounts[], int snapshotEventsDirty[], long long persistState[], 
+                     mutex& persistLock, condition_variable& persistSignal);
+ void snapshotTickets(int changedFrom, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                      int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                      int ticketSeats[], int ticketTiers[], int ticketCount, int snapshotTicketIDs[], 
+                      int snapshotTicketUserIDs[], int snapshotTicketEventIDs[], 
+                      int snapshotTicketQuantities[], double snapshotTicketCosts[], int snapshotTicketDates[], 
+                      int snapshotTicketHours[], int snapshotTicketSeats[], int snapshotTicketTiers[], 
+                      int snapshotCounts[], int snapshotTicketsValid[], int snapshotTicketsDirty[], 
+                      long long persistState[], mutex& persistLock, condition_variable& persistSignal);
+ void runPersistenceWorker(string snapshotUsernames[], string snapshotPasswords[], string snapshotEmails[], 
+                           int snapshotUserGenerations[], string snapshotEventNames[], 
+                           int snapshotEventDates[], string snapshotEventVenues[], 
+                           string snapshotEventCategories[], double snapshotEventPrices[], 
+                           int snapshotEventCapacities[], int snapshotEventAvailable[], 
+                           int snapshotEventGenerations[], unsigned long long snapshotEventSeatMaps[], 
+                           int snapshotTicketIDs[], int snapshotTicketUserIDs[], int snapshotTicketEventIDs[], 
+                           int snapshotTicketQuantities[], double snapshotTicketCosts[], 
+                           int snapshotTicketDates[], int snapshotTicketHours[], int snapshotTicketSeats[], 
+                           int snapshotTicketTiers[], int snapshotCounts[], int snapshotEventsDirty[], 
+                           int snapshotTicketsDirty[], int snapshotSeatSlots[], int snapshotSeatCounts[], 
+                           int snapshotWaitlistEventIDs[], int snapshotWaitlistUserIDs[], 
+                           int snapshotWaitlistQuantities[], int snapshotWaitlistCounts[], 
+                           long long persistState[], mutex& persistLock, condition_variable& persistSignal, 
+                           long long metricBuckets[], long long metricStats[], long long traceSpans[], 
+                           long long& traceCount);
+ void snapshotSeatCount(int eventIndex, int available, unsigned long long eventSeatMaps[], 
+                        int snapshotEventAvailable[], unsigned long long snapshotEventSeatMaps[], 
+                        int snapshotSeatSlots[], int snapshotSeatCounts[], long long persistState[], 
+                        mutex& persistLock, condition_variable& persistSignal);
+ void snapshotWaitlist(int waitlistUserIDs[], int waitlistQuantities[], int waitlistHeads[], 
+                       int waitlistSizes[], int eventGenerations[], int eventCount, 
+                       int snapshotWaitlistEventIDs[], int snapshotWaitlistUserIDs[], 
+                       int snapshotWaitlistQuantities[], int snapshotWaitlistCounts[], 
+                       long long persistState[], mutex& persistLock, condition_variable& persistSignal);
+ string syncPersistence(long long persistState[], mutex& persistLock, condition_variable& persistSignal);
+ void stopPersistence(thread& persistenceWorker, long long persistState[], mutex& persistLock, 
+                      condition_variable& persistSignal);
+ 
+ // Function Prototypes - Archive Functions (archive_N.txt segments are written once and only read afterwards)
+ string getArchiveFileName(int number);
+ int getArchiveCount();
+ int splitArchiveLine(string line, string fields[], int maxFields);
+ int findLastArchivedTicketID();
+ int findLeftoverEvents(int number, string eventNames[], int eventDates[], string eventVenues[], 
+                        string eventCategories[], int eventGenerations[], int eventCount, bool pastEvents[], 
+                        bool leftoverEvents[]);
+ string archivePastEvents(int today, string eventNames[], int eventDates[], string eventVenues[], 
+                          string eventCategories[], double eventPrices[], int eventCapacities[], 
+                          int eventAvailable[], int eventGenerations[], int eventFreeList[], 
+                          int& eventFreeCount, int eventCount, int ticketIDs[], int ticketUserIDs[], 
+                          int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                          int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                          int& ticketCount, int& lastArchivedTicketID);
+ string viewArchivedReports();
+ 
+ // Function Prototypes - Replica Functions (journal.txt starts with S|millis on every primary start, followed by
+ // E|millis|slot|event row, T|millis|ticket row and U|millis|slot|username|email|generation upserts; replicaState
+ // holds stop, bytes read, entries applied, last lag ms, last apply millis, reloads, finished, tables loaded at
+ // millis and journal size, -1 for a pipe)
+ void startJournal(ofstream& journal);
+ void journalEvent(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                   string eventCategories[], double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                   int eventGenerations[], int eventCount, ofstream& journal);
+ void journalTickets(int first, int last, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                     int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                     int ticketSeats[], int ticketTiers[], ofstream& journal);
+ void journalUser(int slot, string usernames[], string emails[], int userGenerations[], ofstream& journal);
+ int runFollower(string journalPath);
+ void loadReplicaTables(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                        int userFreeList[], int& userFreeCount, int& userCount, string eventNames[], 
+                        int eventDates[], string eventVenues[], string eventCategories[], 
+                        double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                        int eventGenerations[], int eventFreeList[], int& eventFreeCount, int& eventCount, 
+                        int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                        double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                        int ticketTiers[], int ticketIDTable[], int& ticketCount, 
+                        long long ticketSegmentOffsets[], int ticketSegmentMinIDs[], 
+                        int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], int& ticketSegmentCount, 
+                        long long replicaState[]);
+ int applyJournalLine(string line, string usernames[], string emails[], int userGenerations[], int& userCount, 
+                      string eventNames[], int eventDates[], string eventVenues[], string eventCategories[], 
+                      double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                      int eventGenerations[], int& eventCount, int ticketIDs[], int ticketUserIDs[], 
+                      int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                      int ticketHours[], int ticketSeats[], int ticketTiers[], int ticketIDTable[], 
+                      int& ticketCount, long long replicaState[], long long metricBuckets[], 
+                      long long metricStats[]);
+ void tailJournal(string journalPath, string usernames[], string passwords[], string emails[], 
+                  int userGenerations[], int userFreeList[], int& userFreeCount, int& userCount, 
+                  string eventNames[], int eventDates[], string eventVenues[], string eventCategories[], 
+                  double eventPrices[], int eventCapacities[], int eventAvailable[], int eventGenerations[], 
+                  int eventFreeList[], int& eventFreeCount, int& eventCount, int ticketIDs[], 
+                  int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                  int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                  int ticketIDTable[], int& ticketCount, long long ticketSegmentOffsets[], 
+                  int ticketSegmentMinIDs[], int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], 
+                  int& ticketSegmentCount, long long replicaState[], long long metricBuckets[], 
+                  long long metricStats[], mutex& replicaLock);
+ void stopJournalTail(thread& journalTailer, string journalPath, long long replicaState[], mutex& replicaLock);
+ string viewReplicationStatus(string journalPath, long long replicaState[], long long metricBuckets[], 
+                              long long metricStats[]);
+ 
+ // Main Function (left out when another program such as Benchmark.cpp includes this file)
+ #ifndef EVENT_SYSTEM_NO_MAIN
+ int main(int argc, char* argv[]) {
+     // "--follow [journal]" runs a read-only replica fed by the primary's journal instead of the primary
+     if (argc > 1 && string(argv[1]) == "--follow") {
+         return runFollower(argc > 2 ? argv[2] : "journal.txt");
+     }
+     
      // Data Arrays - No Global Arrays (Modularity Requirement)
      string usernames[getMaxUsers()];
      string passwords[getMaxUsers()];
      string emails[getMaxUsers()];
+     int userGenerations[getMaxUsers()];
+     int userFreeList[getMaxUsers()];
+     int userFreeCount = 0;
      int userCount = 0;
      
      string eventNames[getMaxEvents()];
-     string eventDates[getMaxEvents()];
+     int eventDates[getMaxEvents()];
      string eventVenues[getMaxEvents()];
      string eventCategories[getMaxEvents()];
      double eventPrices[getMaxEvents()];
      int eventCapacities[getMaxEvents()];
      int eventAvailable[getMaxEvents()];
+     int eventDateIndex[getMaxEvents()];
+     int eventPriceIndex[getMaxEvents()];
+     int availableEvents[getMaxEvents()];
+     int availablePos[getMaxEvents()];
+     int availableCount = 0;
+     double eventRevenue[getMaxEvents()];
+     int eventSeatsSold[getMaxEvents()];
+     int leaderboardRanks[getLeaderboardMetricCount() * getMaxEvents()];
+     int leaderboardPos[getLeaderboardMetricCount() * getMaxEvents()];
+     int eventGenerations[getMaxEvents()];
+     int eventFreeList[getMaxEvents()];
+     int eventFreeCount = 0;
      int eventCount = 0;
+     unsigned long long eventSeatMaps[getMaxEvents() * getMaxSeatRows()];
+     int eventTiers[getMaxEvents()];
+     int eventTierSeatLimits[getMaxEvents()];
+     int eventTierDateLimits[getMaxEvents()];
      
      int ticketIDs[getMaxTickets()];
-     string ticketUsernames[getMaxTickets()];
-     string ticketEmails[getMaxTickets()];
+     int ticketUserIDs[getMaxTickets()];
      int ticketEventIDs[getMaxTickets()];
      int ticketQuantities[getMaxTickets()];
      double ticketCosts[getMaxTickets()];
-     string ticketDates[getMaxTickets()];
+     int ticketDates[getMaxTickets()];
+     int ticketHours[getMaxTickets()];
+     int ticketSeats[getMaxTickets()];
+     int ticketTiers[getMaxTickets()];
+     int ticketDateIndex[getMaxTickets()];
+     int ticketIDTable[getTicketIDTableSize()];
      int ticketCount = 0;
+     long long ticketSegmentOffsets[getMaxTicketSegments()];
+     int ticketSegmentMinIDs[getMaxTicketSegments()];
+     int ticketSegmentMaxIDs[getMaxTicketSegments()];
+     bool ticketSegmentLoaded[getMaxTicketSegments()];
+     int ticketSegmentCount = 0;
+     bool ticketsLoaded = false;
+     int lastArchivedTicketID = findLastArchivedTicketID();
+     
+     int waitlistUserIDs[getMaxEvents() * getWaitlistCapacity()];
+     int waitlistQuantities[getMaxEvents() * getWaitlistCapacity()];
+     int waitlistHeads[getMaxEvents()];
+     int waitlistSizes[getMaxEvents()];
      
-     // Load data from TXT files
-     loadUsersFromTXT(usernames, passwords, emails, userCount);
-     loadEventsFromTXT(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
-                      eventCapacities, eventAvailable, eventCount);
-     loadTicketsFromTXT(ticketIDs, ticketUsernames, ticketEmails, ticketEventIDs, 
-                       ticketQuantities, ticketCosts, ticketDates, ticketCount);
+     // Recent kiosk request keys, fixed size however many arrive
+     unsigned long long requestKeyHashes[getRequestKeyTableSize()];
+     int requestKeyTicketIDs[getRequestKeyTableSize()];
+     long long requestKeyTimes[getRequestKeyTableSize()];
+     clearRequestKeys(requestKeyHashes, requestKeyTicketIDs, requestKeyTimes);
+     
+     // Booking rate limits per user slot and event slot, and seats held per user and event
+     long long userRateTimes[getMaxUsers()];
+     long long eventRateTimes[getMaxEvents()];
+     clearRateLimits(userRateTimes, getMaxUsers());
+     clearRateLimits(eventRateTimes, getMaxEvents());
+     long long purchaseKeys[getPurchaseTableSize()];
+     int purchaseCounts[getPurchaseTableSize()];
+     
+     // Gate check-in, the bitmap is replayed from checkins.txt on first use so a ticket cannot get in twice
+     // across restarts
+     unsigned long long checkInBloom[getBloomFilterWords()];
+     unsigned long long checkInBitmap[getCheckInWords()];
+     long long checkInState[9] = {-1, 0, 0, 0, 0, 0, 0, 0, 0};
+     ofstream checkInLog;
+     
+     int rollupKeys[getRollupSize()];
+     double rollupRevenue[getRollupSize()];
+     int rollupTickets[getRollupSize()];
+     
+     long long metricBuckets[getMetricCount() * getMetricBucketCount()];
+     long long metricStats[getMetricCount() * getMetricStatCount()];
+     long long metricStart = 0;
+     clearMetrics(metricBuckets, metricStats);
+     long long traceSpans[getTraceRingCount() * getTraceCapacity() * 5];
+     long long traceCounts[getTraceRingCount()];
+     for (int ring = 0; ring < getTraceRingCount(); ring++) {
+         traceCounts[ring] = 0;
+     }
+     
+     string snapshotUsernames[2 * getMaxUsers()];
+     string snapshotPasswords[2 * getMaxUsers()];
+     string snapshotEmails[2 * getMaxUsers()];
+     int snapshotUserGenerations[2 * getMaxUsers()];
+     string snapshotEventNames[2 * getMaxEvents()];
+     int snapshotEventDates[2 * getMaxEvents()];
+     string snapshotEventVenues[2 * getMaxEvents()];
+     string snapshotEventCategories[2 * getMaxEvents()];
+     double snapshotEventPrices[2 * getMaxEvents()];
+     int snapshotEventCapacities[2 * getMaxEvents()];
+     int snapshotEventAvailable[2 * getMaxEvents()];
+     int snapshotEventGenerations[2 * getMaxEvents()];
+     unsigned long long snapshotEventSeatMaps[2 * getMaxEvents() * getMaxSeatRows()];
+     int snapshotTicketIDs[2 * getMaxTickets()];
+     int snapshotTicketUserIDs[2 * getMaxTickets()];
+     int snapshotTicketEventIDs[2 * getMaxTickets()];
+     int snapshotTicketQuantities[2 * getMaxTickets()];
+     double snapshotTicketCosts[2 * getMaxTickets()];
+     int snapshotTicketDates[2 * getMaxTickets()];
+     int snapshotTicketHours[2 * getMaxTickets()];
+     int snapshotTicketSeats[2 * getMaxTickets()];
+     int snapshotTicketTiers[2 * getMaxTickets()];
+     int snapshotCounts[2 * 3] = {0, 0, 0, 0, 0, 0};
+     int snapshotTicketsValid[2] = {0, 0};
+     int snapshotEventsDirty[2 * getMaxEventPartitions()];
+     int snapshotTicketsDirty[2] = {getMaxTickets(), getMaxTickets()};
+     int snapshotSeatSlots[2 * getMaxEvents()];
+     int snapshotSeatCounts[2] = {0, 0};
+     int snapshotWaitlistEventIDs[2 * getMaxEvents() * getWaitlistCapacity()];
+     int snapshotWaitlistUserIDs[2 * getMaxEvents() * getWaitlistCapacity()];
+     int snapshotWaitlistQuantities[2 * getMaxEvents() * getWaitlistCapacity()];
+     int snapshotWaitlistCounts[2] = {0, 0};
+     long long persistState[6] = {0, 0, 0, 0, 0, 0};
+     mutex persistLock;
+     condition_variable persistSignal;
+     for (int k = 0; k < 2 * getMaxEventPartitions(); k++) {
+         snapshotEventsDirty[k] = 0;
+     }
+     
+     // Load data from TXT files, events on their own thread while users and then tickets
+     // (older ticket rows look their username up) load on this one. The event loader times itself into
+     // its own trace ring and metric row, so nothing it records is shared with this thread
+     thread eventLoader([&]() {
+         long long eventLoadStart = getMicros();
+         loadEventsFromTXT(eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                           eventAvailable, eventGenerations, eventFreeList, eventFreeCount, eventCount);
+         finishTimedCall(2, eventLoadStart, 0, metricBuckets, metricStats, traceSpans + getTraceCapacity() * 5, 
+                         traceCounts[1]);
+     });
+     metricStart = getMicros();
+     loadUsersFromTXT(usernames, passwords, emails, userGenerations, userFreeList, userFreeCount, userCount);
+     finishTimedCall(1, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+     // With an up to date tickets.idx the tickets are paged in on first use instead of parsed here
+     metricStart = getMicros();
+     if (!loadTicketIndex(ticketSegmentOffsets, ticketSegmentMinIDs, ticketSegmentMaxIDs, 
+                          ticketSegmentLoaded, ticketSegmentCount, ticketCount)) {
+         loadTicketsFromTXT(ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                            ticketDates, ticketHours, ticketSeats, ticketTiers, ticketCount, usernames, 
+                            userGenerations, userCount);
+         ticketsLoaded = true;
+     }
+     finishTimedCall(3, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+     eventLoader.join();
+     loadWaitlistFromTXT(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, eventGenerations, eventCount);
+     loadSeatMaps(eventSeatMaps, eventGenerations, eventCount);
+     
+     // Compaction rewrites ticket handles, so leftover tombstones or old generations need every ticket in memory
+     if (eventFreeCount > 0 || userFreeCount > 0 || hasOldGeneration(eventGenerations, eventCount) || 
+         hasOldGeneration(userGenerations, userCount)) {
+         metricStart = getMicros();
+         ensureTicketsLoaded(ticketsLoaded, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                             ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                             ticketSegmentOffsets, ticketSegmentLoaded, ticketSegmentCount, ticketCount, 
+                             usernames, userGenerations, userCount);
+         finishTimedCall(3, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+     }
+     
+     // From here on every save goes through a snapshot that the persistence worker writes out
+     thread persistenceWorker(runPersistenceWorker, &snapshotUsernames[0], &snapshotPasswords[0], 
+                              &snapshotEmails[0], &snapshotUserGenerations[0], &snapshotEventNames[0], 
+                              &snapshotEventDates[0], &snapshotEventVenues[0], &snapshotEventCategories[0], 
+                              &snapshotEventPrices[0], &snapshotEventCapacities[0], 
+                              &snapshotEventAvailable[0], &snapshotEventGenerations[0], 
+                              &snapshotEventSeatMaps[0], &snapshotTicketIDs[0], &snapshotTicketUserIDs[0], 
+                              &snapshotTicketEventIDs[0], &snapshotTicketQuantities[0], 
+                              &snapshotTicketCosts[0], &snapshotTicketDates[0], &snapshotTicketHours[0], 
+                              &snapshotTicketSeats[0], &snapshotTicketTiers[0], &snapshotCounts[0], 
+                              &snapshotEventsDirty[0], &snapshotTicketsDirty[0], &snapshotSeatSlots[0], 
+                              &snapshotSeatCounts[0], &snapshotWaitlistEventIDs[0], 
+                              &snapshotWaitlistUserIDs[0], &snapshotWaitlistQuantities[0], 
+                              &snapshotWaitlistCounts[0], &persistState[0], ref(persistLock), 
+                              ref(persistSignal), &metricBuckets[0], &metricStats[0], 
+                              &traceSpans[2 * getTraceCapacity() * 5], ref(traceCounts[2]));
+     
+     // Squeeze out the tombstones left by the last session while nothing is indexed yet
+     bool eventsMoved = compactEvents(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                      eventCapacities, eventAvailable, eventGenerations, eventFreeCount, 
+                                      eventCount, ticketEventIDs, ticketCount, waitlistUserIDs, 
+                                      waitlistQuantities, waitlistHeads, waitlistSizes, eventSeatMaps);
+     bool usersMoved = compactUsers(usernames, passwords, emails, userGenerations, userFreeCount, 
+                                    userCount, ticketUserIDs, ticketCount, waitlistUserIDs);
+     if (eventsMoved || usersMoved) {
+         snapshotUsers(usernames, passwords, emails, userGenerations, userCount, snapshotUsernames, 
+                       snapshotPasswords, snapshotEmails, snapshotUserGenerations, snapshotCounts, 
+                       persistState, persistLock, persistSignal);
+         snapshotEvents(-1, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                        eventCapacities, eventAvailable, eventGenerations, eventSeatMaps, eventCount, 
+                        snapshotEventNames, snapshotEventDates, snapshotEventVenues, snapshotEventCategories, 
+                        snapshotEventPrices, snapshotEventCapacities, snapshotEventAvailable, 
+                        snapshotEventGenerations, snapshotEventSeatMaps, snapshotCounts, snapshotEventsDirty, 
+                        persistState, persistLock, persistSignal);
+         snapshotTickets(0, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                         ticketDates, ticketHours, ticketSeats, ticketTiers, ticketCount, snapshotTicketIDs, 
+                         snapshotTicketUserIDs, snapshotTicketEventIDs, snapshotTicketQuantities, 
+                         snapshotTicketCosts, snapshotTicketDates, snapshotTicketHours, snapshotTicketSeats, 
+                         snapshotTicketTiers, snapshotCounts, snapshotTicketsValid, snapshotTicketsDirty, 
+                         persistState, persistLock, persistSignal);
+         snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, eventGenerations, 
+                          eventCount, snapshotWaitlistEventIDs, snapshotWaitlistUserIDs, 
+                          snapshotWaitlistQuantities, snapshotWaitlistCounts, persistState, persistLock, 
+                          persistSignal);
+         // A follower reloads the files when the journal restarts, so they must already hold the new slots
+         syncPersistence(persistState, persistLock, persistSignal);
+     }
+     
+     // Every change from here on is also appended to journal.txt for followers to replay
+     ofstream journal;
+     startJournal(journal);
+     
+     buildDateIndex(eventDateIndex, eventDates, eventCount);
+     buildPriceIndex(eventPriceIndex, eventPrices, eventCount);
+     buildAvailableSet(eventAvailable, eventPrices, eventCount, availableEvents, availablePos, availableCount);
+     buildPriceTiers(getCurrentDate(), eventDates, eventCapacities, eventAvailable, eventTiers, 
+                     eventTierSeatLimits, eventTierDateLimits, eventGenerations, eventCount);
+     // Until the tickets are paged in the ticket views start out empty and get rebuilt on first use
+     int loadedTicketCount = ticketsLoaded ? ticketCount : 0;
+     buildDateIndex(ticketDateIndex, ticketDates, loadedTicketCount);
+     buildTicketIDTable(ticketIDTable, ticketIDs, loadedTicketCount);
+     buildPurchaseCounts(purchaseKeys, purchaseCounts, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                         loadedTicketCount);
+     buildLeaderboards(ticketEventIDs, ticketQuantities, ticketCosts, loadedTicketCount, eventCapacities, 
+                       eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                       leaderboardPos, eventGenerations, eventCount);
+     buildRollups(ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, loadedTicketCount, 
+                  rollupKeys, rollupRevenue, rollupTickets, eventGenerations, eventCount);
      
      clearScreen();
      displayHeader();
@@ -189,8 +988,37 @@
                      displayAdminMenu();
                      string adminChoice = getUserChoice();
                      
+                     // Registrations, reports, daily sales, leaderboards, rollups, archiving and check-in need
+                     // every ticket, and so does an update while anyone is waitlisted, since freed seats are
+                     // booked straight away
+                     if (!ticketsLoaded && (adminChoice == "5" || adminChoice == "6" || adminChoice == "9" || 
+                                            adminChoice == "10" || adminChoice == "11" || adminChoice == "13" || 
+                                            adminChoice == "16" || 
+                                            ((adminChoice == "3" || adminChoice == "17") && 
+                                             countWaitingRequests(waitlistSizes, eventCount) > 0))) {
+                         metricStart = getMicros();
+                         ensureTicketsLoaded(ticketsLoaded, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                             ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                             ticketSeats, ticketTiers, ticketSegmentOffsets, 
+                                             ticketSegmentLoaded, ticketSegmentCount, ticketCount, usernames, 
+                                             userGenerations, userCount);
+                         finishTimedCall(3, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+                         buildDateIndex(ticketDateIndex, ticketDates, ticketCount);
+                         buildTicketIDTable(ticketIDTable, ticketIDs, ticketCount);
+                         buildPurchaseCounts(purchaseKeys, purchaseCounts, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                             ticketCount);
+                         buildLeaderboards(ticketEventIDs, ticketQuantities, ticketCosts, ticketCount, eventCapacities, 
+                                           eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                           leaderboardPos, eventGenerations, eventCount);
+                         buildRollups(ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketCount, 
+                                      rollupKeys, rollupRevenue, rollupTickets, eventGenerations, eventCount);
+                     }
+                     
                      if (adminChoice == "1" || adminChoice == "2" || adminChoice == "3" || adminChoice == "4" || 
-                         adminChoice == "5" || adminChoice == "6" || adminChoice == "7" || adminChoice == "8" || adminChoice == "9") {
+                         adminChoice == "5" || adminChoice == "6" || adminChoice == "7" || adminChoice == "8" || adminChoice == "9" || 
+                         adminChoice == "10" || adminChoice == "11" || adminChoice == "12" || adminChoice == "13" || 
+                         adminChoice == "14" || adminChoice == "15" || adminChoice == "16" || adminChoice == "17" || 
+                         adminChoice == "18") {
                          if (adminChoice == "1") {
                          // Add Event
                          clearScreen();
@@ -208,8 +1036,8 @@
                          }
                          cout << bright_yellow << "Enter Event Date (DD-MM-YYYY): " << reset;
                          getline(cin, date);
-                         while ((int)date.length() == 0) {
-                             cout << bright_red << "Date cannot be empty! Enter again: " << reset;
+                         while (parseDate(date) == -1) {
+                             cout << bright_red << "Invalid date! Use DD-MM-YYYY. Enter again: " << reset;
                              getline(cin, date);
                          }
                          cout << bright_yellow << "Enter Event Venue: " << reset;
@@ -235,13 +1063,28 @@
                              capacity = getValidInteger("Enter Event Capacity: ");
                          }
                          
-                         string result = addEvent(name, date, venue, category, price, capacity, 
+                         int slot = eventFreeCount > 0 ? eventFreeList[eventFreeCount - 1] : eventCount;
+                         string result = addEvent(name, parseDate(date), venue, category, price, capacity, 
                                                  eventNames, eventDates, eventVenues, 
                                                  eventCategories, eventPrices, eventCapacities, 
-                                                 eventAvailable, eventCount);
+                                                 eventAvailable, eventDateIndex, eventPriceIndex, 
+                                                 availableEvents, availablePos, availableCount, 
+                                                 eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                                 leaderboardPos, eventGenerations, eventFreeList, 
+                                                 eventFreeCount, eventCount);
                          cout << "\n" << bright_green << result << reset << endl;
-                         saveEventsToTXT(eventNames, eventDates, eventVenues, eventCategories, 
-                                        eventPrices, eventCapacities, eventAvailable, eventCount);
+                         buildPriceTiers(getCurrentDate(), eventDates, eventCapacities, eventAvailable, 
+                                         eventTiers, eventTierSeatLimits, eventTierDateLimits, 
+                                         eventGenerations, eventCount);
+                         snapshotEvents(slot, eventNames, eventDates, eventVenues, eventCategories, 
+                                        eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                        eventSeatMaps, eventCount, snapshotEventNames, snapshotEventDates, 
+                                        snapshotEventVenues, snapshotEventCategories, snapshotEventPrices, 
+                                        snapshotEventCapacities, snapshotEventAvailable, 
+                                        snapshotEventGenerations, snapshotEventSeatMaps, snapshotCounts, 
+                                        snapshotEventsDirty, persistState, persistLock, persistSignal);
+                         journalEvent(slot, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                      eventCapacities, eventAvailable, eventGenerations, eventCount, journal);
                          pauseScreen();
                          
                          } else if (adminChoice == "2") {
@@ -249,55 +1092,28 @@
                          clearScreen();
                          string events = viewAllEvents(eventNames, eventDates, eventVenues, 
                                                       eventCategories, eventPrices, 
-                                                      eventCapacities, eventAvailable, eventCount);
+                                                      eventCapacities, eventAvailable, 
+                                                      eventGenerations, eventCount);
                          // Print with colors
-                         cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
-                         if (eventCount == 0) {
-                             cout << bright_red << "No events available!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < eventCount; i++) {
-                                 cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
-                                 cout << cyan << "Date: " << reset << eventDates[i] << endl;
-                                 cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
-                                 cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
-                                 cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
-                                 cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
-                                 cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                        eventCapacities, eventAvailable, eventGenerations, eventCount);
                          pauseScreen();
                          
                          } else if (adminChoice == "3") {
                          // Update Event
                          clearScreen();
                          // Print with colors
-                         cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
-                         if (eventCount == 0) {
-                             cout << bright_red << "No events available!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < eventCount; i++) {
-                                 cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
-                                 cout << cyan << "Date: " << reset << eventDates[i] << endl;
-                                 cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
-                                 cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
-                                 cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
-                                 cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
-                                 cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                        eventCapacities, eventAvailable, eventGenerations, eventCount);
                          
-                         if (eventCount > 0) {
+                         if (eventCount - eventFreeCount > 0) {
                              int index = getValidInteger("\nEnter Event Number to Update (0 to cancel): ");
-                             while (index < 0 || index > eventCount) {
-                                 cout << bright_red << "Invalid event number! Enter between 0 and " << eventCount << ": " << reset;
+                             while (index < 0 || (index > 0 && !isSlotLive(index - 1, eventGenerations, eventCount))) {
+                                 cout << bright_red << "Invalid event number! Enter one of the listed events or 0: " << reset;
                                  index = getValidInteger("Enter Event Number: ");
                              }
                              
-                             if (index > 0 && index <= eventCount) {
+                             if (index > 0) {
                                  string name, date, venue, category;
                                  double price;
                                  int capacity, available;
@@ -311,8 +1127,8 @@
                                  }
                                  cout << bright_yellow << "Enter New Event Date (DD-MM-YYYY): " << reset;
                                  getline(cin, date);
-                                 while ((int)date.length() == 0) {
-                                     cout << bright_red << "Date cannot be empty! Enter again: " << reset;
+                                 while (parseDate(date) == -1) {
+                                     cout << bright_red << "Invalid date! Use DD-MM-YYYY. Enter again: " << reset;
                                      getline(cin, date);
                                  }
                                  cout << bright_yellow << "Enter New Event Venue: " << reset;
@@ -343,13 +1159,76 @@
                                      available = getValidInteger("Enter Available Seats: ");
                                  }
                                  
-                                 string result = updateEvent(index - 1, name, date, venue, category, 
+                                 string result = updateEvent(index - 1, name, parseDate(date), venue, category, 
                                                              price, capacity, available, eventNames, 
                                                              eventDates, eventVenues, eventCategories, 
-                                                             eventPrices, eventCapacities, eventAvailable);
+                                                             eventPrices, eventCapacities, eventAvailable, 
+                                                             eventDateIndex, eventPriceIndex, availableEvents, 
+                                                             availablePos, availableCount, eventRevenue, 
+                                                             eventSeatsSold, leaderboardRanks, leaderboardPos, 
+                                                             eventGenerations, eventFreeCount, eventCount);
                                  cout << "\n" << bright_green << result << reset << endl;
-                                 saveEventsToTXT(eventNames, eventDates, eventVenues, eventCategories, 
-                                                eventPrices, eventCapacities, eventAvailable, eventCount);
+                                 
+                                 // A new date, price or seat count can move the event to another price tier
+                                 updatePriceTier(index - 1, getCurrentDate(), eventDates, eventCapacities, 
+                                                 eventAvailable, eventTiers, eventTierSeatLimits, 
+                                                 eventTierDateLimits);
+                                 
+                                 // More seats may let the front of the waitlist in
+                                 int ticketsBefore = ticketCount;
+                                 int waitingBefore = waitlistSizes[index - 1];
+                                 string promoted = promoteWaitlist(index - 1, eventNames, eventPrices, eventAvailable, 
+                                                                   availableEvents, availablePos, availableCount, 
+                                                                   eventCapacities, eventSeatMaps, 
+                                                                   eventDates, eventTiers, 
+                                                                   eventTierSeatLimits, eventTierDateLimits, 
+                                                                   eventRevenue, eventSeatsSold, 
+                                                                   leaderboardRanks, leaderboardPos, eventGenerations, 
+                                                                   eventFreeCount, eventCount, ticketIDs, ticketUserIDs, 
+                                                                   ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                                   ticketDates, ticketHours, ticketSeats, 
+                                                                   ticketTiers, 
+                                                                   ticketDateIndex, ticketIDTable, 
+                                                                   rollupKeys, rollupRevenue, rollupTickets, ticketCount, 
+                                                                   lastArchivedTicketID, waitlistUserIDs, waitlistQuantities, 
+                                                                   waitlistHeads, waitlistSizes, usernames, 
+                                                                   userGenerations, userCount, userRateTimes, 
+                                                                   eventRateTimes, purchaseKeys, 
+                                                                   purchaseCounts);
+                                 if (promoted != "") {
+                                     cout << bright_cyan << promoted << reset << endl;
+                                 }
+                                 if (waitlistSizes[index - 1] != waitingBefore) {
+                                     snapshotTickets(ticketsBefore, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                     ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                                     ticketSeats, ticketTiers, ticketCount, snapshotTicketIDs, 
+                                                     snapshotTicketUserIDs, snapshotTicketEventIDs, 
+                                                     snapshotTicketQuantities, snapshotTicketCosts, 
+                                                     snapshotTicketDates, snapshotTicketHours, 
+                                                     snapshotTicketSeats, snapshotTicketTiers, snapshotCounts, 
+                                                     snapshotTicketsValid, snapshotTicketsDirty, persistState, 
+                                                     persistLock, persistSignal);
+                                     journalTickets(ticketsBefore, ticketCount, ticketIDs, ticketUserIDs, 
+                                                    ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                    ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                                                    journal);
+                                     snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                                      eventGenerations, eventCount, snapshotWaitlistEventIDs, 
+                                                      snapshotWaitlistUserIDs, snapshotWaitlistQuantities, 
+                                                      snapshotWaitlistCounts, persistState, persistLock, persistSignal);
+                                 }
+                                 snapshotEvents(index - 1, eventNames, eventDates, eventVenues, 
+                                                eventCategories, eventPrices, eventCapacities, eventAvailable, 
+                                                eventGenerations, eventSeatMaps, eventCount, 
+                                                snapshotEventNames, snapshotEventDates, snapshotEventVenues, 
+                                                snapshotEventCategories, snapshotEventPrices, 
+                                                snapshotEventCapacities, snapshotEventAvailable, 
+                                                snapshotEventGenerations, snapshotEventSeatMaps, 
+                                                snapshotCounts, snapshotEventsDirty, persistState, 
+                                                persistLock, persistSignal);
+                                 journalEvent(index - 1, eventNames, eventDates, eventVenues, eventCategories, 
+                                              eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                              eventCount, journal);
                              }
                          }
                          pauseScreen();
@@ -358,37 +1237,48 @@
                          // Delete Event
                          clearScreen();
                          // Print with colors
-                         cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
-                         if (eventCount == 0) {
-                             cout << bright_red << "No events available!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < eventCount; i++) {
-                                 cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
-                                 cout << cyan << "Date: " << reset << eventDates[i] << endl;
-                                 cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
-                                 cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
-                                 cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
-                                 cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
-                                 cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                        eventCapacities, eventAvailable, eventGenerations, eventCount);
                          
-                         if (eventCount > 0) {
+                         if (eventCount - eventFreeCount > 0) {
                              int index = getValidInteger("\nEnter Event Number to Delete (0 to cancel): ");
-                             while (index < 0 || index > eventCount) {
-                                 cout << bright_red << "Invalid event number! Enter between 0 and " << eventCount << ": " << reset;
+                             while (index < 0 || (index > 0 && !isSlotLive(index - 1, eventGenerations, eventCount))) {
+                                 cout << bright_red << "Invalid event number! Enter one of the listed events or 0: " << reset;
                                  index = getValidInteger("Enter Event Number: ");
                              }
                              
-                             if (index > 0 && index <= eventCount) {
+                             if (index > 0) {
                                  string result = deleteEvent(index - 1, eventNames, eventDates, 
                                                             eventVenues, eventCategories, eventPrices, 
-                                                            eventCapacities, eventAvailable, eventCount);
+                                                            eventCapacities, eventAvailable, eventDateIndex, 
+                                                            eventPriceIndex, availableEvents, availablePos, 
+                                                            availableCount, eventRevenue, eventSeatsSold, 
+                                                            leaderboardRanks, leaderboardPos, rollupKeys, 
+                                                            rollupRevenue, rollupTickets, eventGenerations, 
+                                                            eventFreeList, eventFreeCount, eventCount);
                                  cout << "\n" << bright_red << result << reset << endl;
-                                 saveEventsToTXT(eventNames, eventDates, eventVenues, eventCategories, 
-                                                eventPrices, eventCapacities, eventAvailable, eventCount);
+                                 // The queue and seat map go with the event, a new event in this slot starts with empty ones
+                                 clearSeatMap(index - 1, eventSeatMaps);
+                                 if (waitlistSizes[index - 1] > 0) {
+                                     waitlistHeads[index - 1] = 0;
+                                     waitlistSizes[index - 1] = 0;
+                                     snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                                      eventGenerations, eventCount, snapshotWaitlistEventIDs, 
+                                                      snapshotWaitlistUserIDs, snapshotWaitlistQuantities, 
+                                                      snapshotWaitlistCounts, persistState, persistLock, persistSignal);
+                                 }
+                                 snapshotEvents(index - 1, eventNames, eventDates, eventVenues, 
+                                                eventCategories, eventPrices, eventCapacities, eventAvailable, 
+                                                eventGenerations, eventSeatMaps, eventCount, 
+                                                snapshotEventNames, snapshotEventDates, snapshotEventVenues, 
+                                                snapshotEventCategories, snapshotEventPrices, 
+                                                snapshotEventCapacities, snapshotEventAvailable, 
+                                                snapshotEventGenerations, snapshotEventSeatMaps, 
+                                                snapshotCounts, snapshotEventsDirty, persistState, 
+                                                persistLock, persistSignal);
+                                 journalEvent(index - 1, eventNames, eventDates, eventVenues, eventCategories, 
+                                              eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                              eventCount, journal);
                              }
                          }
                          pauseScreen();
@@ -396,11 +1286,12 @@
                          } else if (adminChoice == "5") {
                          // View All Registrations
                          clearScreen();
-                         string registrations = viewAllRegistrations(ticketIDs, ticketUsernames, 
-                                                                     ticketEmails, ticketEventIDs, 
-                                                                     ticketQuantities, ticketCosts, 
-                                                                     ticketDates, eventNames, 
-                                                                     ticketCount, eventCount);
+                         string registrations = viewAllRegistrations(ticketIDs, ticketUserIDs, 
+                                                                     ticketEventIDs, ticketQuantities, 
+                                                                     ticketCosts, ticketDates, eventNames, 
+                                                                     usernames, emails, ticketCount, 
+                                                                     eventGenerations, eventCount, 
+                                                                     userGenerations, userCount);
                          if (registrations != "") {
                              cout << bright_red << registrations << reset << endl;
                          }
@@ -409,57 +1300,407 @@
                          } else if (adminChoice == "6") {
                          // Generate Reports
                          clearScreen();
-                         generateReports(ticketIDs, ticketUsernames, ticketEventIDs, ticketQuantities, 
-                                       ticketCosts, eventNames, eventPrices, ticketCount, eventCount);
+                         metricStart = getMicros();
+                         generateReports(ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                       ticketCosts, eventNames, eventPrices, ticketCount, 
+                                       eventGenerations, eventCount);
+                         finishTimedCall(11, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
                          pauseScreen();
                          
                          } else if (adminChoice == "7") {
                          // View All Users
                          clearScreen();
-                         cout << bright_cyan << bold << "\n========== ALL USERS ==========\n" << reset;
-                         if (userCount == 0) {
-                             cout << bright_red << "No users registered!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < userCount; i++) {
-                                 cout << "\n" << bright_yellow << "User #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Username: " << reset << bright_white << usernames[i] << reset << endl;
-                                 cout << cyan << "Email: " << reset << emails[i] << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printUserList(usernames, emails, userGenerations, userCount);
                          pauseScreen();
                          
                          } else if (adminChoice == "8") {
                          // Delete User
                          clearScreen();
-                         cout << bright_cyan << bold << "\n========== ALL USERS ==========\n" << reset;
-                         if (userCount == 0) {
-                             cout << bright_red << "No users registered!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < userCount; i++) {
-                                 cout << "\n" << bright_yellow << "User #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Username: " << reset << bright_white << usernames[i] << reset << endl;
-                                 cout << cyan << "Email: " << reset << emails[i] << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printUserList(usernames, emails, userGenerations, userCount);
                          
-                         if (userCount > 0) {
+                         if (userCount - userFreeCount > 0) {
                              int index = getValidInteger("\nEnter User Number to Delete (0 to cancel): ");
-                             while (index < 0 || index > userCount) {
-                                 cout << bright_red << "Invalid user number! Enter between 0 and " << userCount << ": " << reset;
+                             while (index < 0 || (index > 0 && !isSlotLive(index - 1, userGenerations, userCount))) {
+                                 cout << bright_red << "Invalid user number! Enter one of the listed users or 0: " << reset;
                                  index = getValidInteger("Enter User Number: ");
                              }
                              
-                             if (index > 0 && index <= userCount) {
-                                 string result = deleteUser(index - 1, usernames, passwords, emails, userCount);
+                             if (index > 0) {
+                                 string result = deleteUser(index - 1, usernames, passwords, emails, userGenerations, 
+                                                            userFreeList, userFreeCount, userCount);
                                  cout << "\n" << result << endl;
-                                 saveUsersToTXT(usernames, passwords, emails, userCount);
+                                 snapshotUsers(usernames, passwords, emails, userGenerations, userCount, snapshotUsernames, 
+                                               snapshotPasswords, snapshotEmails, snapshotUserGenerations, snapshotCounts, 
+                                               persistState, persistLock, persistSignal);
+                                 journalUser(index - 1, usernames, emails, userGenerations, journal);
                              }
                          }
                          pauseScreen();
                          
                          } else if (adminChoice == "9") {
+                         // Tickets Sold on Date
+                         clearScreen();
+                         cout << "\n" << bright_cyan << bold << "========== TICKETS SOLD ON DATE ==========\n" << reset;
+                         cin.ignore();
+                         string date;
+                         cout << bright_yellow << "Enter Date (DD-MM-YYYY): " << reset;
+                         getline(cin, date);
+                         while (parseDate(date) == -1) {
+                             cout << bright_red << "Invalid date! Use DD-MM-YYYY. Enter again: " << reset;
+                             getline(cin, date);
+                         }
+                         
+                         string result = viewTicketsSoldOnDate(parseDate(date), ticketIDs, ticketUserIDs, 
+                                                               ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                               ticketDates, ticketDateIndex, eventNames, 
+                                                               usernames, ticketCount, eventGenerations, 
+                                                               eventCount, userGenerations, userCount);
+                         if ((int)result.find("No tickets sold") != -1) {
+                             cout << bright_red << result << reset << endl;
+                         } else {
+                             cout << result << endl;
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "10") {
+                         // Best-Seller Leaderboard
+                         clearScreen();
+                         cout << "\n" << bright_magenta << bold << "========== BEST-SELLER LEADERBOARD ==========\n" << reset;
+                         for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+                             string board = viewLeaderboard(metric, eventNames, eventCapacities, eventAvailable, 
+                                                            eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                                            eventCount - eventFreeCount);
+                             if ((int)board.find("No events available") != -1) {
+                                 cout << bright_red << board << reset << endl;
+                                 break;
+                             }
+                             cout << board;
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "11") {
+                         // Sales Rollups
+                         clearScreen();
+                         cout << "\n" << bright_magenta << bold << "========== SALES ROLLUPS ==========\n" << reset;
+                         int index = 0;
+                         if (eventCount - eventFreeCount > 0) {
+                             for (int i = 0; i < eventCount; i++) {
+                                 if (isSlotLive(i, eventGenerations, eventCount)) {
+                                     cout << bright_yellow << (i + 1) << ". " << reset << eventNames[i] << endl;
+                                 }
+                             }
+                             index = getValidInteger("\nEnter Event Number (0 for all events): ");
+                             while (index < 0 || (index > 0 && !isSlotLive(index - 1, eventGenerations, eventCount))) {
+                                 cout << bright_red << "Invalid event number! Enter one of the listed events or 0: " << reset;
+                                 index = getValidInteger("Enter Event Number: ");
+                             }
+                         }
+                         cout << viewSalesRollups(index - 1, eventNames, rollupKeys, rollupRevenue, rollupTickets) << endl;
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "12") {
+                         // Performance Metrics
+                         clearScreen();
+                         // The persistence worker records the save metrics under persistLock
+                         unique_lock<mutex> metricsLock(persistLock);
+                         string metrics = viewMetrics(metricBuckets, metricStats);
+                         metricsLock.unlock();
+                         if ((int)metrics.find("PERFORMANCE METRICS") == -1) {
+                             cout << bright_red << metrics << reset << endl;
+                         } else {
+                             cout << metrics << endl;
+                             string dump;
+                             cout << bright_yellow << "Dump metrics to metrics.txt? (y/n): " << reset;
+                             cin >> dump;
+                             if (dump == "y" || dump == "Y") {
+                                 metricsLock.lock();
+                                 string written = dumpMetricsToFile("metrics.txt", metricBuckets, metricStats);
+                                 metricsLock.unlock();
+                                 cout << bright_green << written << reset << endl;
+                             }
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "13") {
+                         // Archive Past Events
+                         clearScreen();
+                         string result = archivePastEvents(getCurrentDate(), eventNames, eventDates, 
+                                                           eventVenues, eventCategories, eventPrices, 
+                                                           eventCapacities, eventAvailable, eventGenerations, 
+                                                           eventFreeList, eventFreeCount, eventCount, 
+                                                           ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                           ticketQuantities, ticketCosts, ticketDates, 
+                                                           ticketHours, ticketSeats, ticketTiers, ticketCount, 
+                                                           lastArchivedTicketID);
+                         if ((int)result.find("Archived") == 0) {
+                             cout << "\n" << bright_green << result << reset << endl;
+                             
+                             // The archived slots are squeezed out right away and every event view rebuilt
+                             compactEvents(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                           eventCapacities, eventAvailable, eventGenerations, eventFreeCount, 
+                                           eventCount, ticketEventIDs, ticketCount, waitlistUserIDs, 
+                                           waitlistQuantities, waitlistHeads, waitlistSizes, eventSeatMaps);
+                             clearRateLimits(eventRateTimes, getMaxEvents());
+                             buildDateIndex(eventDateIndex, eventDates, eventCount);
+                             buildPriceIndex(eventPriceIndex, eventPrices, eventCount);
+                             buildAvailableSet(eventAvailable, eventPrices, eventCount, availableEvents, availablePos, 
+                                               availableCount);
+                             buildPriceTiers(getCurrentDate(), eventDates, eventCapacities, eventAvailable, 
+                                             eventTiers, eventTierSeatLimits, eventTierDateLimits, 
+                                             eventGenerations, eventCount);
+                             buildDateIndex(ticketDateIndex, ticketDates, ticketCount);
+                             buildTicketIDTable(ticketIDTable, ticketIDs, ticketCount);
+                             buildPurchaseCounts(purchaseKeys, purchaseCounts, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                                 ticketCount);
+                             buildLeaderboards(ticketEventIDs, ticketQuantities, ticketCosts, ticketCount, eventCapacities, 
+                                               eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                               leaderboardPos, eventGenerations, eventCount);
+                             buildRollups(ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketCount, 
+                                          rollupKeys, rollupRevenue, rollupTickets, eventGenerations, eventCount);
+                             
+                             snapshotEvents(-1, eventNames, eventDates, eventVenues, eventCategories, 
+                                            eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                            eventSeatMaps, eventCount, snapshotEventNames, snapshotEventDates, 
+                                            snapshotEventVenues, snapshotEventCategories, snapshotEventPrices, 
+                                            snapshotEventCapacities, snapshotEventAvailable, 
+                                            snapshotEventGenerations, snapshotEventSeatMaps, snapshotCounts, 
+                                            snapshotEventsDirty, persistState, persistLock, persistSignal);
+                             snapshotTickets(0, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                             ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                                             ticketCount, snapshotTicketIDs, snapshotTicketUserIDs, 
+                                             snapshotTicketEventIDs, snapshotTicketQuantities, 
+                                             snapshotTicketCosts, snapshotTicketDates, snapshotTicketHours, 
+                                             snapshotTicketSeats, snapshotTicketTiers, snapshotCounts, 
+                                             snapshotTicketsValid, snapshotTicketsDirty, persistState, 
+                                             persistLock, persistSignal);
+                             snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                              eventGenerations, eventCount, snapshotWaitlistEventIDs, 
+                                              snapshotWaitlistUserIDs, snapshotWaitlistQuantities, 
+                                              snapshotWaitlistCounts, persistState, persistLock, persistSignal);
+                             
+                             // Every slot moved, so followers start over from the rewritten files
+                             syncPersistence(persistState, persistLock, persistSignal);
+                             startJournal(journal);
+                         } else {
+                             cout << "\n" << bright_red << result << reset << endl;
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "14") {
+                         // Archived Event Reports
+                         clearScreen();
+                         string result = viewArchivedReports();
+                         if (result != "") {
+                             cout << bright_red << result << reset << endl;
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "15") {
+                         // Sync Data to Disk
+                         clearScreen();
+                         cout << "\n" << bright_green << syncPersistence(persistState, persistLock, persistSignal) << reset << endl;
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "16") {
+                         // Gate Check-In
+                         clearScreen();
+                         cout << "\n" << bright_magenta << bold << "========== GATE CHECK-IN ==========\n" << reset;
+                         int gate = 0;
+                         if (eventCount - eventFreeCount > 0) {
+                             for (int i = 0; i < eventCount; i++) {
+                                 if (isSlotLive(i, eventGenerations, eventCount)) {
+                                     cout << bright_yellow << (i + 1) << ". " << reset << eventNames[i] << endl;
+                                 }
+                             }
+                             gate = getValidInteger("\nEnter Event at this Gate (0 for any event): ");
+                             while (gate < 0 || (gate > 0 && !isSlotLive(gate - 1, eventGenerations, eventCount))) {
+                                 cout << bright_red << "Invalid event number! Enter one of the listed events or 0: " << reset;
+                                 gate = getValidInteger("Enter Event Number: ");
+                             }
+                             clearInputBuffer();
+                         }
+                         
+                         // Tickets booked since the last visit are added to the filter, nothing else is rescanned
+                         syncCheckInTables(checkInBloom, checkInBitmap, ticketIDs, ticketCount, lastArchivedTicketID, 
+                                           checkInState);
+                         cout << cyan << "Scan or paste ticket IDs, any number per line. Empty line to finish.\n" << reset;
+                         string batch;
+                         while (getline(cin, batch) && batch != "") {
+                             string result = checkInBatch(batch, gate - 1, checkInBloom, checkInBitmap, ticketIDTable, 
+                                                          ticketIDs, ticketEventIDs, ticketQuantities, 
+                                                          eventGenerations, eventCount, checkInState, checkInLog, 
+                                                          metricBuckets, metricStats);
+                             if ((int)result.find("rejected") == -1) {
+                                 cout << bright_green << result << reset;
+                             } else {
+                                 cout << bright_red << result << reset;
+                             }
+                         }
+                         long long rejectedScans = 0;
+                         for (int result = 1; result < 6; result++) {
+                             rejectedScans += checkInState[2 + result];
+                         }
+                         cout << bright_cyan << "This session: " << checkInState[2] << " admitted, " << rejectedScans 
+                              << " rejected" << reset << endl;
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "17") {
+                         // Bulk Update Events
+                         clearScreen();
+                         cout << "\n" << bright_magenta << bold << "========== BULK UPDATE EVENTS ==========\n" << reset;
+                         string category, venue, fromText, toText;
+                         cout << bright_yellow << "Category (blank for any): " << reset;
+                         getline(cin, category);
+                         cout << bright_yellow << "Venue (blank for any): " << reset;
+                         getline(cin, venue);
+                         cout << bright_yellow << "From Date DD-MM-YYYY (blank for any): " << reset;
+                         getline(cin, fromText);
+                         while (fromText != "" && parseDate(fromText) == -1) {
+                             cout << bright_red << "Invalid date! Use DD-MM-YYYY or leave blank. Enter again: " << reset;
+                             getline(cin, fromText);
+                         }
+                         cout << bright_yellow << "To Date DD-MM-YYYY (blank for any): " << reset;
+                         getline(cin, toText);
+                         while (toText != "" && parseDate(toText) == -1) {
+                             cout << bright_red << "Invalid date! Use DD-MM-YYYY or leave blank. Enter again: " << reset;
+                             getline(cin, toText);
+                         }
+                         
+                         int selected[getMaxEvents()];
+                         int matches = selectEvents(category, venue, fromText == "" ? 0 : parseDate(fromText), 
+                                                    toText == "" ? numeric_limits<int>::max() : parseDate(toText), 
+                                                    eventCategories, eventVenues, eventDates, eventGenerations, 
+                                                    eventCount, selected);
+                         if (matches == 0) {
+                             cout << "\n" << bright_red << "No events match!" << reset << endl;
+                         } else {
+                             cout << "\n" << bright_cyan << matches << " matching events:" << reset << endl;
+                             for (int i = 0; i < eventCount; i++) {
+                                 if (selected[i]) {
+                                     cout << "  " << eventNames[i] << " (" << formatDate(eventDates[i]) << ", $" 
+                                          << eventPrices[i] << ", " << eventAvailable[i] << "/" << eventCapacities[i] 
+                                          << " seats left)" << endl;
+                                 }
+                             }
+                             cout << bright_yellow << "\n1. " << reset << cyan << "Scale Price\n" << reset;
+                             cout << bright_yellow << "2. " << reset << cyan << "Add Capacity\n" << reset;
+                             cout << bright_yellow << "3. " << reset << red << "Delete Events\n" << reset;
+                             int action = getValidInteger("Enter Action (0 to cancel): ");
+                             while (action < 0 || action > 3) {
+                                 cout << bright_red << "Invalid action! Enter 1, 2, 3 or 0: " << reset;
+                                 action = getValidInteger("Enter Action: ");
+                             }
+                             double amount = 0;
+                             if (action == 1) {
+                                 amount = getValidDouble("New price as % of the current one (e.g. 110 or 80): ");
+                                 while (amount <= 0) {
+                                     cout << bright_red << "Percentage must be greater than 0! Enter again: " << reset;
+                                     amount = getValidDouble("New price as % of the current one: ");
+                                 }
+                                 amount = amount / 100;
+                             } else if (action == 2) {
+                                 amount = getValidInteger("Seats to add to each event: ");
+                                 while (amount <= 0) {
+                                     cout << bright_red << "Seats must be greater than 0! Enter again: " << reset;
+                                     amount = getValidInteger("Seats to add to each event: ");
+                                 }
+                             }
+                             string confirm = "n";
+                             if (action > 0) {
+                                 cout << bright_yellow << "Apply to " << matches << " events? (y/n): " << reset;
+                                 cin >> confirm;
+                             }
+                             
+                             if (confirm == "y" || confirm == "Y") {
+                                 string result = bulkUpdateEvents(action - 1, amount, selected, eventNames, eventDates, 
+                                                                  eventVenues, eventCategories, eventPrices, 
+                                                                  eventCapacities, eventAvailable, eventDateIndex, 
+                                                                  eventPriceIndex, availableEvents, availablePos, 
+                                                                  availableCount, eventRevenue, eventSeatsSold, 
+                                                                  leaderboardRanks, leaderboardPos, rollupKeys, 
+                                                                  rollupRevenue, rollupTickets, eventTiers, 
+                                                                  eventTierSeatLimits, eventTierDateLimits, 
+                                                                  eventSeatMaps, waitlistHeads, waitlistSizes, 
+                                                                  eventGenerations, eventFreeList, eventFreeCount, 
+                                                                  eventCount);
+                                 if ((int)result.find("Cannot") == 0) {
+                                     cout << "\n" << bright_red << result << reset << endl;
+                                 } else {
+                                     cout << "\n" << bright_green << result << reset << endl;
+                                 }
+                                 
+                                 // New seats may let the front of each waitlist in, the promotions share one ticket save
+                                 int ticketsBefore = ticketCount;
+                                 int waitingBefore = countWaitingRequests(waitlistSizes, eventCount);
+                                 for (int i = 0; i < eventCount && action == 2; i++) {
+                                     if (!selected[i] || waitlistSizes[i] == 0) {
+                                         continue;
+                                     }
+                                     string promoted = promoteWaitlist(i, eventNames, eventPrices, eventAvailable, 
+                                                                       availableEvents, availablePos, availableCount, 
+                                                                       eventCapacities, eventSeatMaps, eventDates, 
+                                                                       eventTiers, eventTierSeatLimits, 
+                                                                       eventTierDateLimits, eventRevenue, eventSeatsSold, 
+                                                                       leaderboardRanks, leaderboardPos, eventGenerations, 
+                                                                       eventFreeCount, eventCount, ticketIDs, ticketUserIDs, 
+                                                                       ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                                       ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                                                                       ticketDateIndex, ticketIDTable, rollupKeys, 
+                                                                       rollupRevenue, rollupTickets, ticketCount, 
+                                                                       lastArchivedTicketID, waitlistUserIDs, 
+                                                                       waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                                                       usernames, userGenerations, userCount, 
+                                                                       userRateTimes, eventRateTimes, purchaseKeys, 
+                                                                       purchaseCounts);
+                                     if (promoted != "") {
+                                         cout << bright_cyan << promoted << reset << endl;
+                                     }
+                                 }
+                                 if (ticketCount != ticketsBefore) {
+                                     snapshotTickets(ticketsBefore, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                     ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                                     ticketSeats, ticketTiers, ticketCount, snapshotTicketIDs, 
+                                                     snapshotTicketUserIDs, snapshotTicketEventIDs, 
+                                                     snapshotTicketQuantities, snapshotTicketCosts, 
+                                                     snapshotTicketDates, snapshotTicketHours, 
+                                                     snapshotTicketSeats, snapshotTicketTiers, snapshotCounts, 
+                                                     snapshotTicketsValid, snapshotTicketsDirty, persistState, 
+                                                     persistLock, persistSignal);
+                                     journalTickets(ticketsBefore, ticketCount, ticketIDs, ticketUserIDs, 
+                                                    ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                    ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                                                    journal);
+                                 }
+                                 // Deleted events drop their queues inside bulkUpdateEvents
+                                 if (action == 3 || countWaitingRequests(waitlistSizes, eventCount) != waitingBefore) {
+                                     snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                                      eventGenerations, eventCount, snapshotWaitlistEventIDs, 
+                                                      snapshotWaitlistUserIDs, snapshotWaitlistQuantities, 
+                                                      snapshotWaitlistCounts, persistState, persistLock, persistSignal);
+                                 }
+                                 
+                                 // One events write covers every changed slot
+                                 snapshotEvents(-1, eventNames, eventDates, eventVenues, eventCategories, 
+                                                eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                                eventSeatMaps, eventCount, snapshotEventNames, snapshotEventDates, 
+                                                snapshotEventVenues, snapshotEventCategories, snapshotEventPrices, 
+                                                snapshotEventCapacities, snapshotEventAvailable, 
+                                                snapshotEventGenerations, snapshotEventSeatMaps, snapshotCounts, 
+                                                snapshotEventsDirty, persistState, persistLock, persistSignal);
+                                 for (int i = 0; i < eventCount; i++) {
+                                     if (selected[i]) {
+                                         journalEvent(i, eventNames, eventDates, eventVenues, eventCategories, 
+                                                      eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                                      eventCount, journal);
+                                     }
+                                 }
+                             } else {
+                                 cout << "\n" << bright_yellow << "No changes made." << reset << endl;
+                             }
+                         }
+                         pauseScreen();
+                         
+                         } else if (adminChoice == "18") {
                              // Logout
                              clearScreen();
                              cout << "\n" << bright_yellow << "*** Admin Logged Out ***\n" << reset;
@@ -488,7 +1729,8 @@
                  cout << "\n" << bright_green << bold << "*** Welcome " << bright_yellow << loggedInUser << bright_green << "! ***\n" << reset;
                  pauseScreen();
                  
-                 string userEmail = getUserEmail(loggedInUser, usernames, emails, userCount);
+                 int loggedInUserIndex = findUserIndex(loggedInUser, usernames, userCount);
+                 int loggedInUserID = makeHandle(loggedInUserIndex, userGenerations[loggedInUserIndex]);
                  
                  bool userSession = true;
                  while (userSession) {
@@ -496,28 +1738,36 @@
                      displayUserMenu();
                      string userChoice = getUserChoice();
                      
+                     // Booking appends to the full ticket store, My Bookings scans all of it and
+                     // cancelling finds the ticket through the ID table built over every ticket
+                     if (!ticketsLoaded && (userChoice == "4" || userChoice == "5" || userChoice == "11")) {
+                         metricStart = getMicros();
+                         ensureTicketsLoaded(ticketsLoaded, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                             ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                             ticketSeats, ticketTiers, ticketSegmentOffsets, 
+                                             ticketSegmentLoaded, ticketSegmentCount, ticketCount, usernames, 
+                                             userGenerations, userCount);
+                         finishTimedCall(3, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+                         buildDateIndex(ticketDateIndex, ticketDates, ticketCount);
+                         buildTicketIDTable(ticketIDTable, ticketIDs, ticketCount);
+                         buildPurchaseCounts(purchaseKeys, purchaseCounts, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                             ticketCount);
+                         buildLeaderboards(ticketEventIDs, ticketQuantities, ticketCosts, ticketCount, eventCapacities, 
+                                           eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                           leaderboardPos, eventGenerations, eventCount);
+                         buildRollups(ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketCount, 
+                                      rollupKeys, rollupRevenue, rollupTickets, eventGenerations, eventCount);
+                     }
+                     
                      if (userChoice == "1" || userChoice == "2" || userChoice == "3" || userChoice == "4" || 
-                         userChoice == "5" || userChoice == "6" || userChoice == "7") {
+                         userChoice == "5" || userChoice == "6" || userChoice == "7" || userChoice == "8" || 
+                         userChoice == "9" || userChoice == "10" || userChoice == "11" || userChoice == "12") {
                          if (userChoice == "1") {
                          // View All Events
                          clearScreen();
                          // Print with colors
-                         cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
-                         if (eventCount == 0) {
-                             cout << bright_red << "No events available!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < eventCount; i++) {
-                                 cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
-                                 cout << cyan << "Date: " << reset << eventDates[i] << endl;
-                                 cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
-                                 cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
-                                 cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
-                                 cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
-                                 cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                        eventCapacities, eventAvailable, eventGenerations, eventCount);
                          pauseScreen();
                          
                          } else if (userChoice == "2") {
@@ -533,9 +1783,11 @@
                              getline(cin, searchName);
                          }
                          
+                         metricStart = getMicros();
                          string result = searchEventByName(searchName, eventNames, eventDates, 
                                                            eventVenues, eventCategories, eventPrices, 
                                                            eventCapacities, eventAvailable, eventCount);
+                         finishTimedCall(7, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
                          if ((int)result.find("No events found") != -1) {
                              cout << bright_red << result << reset << endl;
                          } else {
@@ -558,9 +1810,11 @@
                              getline(cin, category);
                          }
                          
+                         metricStart = getMicros();
                          string result = searchEventByCategory(category, eventNames, eventDates, 
                                                                eventVenues, eventCategories, eventPrices, 
                                                                eventCapacities, eventAvailable, eventCount);
+                         finishTimedCall(8, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
                          if ((int)result.find("No events found") != -1) {
                              cout << bright_red << result << reset << endl;
                          } else {
@@ -573,31 +1827,99 @@
                          // Register for Event (Book Tickets)
                          clearScreen();
                          // Print with colors
-                         cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
-                         if (eventCount == 0) {
-                             cout << bright_red << "No events available!" << reset << endl;
-                         } else {
-                             for (int i = 0; i < eventCount; i++) {
-                                 cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
-                                 cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
-                                 cout << cyan << "Date: " << reset << eventDates[i] << endl;
-                                 cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
-                                 cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
-                                 cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
-                                 cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
-                                 cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
-                                 cout << grey << "--------------------------------" << reset << endl;
-                             }
-                         }
+                         printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                        eventCapacities, eventAvailable, eventGenerations, eventCount);
                          
-                         if (eventCount > 0) {
+                         if (eventCount - eventFreeCount > 0) {
                              int eventIndex = getValidInteger("\nEnter Event Number to Book (0 to cancel): ");
-                             while (eventIndex < 0 || eventIndex > eventCount) {
-                                 cout << bright_red << "Invalid event number! Enter between 0 and " << eventCount << ": " << reset;
+                             while (eventIndex < 0 || (eventIndex > 0 && !isSlotLive(eventIndex - 1, eventGenerations, eventCount))) {
+                                 cout << bright_red << "Invalid event number! Enter one of the listed events or 0: " << reset;
                                  eventIndex = getValidInteger("Enter Event Number: ");
                              }
                              
-                             if (eventIndex > 0 && eventIndex <= eventCount) {
+                             // A kiosk that timed out sends its request key again, that retry gets the
+                             // original booking back instead of a second ticket
+                             string requestKey = "";
+                             int repeatTicketID = -1;
+                             if (eventIndex > 0) {
+                                 clearInputBuffer();
+                                 cout << bright_yellow << "Enter Request Key (Enter to skip): " << reset;
+                                 getline(cin, requestKey);
+                                 if (requestKey != "") {
+                                     repeatTicketID = findRequestKey(hashRequestKey(requestKey, loggedInUserID), 
+                                                                     time(0), requestKeyHashes, 
+                                                                     requestKeyTicketIDs, requestKeyTimes);
+                                 }
+                             }
+                             
+                             if (repeatTicketID != -1) {
+                                 string result = repeatBooking(repeatTicketID, eventIndex - 1, ticketIDTable, 
+                                                               eventNames, ticketIDs, ticketEventIDs, 
+                                                               ticketQuantities, ticketCosts, ticketSeats, 
+                                                               ticketTiers, eventGenerations, eventCount);
+                                 cout << "\n" << bright_yellow << result << reset << endl;
+                             // Seats that come back belong to the queue, so nobody books past a user waiting for them
+                             } else if (eventIndex > 0 && (eventAvailable[eventIndex - 1] == 0 || 
+                                                           isWaitlistShortOfSeats(eventIndex - 1, eventAvailable, 
+                                                                                  waitlistQuantities, waitlistHeads, 
+                                                                                  waitlistSizes))) {
+                                 if (eventAvailable[eventIndex - 1] == 0) {
+                                     cout << "\n" << bright_yellow << "This event is sold out!" << reset << endl;
+                                 } else {
+                                     cout << "\n" << bright_yellow << to_string(waitlistSizes[eventIndex - 1]) 
+                                          << " request(s) are waiting for this event, new bookings join the waitlist." << reset << endl;
+                                 }
+                                 cout << bright_green << "Join the waitlist? (y/n): " << reset;
+                                 string answer = getUserChoice();
+                                 if (answer == "y" || answer == "Y") {
+                                     int quantity = getValidInteger("Enter Number of Tickets: ");
+                                     while (quantity <= 0 || quantity > eventCapacities[eventIndex - 1]) {
+                                         cout << bright_red << "Quantity must be between 1 and " << eventCapacities[eventIndex - 1] << "! Enter again: " << reset;
+                                         quantity = getValidInteger("Enter Number of Tickets: ");
+                                     }
+                                     // Joining the queue goes through the same per-customer limits as booking
+                                     int held = getPurchaseCount(loggedInUserID, 
+                                                                 makeHandle(eventIndex - 1, eventGenerations[eventIndex - 1]), 
+                                                                 purchaseKeys, purchaseCounts);
+                                     if (held + quantity > getTicketCapPerUser()) {
+                                         cout << "\n" << bright_red << "Limit is " << getTicketCapPerUser() 
+                                              << " tickets per customer for this event! You already hold " << held << "." << reset << endl;
+                                     } else if (!takeRateToken(userRateTimes[loggedInUserID % getHandleSlotSpan()], 
+                                                               getCurrentMillis(), getUserBookingInterval(), 
+                                                               getUserBookingBurst())) {
+                                         cout << "\n" << bright_red << "Too many booking attempts! Please wait a few seconds and try again." 
+                                              << reset << endl;
+                                     } else {
+                                         string result = joinWaitlist(eventIndex - 1, loggedInUserID, 
+                                                                      quantity, waitlistUserIDs, 
+                                                                      waitlistQuantities, waitlistHeads, 
+                                                                      waitlistSizes);
+                                         cout << "\n" << bright_green << result << reset << endl;
+                                         snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, 
+                                                          waitlistSizes, eventGenerations, eventCount, 
+                                                          snapshotWaitlistEventIDs, snapshotWaitlistUserIDs, 
+                                                          snapshotWaitlistQuantities, snapshotWaitlistCounts, 
+                                                          persistState, persistLock, persistSignal);
+                                     }
+                                 }
+                             } else if (eventIndex > 0) {
+                                 if (getSeatRowCount(eventCapacities[eventIndex - 1]) > 0) {
+                                     printSeatMap(eventIndex - 1, eventSeatMaps, eventCapacities);
+                                     cout << bright_yellow << "Groups are seated together in one row, largest free block: " 
+                                          << getLargestSeatBlock(eventIndex - 1, eventSeatMaps, eventCapacities) << reset << endl;
+                                 }
+                                 updatePriceTier(eventIndex - 1, getCurrentDate(), eventDates, 
+                                                 eventCapacities, eventAvailable, eventTiers, 
+                                                 eventTierSeatLimits, eventTierDateLimits);
+                                 cout << cyan << "Current Price: " << reset << bright_green << "$" 
+                                      << getTierPrice(eventIndex - 1, eventPrices, eventTiers) << reset << " (" 
+                                      << getPriceTierName(eventTiers[eventIndex - 1]) << ")" << endl;
+                                 if (eventTiers[eventIndex - 1] != 2) {
+                                     int tierSeats = eventAvailable[eventIndex - 1] - eventTierSeatLimits[eventIndex - 1];
+                                     cout << cyan << "Only the next " << tierSeats << " seats sell at this price, " 
+                                          << "seats after that are " << getPriceTierName(2) << " at $" 
+                                          << eventPrices[eventIndex - 1] * getPriceTierMultiplier(2) << reset << endl;
+                                 }
                                  int quantity = getValidInteger("Enter Number of Tickets: ");
                                  while (quantity <= 0) {
                                      cout << bright_red << "Quantity must be greater than 0! Enter again: " << reset;
@@ -608,17 +1930,54 @@
                                      quantity = getValidInteger("Enter Number of Tickets: ");
                                  }
                                  
-                                 string result = bookTicket(loggedInUser, userEmail, eventIndex - 1, quantity, 
-                                                           eventNames, eventPrices, eventAvailable, 
-                                                           ticketIDs, ticketUsernames, ticketEmails, 
-                                                           ticketEventIDs, ticketQuantities, ticketCosts, 
-                                                           ticketDates, ticketCount);
+                                 int ticketsBefore = ticketCount;
+                                 metricStart = getMicros();
+                                 string result = bookTicket(loggedInUserID, eventIndex - 1, quantity, 
+                                                            eventNames, eventPrices, eventAvailable, 
+                                                            availableEvents, availablePos, availableCount, 
+                                                            eventCapacities, eventSeatMaps, eventDates, 
+                                                            eventTiers, eventTierSeatLimits, 
+                                                            eventTierDateLimits, eventRevenue, eventSeatsSold, 
+                                                            leaderboardRanks, leaderboardPos, 
+                                                            eventGenerations, eventFreeCount, eventCount, 
+                                                            ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                            ticketQuantities, ticketCosts, ticketDates, 
+                                                            ticketHours, ticketSeats, ticketTiers, 
+                                                            ticketDateIndex, ticketIDTable, rollupKeys, 
+                                                            rollupRevenue, rollupTickets, ticketCount, 
+                                                            lastArchivedTicketID, getCurrentMillis(), 
+                                                            userRateTimes, eventRateTimes, purchaseKeys, 
+                                                            purchaseCounts);
+                                 finishTimedCall(0, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
                                  cout << "\n" << bright_green << result << reset << endl;
-                                 saveTicketsToTXT(ticketIDs, ticketUsernames, ticketEmails, 
-                                                 ticketEventIDs, ticketQuantities, ticketCosts, 
-                                                 ticketDates, ticketCount);
-                                 saveEventsToTXT(eventNames, eventDates, eventVenues, eventCategories, 
-                                                eventPrices, eventCapacities, eventAvailable, eventCount);
+                                 if (requestKey != "" && ticketCount > ticketsBefore) {
+                                     rememberRequestKey(hashRequestKey(requestKey, loggedInUserID), 
+                                                        ticketIDs[ticketCount - 1], time(0), requestKeyHashes, 
+                                                        requestKeyTicketIDs, requestKeyTimes);
+                                 }
+                                 snapshotTickets(ticketsBefore, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                 ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                                 ticketSeats, ticketTiers, ticketCount, snapshotTicketIDs, 
+                                                 snapshotTicketUserIDs, snapshotTicketEventIDs, 
+                                                 snapshotTicketQuantities, snapshotTicketCosts, 
+                                                 snapshotTicketDates, snapshotTicketHours, 
+                                                 snapshotTicketSeats, snapshotTicketTiers, snapshotCounts, 
+                                                 snapshotTicketsValid, snapshotTicketsDirty, persistState, 
+                                                 persistLock, persistSignal);
+                                 // Only the booked event's seat count changed, so only its events.avail record is rewritten
+                                 snapshotSeatCount(eventIndex - 1, eventAvailable[eventIndex - 1], eventSeatMaps, 
+                                                   snapshotEventAvailable, snapshotEventSeatMaps, 
+                                                   snapshotSeatSlots, snapshotSeatCounts, persistState, 
+                                                   persistLock, persistSignal);
+                                 if (ticketCount > ticketsBefore) {
+                                     journalTickets(ticketsBefore, ticketCount, ticketIDs, ticketUserIDs, 
+                                                    ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                    ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                                                    journal);
+                                     journalEvent(eventIndex - 1, eventNames, eventDates, eventVenues, 
+                                                  eventCategories, eventPrices, eventCapacities, 
+                                                  eventAvailable, eventGenerations, eventCount, journal);
+                                 }
                              }
                          }
                          pauseScreen();
@@ -626,10 +1985,10 @@
                          } else if (userChoice == "5") {
                          // My Bookings
                          clearScreen();
-                         string bookings = viewUserTickets(loggedInUser, ticketIDs, ticketUsernames, 
-                                                          ticketEmails, ticketEventIDs, ticketQuantities, 
-                                                          ticketCosts, ticketDates, eventNames, 
-                                                          ticketCount, eventCount);
+                         string bookings = viewUserTickets(loggedInUserID, ticketIDs, ticketUserIDs, 
+                                                           ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                           ticketDates, ticketSeats, ticketTiers, eventNames, 
+                                                           ticketCount, eventGenerations, eventCount);
                          if (bookings != "") {
                              cout << bright_red << bookings << reset << endl;
                          }
@@ -642,28 +2001,34 @@
                                  cout << bright_red << "No tickets available!" << reset << endl;
                              } else {
                                  int ticketID = getValidInteger("Enter Ticket ID to View: ");
-                                 bool found = false;
-                                 for (int i = 0; i < ticketCount; i++) {
-                                     if (ticketIDs[i] == ticketID) {
-                                         found = true;
-                                         break;
-                                     }
-                                 }
-                                 while (!found) {
+                                 int segment = findTicketSegment(ticketID, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                                 ticketQuantities, ticketCosts, ticketDates, 
+                                                                 ticketHours, ticketSeats, ticketTiers, 
+                                                                 ticketIDTable, ticketSegmentMinIDs, 
+                                                                 ticketSegmentMaxIDs, ticketSegmentLoaded, 
+                                                                 ticketSegmentCount, ticketCount, ticketsLoaded, 
+                                                                 usernames, userGenerations, userCount);
+                                 while (segment == -1) {
                                      cout << bright_red << "Ticket ID not found! Enter a valid ticket ID: " << reset;
                                      ticketID = getValidInteger("Enter Ticket ID: ");
-                                     found = false;
-                                     for (int i = 0; i < ticketCount; i++) {
-                                         if (ticketIDs[i] == ticketID) {
-                                             found = true;
-                                             break;
-                                         }
-                                     }
+                                     segment = findTicketSegment(ticketID, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                                 ticketQuantities, ticketCosts, ticketDates, 
+                                                                 ticketHours, ticketSeats, ticketTiers, 
+                                                                 ticketIDTable, ticketSegmentMinIDs, 
+                                                                 ticketSegmentMaxIDs, ticketSegmentLoaded, 
+                                                                 ticketSegmentCount, ticketCount, ticketsLoaded, 
+                                                                 usernames, userGenerations, userCount);
                                  }
-                                 string ticket = viewTicketByID(ticketID, ticketIDs, ticketUsernames, 
-                                                                ticketEmails, ticketEventIDs, ticketQuantities, 
-                                                                ticketCosts, ticketDates, eventNames, 
-                                                                ticketCount, eventCount);
+                                 // Look only inside that segment, the rest may not be paged in
+                                 int first = segment * getTicketSegmentSize();
+                                 int length = min(getTicketSegmentSize(), ticketCount - first);
+                                 string ticket = viewTicketByID(ticketID, ticketIDs + first, 
+                                                                ticketUserIDs + first, ticketEventIDs + first, 
+                                                                ticketQuantities + first, ticketCosts + first, 
+                                                                ticketDates + first, ticketSeats + first, 
+                                                                ticketTiers + first, eventNames, usernames, 
+                                                                emails, length, eventGenerations, eventCount, 
+                                                                userGenerations, userCount);
                                  if (ticket != "") {
                                      cout << bright_red << ticket << reset << endl;
                                  }
@@ -671,70 +2036,366 @@
                          pauseScreen();
                          
                          } else if (userChoice == "7") {
-                             // Logout
-                             clearScreen();
-                             cout << "\n" << bright_yellow << "*** User Logged Out ***\n" << reset;
-                             pauseScreen();
-                             userSession = false;
+                         // Upcoming Events
+                         clearScreen();
+                         string result = viewUpcomingEvents(eventNames, eventDates, eventVenues, 
+                                                            eventCategories, eventPrices, eventCapacities, 
+                                                            eventAvailable, eventDateIndex, 
+                                                            eventCount - eventFreeCount);
+                         if ((int)result.find("No upcoming events") != -1) {
+                             cout << bright_red << result << reset << endl;
+                         } else {
+                             cout << bright_cyan << bold << "\n========== UPCOMING EVENTS ==========\n" << reset;
+                             cout << result << endl;
                          }
-                     } else {
-                         cout << "\n" << bright_red << "Invalid option! Please try again.\n" << reset;
                          pauseScreen();
-                     }
-                 }
-             } else {
-                 clearScreen();
-                 cout << "\n" << bright_red << bold << "*** Login Failed! ***\n" << reset;
-                 pauseScreen();
-             }
-             
-         } else if (choice == "3") {
-             // User Signup
-             clearScreen();
-             cout << "\n" << bright_cyan << bold << "========== USER SIGNUP ==========\n" << reset;
-             bool signupSuccess = userSignup(usernames, passwords, emails, userCount);
-             
-             if (signupSuccess) {
-                 cout << "\n" << bright_green << bold << "*** Signup Successful! You can now login. ***\n" << reset;
-                 saveUsersToTXT(usernames, passwords, emails, userCount);
-             } else {
-                 cout << "\n" << bright_red << "*** Signup Failed! ***\n" << reset;
-             }
-             pauseScreen();
-             
-         } else if (choice == "4") {
-             // Exit
-             clearScreen();
-             cout << "\n" << bright_magenta << bold << "*** Thank you for using Event Management System! ***\n" << reset;
-             running = false;
-             
-         } else {
-             cout << "\n" << bright_red << "Invalid option! Please try again.\n" << reset;
-             pauseScreen();
-         }
-     }
-     
-     return 0;
- }
- }
- 
- // Display Functions
- void clearScreen() {
-     // Clear screen by printing newlines (simple approach)
-     for (int i = 0; i < 2; i++) {
-         cout << endl;
-     }
- }
- 
- void displayHeader() {
-     cout << bright_cyan << bold << "================================================\n";
-     cout << "    EVENT REGISTRATION & TICKETING SYSTEM\n";
-     cout << "    Comprehensive Event Management Solution\n";
-     cout << "================================================\n" << reset;
- }
- 
- void displayMainMenu() {
-     cout << bright_blue << bold << "========== MAIN MENU ==========\n" << reset;
+                         
+                         } else if (userChoice == "8") {
+                         // Search Events by Date Range
+                         clearScreen();
+                         cout << "\n" << bright_cyan << bold << "========== SEARCH BY DATE RANGE ==========\n" << reset;
+                         cin.ignore();
+                         string fromDate, toDate;
+                         cout << bright_yellow << "Enter From Date (DD-MM-YYYY): " << reset;
+                         getline(cin, fromDate);
+                         while (parseDate(fromDate) == -1) {
+                             cout << bright_red << "Invalid date! Use DD-MM-YYYY. Enter again: " << reset;
+                             getline(cin, fromDate);
+                         }
+                         cout << bright_yellow << "Enter To Date (DD-MM-YYYY): " << reset;
+                         getline(cin, toDate);
+                         while (parseDate(toDate) == -1 || parseDate(toDate) < parseDate(fromDate)) {
+                             cout << bright_red << "Invalid date! Must be DD-MM-YYYY and not before the From Date: " << reset;
+                             getline(cin, toDate);
+                         }
+                         
+                         metricStart = getMicros();
+                         string result = searchEventsByDateRange(parseDate(fromDate), parseDate(toDate), 
+                                                                 eventNames, eventDates, eventVenues, 
+                                                                 eventCategories, eventPrices, eventCapacities, 
+                                                                 eventAvailable, eventDateIndex, 
+                                                                 eventCount - eventFreeCount);
+                         finishTimedCall(9, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+                         if ((int)result.find("No events found") != -1) {
+                             cout << bright_red << result << reset << endl;
+                         } else {
+                             cout << bright_cyan << bold << "\n========== SEARCH RESULTS ==========\n" << reset;
+                             cout << result << endl;
+                         }
+                         pauseScreen();
+                         
+                         } else if (userChoice == "9") {
+                         // Browse Events by Price
+                         clearScreen();
+                         cout << "\n" << bright_cyan << bold << "========== BROWSE BY PRICE ==========\n" << reset;
+                         double minPrice = getValidDouble("Enter Minimum Price: $");
+                         while (minPrice < 0) {
+                             cout << bright_red << "Price cannot be negative! Enter again: " << reset;
+                             minPrice = getValidDouble("Enter Minimum Price: $");
+                         }
+                         double maxPrice = getValidDouble("Enter Maximum Price: $");
+                         while (maxPrice < minPrice) {
+                             cout << bright_red << "Maximum price cannot be below the minimum! Enter again: " << reset;
+                             maxPrice = getValidDouble("Enter Maximum Price: $");
+                         }
+                         string onlyAvailable;
+                         cout << bright_yellow << "Only show events with seats left? (y/n): " << reset;
+                         cin >> onlyAvailable;
+                         
+                         int page = 1;
+                         while (page > 0) {
+                             metricStart = getMicros();
+                             string result = browseEventsByPrice(minPrice, maxPrice, onlyAvailable == "y" || onlyAvailable == "Y", 
+                                                                 page, eventNames, eventDates, eventVenues, 
+                                                                 eventCategories, eventPrices, eventCapacities, 
+                                                                 eventAvailable, eventPriceIndex, availableEvents, 
+                                                                 availableCount, eventCount - eventFreeCount);
+                             finishTimedCall(10, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+                             if ((int)result.find("No events found") != -1) {
+                                 cout << bright_red << result << reset << endl;
+                                 break;
+                             }
+                             cout << result << endl;
+                             if ((int)result.find("More results") == -1) {
+                                 break;
+                             }
+                             page = getValidInteger("Enter Page Number (0 to stop): ");
+                         }
+                         pauseScreen();
+                         
+                         } else if (userChoice == "10") {
+                         // Advanced Search
+                         clearScreen();
+                         cout << "\n" << bright_cyan << bold << "========== ADVANCED SEARCH ==========\n" << reset;
+                         cout << cyan << "Leave a field blank to skip it. Every field in a group must match,\n"
+                              << "an event is shown when any group matches.\n" << reset;
+                         int termFields[getMaxQueryTerms()];
+                         int termGroups[getMaxQueryTerms()];
+                         string termTexts[getMaxQueryTerms()];
+                         double termLows[getMaxQueryTerms()];
+                         double termHighs[getMaxQueryTerms()];
+                         int termCount = 0;
+                         int groupCount = 0;
+                         string another = "y";
+                         
+                         // Each group can add at most one term per field
+                         while ((another == "y" || another == "Y") && termCount + 6 <= getMaxQueryTerms()) {
+                             if (groupCount > 0) {
+                                 clearInputBuffer();
+                             }
+                             cout << "\n" << bright_yellow << bold << "--- Group " << groupCount + 1 << " ---\n" << reset;
+                             string labels[] = {"Name contains: ", "Category contains: ", "Venue contains: "};
+                             for (int field = 0; field < 3; field++) {
+                                 string text;
+                                 cout << bright_yellow << labels[field] << reset;
+                                 getline(cin, text);
+                                 if ((int)text.length() > 0) {
+                                     termFields[termCount] = field;
+                                     termGroups[termCount] = groupCount;
+                                     termTexts[termCount] = text;
+                                     termLows[termCount] = 0;
+                                     termHighs[termCount] = 0;
+                                     termCount++;
+                                 }
+                             }
+                             
+                             string fromDate, toDate;
+                             cout << bright_yellow << "From Date (DD-MM-YYYY): " << reset;
+                             getline(cin, fromDate);
+                             while ((int)fromDate.length() > 0 && parseDate(fromDate) == -1) {
+                                 cout << bright_red << "Invalid date! Use DD-MM-YYYY or leave blank: " << reset;
+                                 getline(cin, fromDate);
+                             }
+                             if ((int)fromDate.length() > 0) {
+                                 cout << bright_yellow << "To Date (DD-MM-YYYY): " << reset;
+                                 getline(cin, toDate);
+                                 while (parseDate(toDate) == -1 || parseDate(toDate) < parseDate(fromDate)) {
+                                     cout << bright_red << "Invalid date! Must be DD-MM-YYYY and not before the From Date: " << reset;
+                                     getline(cin, toDate);
+                                 }
+                                 termFields[termCount] = 3;
+                                 termGroups[termCount] = groupCount;
+                                 termTexts[termCount] = "";
+                                 termLows[termCount] = parseDate(fromDate);
+                                 termHighs[termCount] = parseDate(toDate);
+                                 termCount++;
+                             }
+                             
+                             string answer;
+                             cout << bright_yellow << "Filter by price range? (y/n): " << reset;
+                             cin >> answer;
+                             if (answer == "y" || answer == "Y") {
+                                 double minPrice = getValidDouble("Enter Minimum Price: $");
+                                 while (minPrice < 0) {
+                                     cout << bright_red << "Price cannot be negative! Enter again: " << reset;
+                                     minPrice = getValidDouble("Enter Minimum Price: $");
+                                 }
+                                 double maxPrice = getValidDouble("Enter Maximum Price: $");
+                                 while (maxPrice < minPrice) {
+                                     cout << bright_red << "Maximum price cannot be below the minimum! Enter again: " << reset;
+                                     maxPrice = getValidDouble("Enter Maximum Price: $");
+                                 }
+                                 termFields[termCount] = 4;
+                                 termGroups[termCount] = groupCount;
+                                 termTexts[termCount] = "";
+                                 termLows[termCount] = minPrice;
+                                 termHighs[termCount] = maxPrice;
+                                 termCount++;
+                             }
+                             
+                             cout << bright_yellow << "Only events with seats left? (y/n): " << reset;
+                             cin >> answer;
+                             if (answer == "y" || answer == "Y") {
+                                 termFields[termCount] = 5;
+                                 termGroups[termCount] = groupCount;
+                                 termTexts[termCount] = "";
+                                 termLows[termCount] = 0;
+                                 termHighs[termCount] = 0;
+                                 termCount++;
+                             }
+                             groupCount++;
+                             
+                             cout << bright_yellow << "Add another group (OR)? (y/n): " << reset;
+                             cin >> another;
+                         }
+                         
+                         int results[getMaxEvents()];
+                         metricStart = getMicros();
+                         int resultCount = queryEvents(termFields, termGroups, termTexts, termLows, termHighs, 
+                                                       termCount, groupCount, eventNames, eventDates, eventVenues, 
+                                                       eventCategories, eventPrices, eventAvailable, eventDateIndex, 
+                                                       eventPriceIndex, availableEvents, availableCount, 
+                                                       eventGenerations, eventFreeCount, eventCount, results);
+                         finishTimedCall(12, metricStart, 0, metricBuckets, metricStats, traceSpans, traceCounts[0]);
+                         string result = formatQueryResults(results, resultCount, eventNames, eventDates, eventVenues, 
+                                                            eventCategories, eventPrices, eventCapacities, 
+                                                            eventAvailable, eventGenerations, eventCount);
+                         if ((int)result.find("No events found") != -1) {
+                             cout << bright_red << result << reset << endl;
+                         } else {
+                             cout << result << endl;
+                         }
+                         pauseScreen();
+                         
+                         } else if (userChoice == "11") {
+                         // Cancel Ticket
+                         clearScreen();
+                         int ticketID = getValidInteger("Enter Ticket ID to Cancel (0 to go back): ");
+                         if (ticketID > 0) {
+                             int changedFrom = findTicketIndex(ticketID, ticketIDTable, ticketIDs);
+                             int eventIndex = -1;
+                             string result = cancelTicket(ticketID, loggedInUserID, ticketIDTable, ticketIDs, 
+                                                          ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                                          ticketCosts, ticketDates, ticketHours, ticketSeats, 
+                                                          eventAvailable, eventPrices, availableEvents, 
+                                                          availablePos, availableCount, eventCapacities, 
+                                                          eventSeatMaps, eventRevenue, eventSeatsSold, 
+                                                          leaderboardRanks, leaderboardPos, rollupKeys, 
+                                                          rollupRevenue, rollupTickets, eventGenerations, 
+                                                          eventFreeCount, eventCount, purchaseKeys, 
+                                                          purchaseCounts, eventIndex);
+                             if (eventIndex == -1) {
+                                 cout << "\n" << bright_red << result << reset << endl;
+                             } else {
+                                 cout << "\n" << bright_green << result << reset << endl;
+                                 updatePriceTier(eventIndex, getCurrentDate(), eventDates, eventCapacities, 
+                                                 eventAvailable, eventTiers, eventTierSeatLimits, 
+                                                 eventTierDateLimits);
+                                 
+                                 // The returned seats go to the front of the waitlist before anyone else
+                                 int ticketsBefore = ticketCount;
+                                 int waitingBefore = waitlistSizes[eventIndex];
+                                 string promoted = promoteWaitlist(eventIndex, eventNames, eventPrices, eventAvailable, 
+                                                                   availableEvents, availablePos, availableCount, 
+                                                                   eventCapacities, eventSeatMaps, 
+                                                                   eventDates, eventTiers, 
+                                                                   eventTierSeatLimits, eventTierDateLimits, 
+                                                                   eventRevenue, eventSeatsSold, 
+                                                                   leaderboardRanks, leaderboardPos, eventGenerations, 
+                                                                   eventFreeCount, eventCount, ticketIDs, ticketUserIDs, 
+                                                                   ticketEventIDs, ticketQuantities, ticketCosts, 
+                                                                   ticketDates, ticketHours, ticketSeats, 
+                                                                   ticketTiers, 
+                                                                   ticketDateIndex, ticketIDTable, 
+                                                                   rollupKeys, rollupRevenue, rollupTickets, ticketCount, 
+                                                                   lastArchivedTicketID, waitlistUserIDs, waitlistQuantities, 
+                                                                   waitlistHeads, waitlistSizes, usernames, 
+                                                                   userGenerations, userCount, userRateTimes, 
+                                                                   eventRateTimes, purchaseKeys, 
+                                                                   purchaseCounts);
+                                 if (promoted != "") {
+                                     cout << bright_cyan << promoted << reset << endl;
+                                 }
+                                 
+                                 // The cancelled row changed in place, the snapshot is refreshed from there on
+                                 snapshotTickets(changedFrom, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                 ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                                 ticketSeats, ticketTiers, ticketCount, snapshotTicketIDs, 
+                                                 snapshotTicketUserIDs, snapshotTicketEventIDs, 
+                                                 snapshotTicketQuantities, snapshotTicketCosts, 
+                                                 snapshotTicketDates, snapshotTicketHours, 
+                                                 snapshotTicketSeats, snapshotTicketTiers, snapshotCounts, 
+                                                 snapshotTicketsValid, snapshotTicketsDirty, persistState, 
+                                                 persistLock, persistSignal);
+                                 snapshotSeatCount(eventIndex, eventAvailable[eventIndex], eventSeatMaps, 
+                                                   snapshotEventAvailable, snapshotEventSeatMaps, 
+                                                   snapshotSeatSlots, snapshotSeatCounts, persistState, persistLock, 
+                                                   persistSignal);
+                                 if (waitlistSizes[eventIndex] != waitingBefore) {
+                                     snapshotWaitlist(waitlistUserIDs, waitlistQuantities, waitlistHeads, waitlistSizes, 
+                                                      eventGenerations, eventCount, snapshotWaitlistEventIDs, 
+                                                      snapshotWaitlistUserIDs, snapshotWaitlistQuantities, 
+                                                      snapshotWaitlistCounts, persistState, persistLock, persistSignal);
+                                 }
+                                 journalTickets(changedFrom, changedFrom + 1, ticketIDs, ticketUserIDs, 
+                                                ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, 
+                                                ticketHours, ticketSeats, ticketTiers, journal);
+                                 journalTickets(ticketsBefore, ticketCount, ticketIDs, ticketUserIDs, 
+                                                ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, 
+                                                ticketHours, ticketSeats, ticketTiers, journal);
+                                 journalEvent(eventIndex, eventNames, eventDates, eventVenues, eventCategories, 
+                                              eventPrices, eventCapacities, eventAvailable, eventGenerations, 
+                                              eventCount, journal);
+                             }
+                         }
+                         pauseScreen();
+                         
+                         } else if (userChoice == "12") {
+                             // Logout
+                             clearScreen();
+                             cout << "\n" << bright_yellow << "*** User Logged Out ***\n" << reset;
+                             pauseScreen();
+                             userSession = false;
+                         }
+                     } else {
+                         cout << "\n" << bright_red << "Invalid option! Please try again.\n" << reset;
+                         pauseScreen();
+                     }
+                 }
+             } else {
+                 clearScreen();
+                 cout << "\n" << bright_red << bold << "*** Login Failed! ***\n" << reset;
+                 pauseScreen();
+             }
+             
+         } else if (choice == "3") {
+             // User Signup
+             clearScreen();
+             cout << "\n" << bright_cyan << bold << "========== USER SIGNUP ==========\n" << reset;
+             int slot = userFreeCount > 0 ? userFreeList[userFreeCount - 1] : userCount;
+             bool signupSuccess = userSignup(usernames, passwords, emails, userGenerations, 
+                                             userFreeList, userFreeCount, userCount);
+             
+             if (signupSuccess) {
+                 cout << "\n" << bright_green << bold << "*** Signup Successful! You can now login. ***\n" << reset;
+                 snapshotUsers(usernames, passwords, emails, userGenerations, userCount, snapshotUsernames, 
+                               snapshotPasswords, snapshotEmails, snapshotUserGenerations, snapshotCounts, 
+                               persistState, persistLock, persistSignal);
+                 journalUser(slot, usernames, emails, userGenerations, journal);
+             } else {
+                 cout << "\n" << bright_red << "*** Signup Failed! ***\n" << reset;
+             }
+             pauseScreen();
+             
+         } else if (choice == "4") {
+             // Exit
+             clearScreen();
+             cout << "\n" << bright_magenta << bold << "*** Thank you for using Event Management System! ***\n" << reset;
+             running = false;
+             
+         } else {
+             cout << "\n" << bright_red << "Invalid option! Please try again.\n" << reset;
+             pauseScreen();
+         }
+     }
+     
+     // Nothing is lost on exit, the worker writes whatever is still pending before it stops
+     stopPersistence(persistenceWorker, persistState, persistLock, persistSignal);
+     if (isTraceEnabled()) {
+         cout << writeTraceToFile("trace.json", traceSpans, traceCounts) << endl;
+     }
+     return 0;
+ }
+ }
+ #endif
+ 
+ // Display Functions
+ void clearScreen() {
+     // Clear screen by printing newlines (simple approach)
+     for (int i = 0; i < 2; i++) {
+         cout << endl;
+     }
+ }
+ 
+ void displayHeader() {
+     cout << bright_cyan << bold << "================================================\n";
+     cout << "    EVENT REGISTRATION & TICKETING SYSTEM\n";
+     cout << "    Comprehensive Event Management Solution\n";
+     cout << "================================================\n" << reset;
+ }
+ 
+ void displayMainMenu() {
+     cout << bright_blue << bold << "========== MAIN MENU ==========\n" << reset;
      cout << bright_yellow << "1. " << reset << cyan << "Admin Portal\n" << reset;
      cout << bright_yellow << "2. " << reset << cyan << "User Portal\n" << reset;
      cout << bright_yellow << "3. " << reset << cyan << "User Signup\n" << reset;
@@ -753,7 +2414,16 @@
      cout << bright_yellow << "6. " << reset << cyan << "Generate Reports\n" << reset;
      cout << bright_yellow << "7. " << reset << cyan << "View All Users\n" << reset;
      cout << bright_yellow << "8. " << reset << cyan << "Delete User\n" << reset;
-     cout << bright_yellow << "9. " << reset << red << "Logout\n" << reset;
+     cout << bright_yellow << "9. " << reset << cyan << "Tickets Sold on Date\n" << reset;
+     cout << bright_yellow << "10. " << reset << cyan << "Best-Seller Leaderboard\n" << reset;
+     cout << bright_yellow << "11. " << reset << cyan << "Sales Rollups\n" << reset;
+     cout << bright_yellow << "12. " << reset << cyan << "Performance Metrics\n" << reset;
+     cout << bright_yellow << "13. " << reset << cyan << "Archive Past Events\n" << reset;
+     cout << bright_yellow << "14. " << reset << cyan << "Archived Event Reports\n" << reset;
+     cout << bright_yellow << "15. " << reset << cyan << "Sync Data to Disk\n" << reset;
+     cout << bright_yellow << "16. " << reset << cyan << "Gate Check-In\n" << reset;
+     cout << bright_yellow << "17. " << reset << cyan << "Bulk Update Events\n" << reset;
+     cout << bright_yellow << "18. " << reset << red << "Logout\n" << reset;
      cout << bright_magenta << "=====================================\n" << reset;
      cout << bright_green << "Enter your choice: " << reset;
  }
@@ -766,11 +2436,31 @@
      cout << bright_yellow << "4. " << reset << cyan << "Register & Book Tickets\n" << reset;
      cout << bright_yellow << "5. " << reset << cyan << "My Bookings\n" << reset;
      cout << bright_yellow << "6. " << reset << cyan << "View Ticket by ID\n" << reset;
-     cout << bright_yellow << "7. " << reset << red << "Logout\n" << reset;
+     cout << bright_yellow << "7. " << reset << cyan << "Upcoming Events\n" << reset;
+     cout << bright_yellow << "8. " << reset << cyan << "Search Events by Date Range\n" << reset;
+     cout << bright_yellow << "9. " << reset << cyan << "Browse Events by Price\n" << reset;
+     cout << bright_yellow << "10. " << reset << cyan << "Advanced Search\n" << reset;
+     cout << bright_yellow << "11. " << reset << cyan << "Cancel Ticket\n" << reset;
+     cout << bright_yellow << "12. " << reset << red << "Logout\n" << reset;
      cout << bright_cyan << "====================================\n" << reset;
      cout << bright_green << "Enter your choice: " << reset;
  }
  
+ void displayReplicaMenu() {
+     cout << bright_green << bold << "========== READ REPLICA ==========\n" << reset;
+     cout << bright_yellow << "1. " << reset << cyan << "View All Events\n" << reset;
+     cout << bright_yellow << "2. " << reset << cyan << "Search Event by Name\n" << reset;
+     cout << bright_yellow << "3. " << reset << cyan << "Search Event by Category\n" << reset;
+     cout << bright_yellow << "4. " << reset << cyan << "View All Registrations\n" << reset;
+     cout << bright_yellow << "5. " << reset << cyan << "Generate Reports\n" << reset;
+     cout << bright_yellow << "6. " << reset << cyan << "Best-Seller Leaderboard\n" << reset;
+     cout << bright_yellow << "7. " << reset << cyan << "Sales Rollups\n" << reset;
+     cout << bright_yellow << "8. " << reset << cyan << "Replication Status\n" << reset;
+     cout << bright_yellow << "9. " << reset << red << "Exit\n" << reset;
+     cout << bright_green << "==================================\n" << reset;
+     cout << bright_green << "Enter your choice: " << reset;
+ }
+ 
  string getUserChoice() {
      string choice;
      cin >> choice;
@@ -784,6 +2474,50 @@
      cin.get();
  }
  
+ void printEventList(string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[], int eventCount) {
+     // Events keep their slot number for life, so deleted slots leave gaps in the numbering
+     cout << bright_cyan << bold << "\n========== ALL EVENTS ==========\n" << reset;
+     bool found = false;
+     for (int i = 0; i < eventCount; i++) {
+         if (!isSlotLive(i, eventGenerations, eventCount)) {
+             continue;
+         }
+         found = true;
+         cout << "\n" << bright_yellow << "Event #" << (i + 1) << reset << endl;
+         cout << cyan << "Name: " << reset << bright_white << eventNames[i] << reset << endl;
+         cout << cyan << "Date: " << reset << formatDate(eventDates[i]) << endl;
+         cout << cyan << "Venue: " << reset << eventVenues[i] << endl;
+         cout << cyan << "Category: " << reset << bright_magenta << eventCategories[i] << reset << endl;
+         cout << cyan << "Price: " << reset << bright_green << "$" << to_string(eventPrices[i]) << reset << endl;
+         cout << cyan << "Capacity: " << reset << to_string(eventCapacities[i]) << endl;
+         cout << cyan << "Available: " << reset << bright_yellow << to_string(eventAvailable[i]) << reset << endl;
+         cout << grey << "--------------------------------" << reset << endl;
+     }
+     if (!found) {
+         cout << bright_red << "No events available!" << reset << endl;
+     }
+ }
+ 
+ void printUserList(string usernames[], string emails[], int userGenerations[], int userCount) {
+     cout << bright_cyan << bold << "\n========== ALL USERS ==========\n" << reset;
+     bool found = false;
+     for (int i = 0; i < userCount; i++) {
+         if (!isSlotLive(i, userGenerations, userCount)) {
+             continue;
+         }
+         found = true;
+         cout << "\n" << bright_yellow << "User #" << (i + 1) << reset << endl;
+         cout << cyan << "Username: " << reset << bright_white << usernames[i] << reset << endl;
+         cout << cyan << "Email: " << reset << emails[i] << endl;
+         cout << grey << "--------------------------------" << reset << endl;
+     }
+     if (!found) {
+         cout << bright_red << "No users registered!" << reset << endl;
+     }
+ }
+ 
  // Authentication Functions
  bool adminLogin() {
      string username, password;
@@ -834,8 +2568,9 @@
      return "";
  }
  
- bool userSignup(string usernames[], string passwords[], string emails[], int& userCount) {
-     if (userCount >= getMaxUsers()) {
+ bool userSignup(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                 int userFreeList[], int& userFreeCount, int& userCount) {
+     if (userCount >= getMaxUsers() && userFreeCount == 0) {
          cout << "User limit reached!\n";
          return false;
      }
@@ -884,12 +2619,14 @@
          return false;
      }
      
-     string result = addUser(username, password, email, usernames, passwords, emails, userCount);
+     string result = addUser(username, password, email, usernames, passwords, emails, userGenerations, 
+                             userFreeList, userFreeCount, userCount);
      return true;
  }
  
  // File Handling Functions (TXT Format)
- void loadUsersFromTXT(string usernames[], string passwords[], string emails[], int& userCount) {
+ void loadUsersFromTXT(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                       int userFreeList[], int& userFreeCount, int& userCount) {
      ifstream file("users.txt");
      
      if (!file.is_open()) {
@@ -897,763 +2634,4988 @@
      }
      
      userCount = 0;
+     userFreeCount = 0;
      string line;
      while (userCount < getMaxUsers() && getline(file, line)) {
-         // Parse TXT line: username|password|email
-         int pipe1 = (int)line.find("|");
-         int pipe2 = -1;
+         // Parse TXT line: username|password|email|generation
+         // Files written before generations were stored have no fourth field and load as generation 0
+         int starts[getUserColumnCount()];
+         int ends[getUserColumnCount()];
+         int columns = splitColumns(line, starts, ends, getUserColumnCount());
+         if (columns < 3) {
+             continue;
+         }
+         userGenerations[userCount] = columns == 4 ? readIntColumn(line, starts[3], ends[3]) : 0;
          
-         if (pipe1 != -1) {
-             usernames[userCount] = "";
-             for (int i = 0; i < pipe1; i++) {
-                 usernames[userCount] += line[i];
-             }
-             
-             for (int i = pipe1 + 1; i < (int)line.length(); i++) {
-                 if (line[i] == '|') {
-                     pipe2 = i;
-                     break;
-                 }
-             }
-             
-             if (pipe2 != -1) {
-                 passwords[userCount] = "";
-                 for (int i = pipe1 + 1; i < pipe2; i++) {
-                     passwords[userCount] += line[i];
-                 }
-                 
-                 emails[userCount] = "";
-                 for (int i = pipe2 + 1; i < (int)line.length(); i++) {
-                     emails[userCount] += line[i];
-                 }
-                 userCount++;
-             }
+         // An odd generation is a tombstone, its slot goes back on the free list
+         if (userGenerations[userCount] % 2 == 1) {
+             clearUserRow(userCount, usernames, passwords, emails);
+             userFreeList[userFreeCount] = userCount;
+             userFreeCount++;
+             userCount++;
+             continue;
          }
+         
+         usernames[userCount].assign(line, starts[0], ends[0] - starts[0]);
+         passwords[userCount].assign(line, starts[1], ends[1] - starts[1]);
+         emails[userCount].assign(line, starts[2], ends[2] - starts[2]);
+         userCount++;
      }
      
      file.close();
  }
  
- void saveUsersToTXT(string usernames[], string passwords[], string emails[], int userCount) {
+ long long saveUsersToTXT(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                          int userCount) {
      ofstream file("users.txt");
      
+     // Tombstones are written too so the slot numbers inside ticket handles stay put
      for (int i = 0; i < userCount; i++) {
-         file << usernames[i] << "|" << passwords[i] << "|" << emails[i] << endl;
+         file << usernames[i] << "|" << passwords[i] << "|" << emails[i] << "|" 
+              << to_string(userGenerations[i]) << endl;
      }
      
+     long long bytes = file ? (long long)file.tellp() : 0;
      file.close();
+     return bytes;
  }
  
- void loadEventsFromTXT(string eventNames[], string eventDates[], string eventVenues[], 
+ void loadEventsFromTXT(string eventNames[], int eventDates[], string eventVenues[], 
                         string eventCategories[], double eventPrices[], int eventCapacities[], 
-                        int eventAvailable[], int& eventCount) {
-     ifstream file("events.txt");
-     
-     if (!file.is_open()) {
-         return;
-     }
-     
+                        int eventAvailable[], int eventGenerations[], int eventFreeList[], 
+                        int& eventFreeCount, int& eventCount) {
      eventCount = 0;
+     eventFreeCount = 0;
+     
+     // events.idx (eventCount|partition size, then the bytes of every partition) lists the partition files,
+     // without it the events are still in the single events.txt written before partitioning
+     ifstream manifest("events.idx");
      string line;
-     while (eventCount < getMaxEvents() && getline(file, line)) {
-         // Parse TXT: name|date|venue|category|price|capacity|available
-         int pipes[6];
-         int pipeIndex = 0;
-         
-         for (int i = 0; i < (int)line.length() && pipeIndex < 6; i++) {
-             if (line[i] == '|') {
-                 pipes[pipeIndex] = i;
-                 pipeIndex++;
-             }
-         }
-         
-         if (pipeIndex == 6) {
-             // Extract name
-             eventNames[eventCount] = "";
-             for (int i = 0; i < pipes[0]; i++) {
-                 eventNames[eventCount] += line[i];
-             }
-             
-             // Extract date
-             eventDates[eventCount] = "";
-             for (int i = pipes[0] + 1; i < pipes[1]; i++) {
-                 eventDates[eventCount] += line[i];
-             }
-             
-             // Extract venue
-             eventVenues[eventCount] = "";
-             for (int i = pipes[1] + 1; i < pipes[2]; i++) {
-                 eventVenues[eventCount] += line[i];
+     int bar = -1;
+     if (manifest.is_open() && getline(manifest, line)) {
+         bar = (int)line.find('|');
+     }
+     // Both header fields must be plain digits, anything else reads as no manifest instead of throwing
+     if (bar > 0 && isDigitColumn(line, 0, bar, 9) && isDigitColumn(line, bar + 1, (int)line.length(), 9)) {
+         // Read with the partition size the files were written with, the next save switches to the current one
+         int count = min(readIntColumn(line, 0, bar), getMaxEvents());
+         int partitionSize = readIntColumn(line, bar + 1, (int)line.length());
+         if (partitionSize > 0) {
+             long long bytes = 0;
+             while (getline(manifest, line)) {
+                 if (isDigitColumn(line, 0, (int)line.length(), 18)) {
+                     bytes += stoll(line);
+                 }
              }
              
-             // Extract category
-             eventCategories[eventCount] = "";
-             for (int i = pipes[2] + 1; i < pipes[3]; i++) {
-                 eventCategories[eventCount] += line[i];
+             // Slots a partition file is missing rows for stay tombstones
+             for (int i = 0; i < count; i++) {
+                 clearEventRow(i, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                               eventCapacities, eventAvailable);
+                 eventGenerations[i] = 1;
              }
              
-             // Extract price
-             string priceStr = "";
-             for (int i = pipes[3] + 1; i < pipes[4]; i++) {
-                 priceStr += line[i];
+             // Partitions are independent files, each worker parses a contiguous block of them
+             int partitions = (count + partitionSize - 1) / partitionSize;
+             int workers = max(min(getLoadThreadCount(bytes), partitions), 1);
+             thread workerThreads[getMaxLoadThreads()];
+             for (int k = 1; k < workers; k++) {
+                 workerThreads[k] = thread(loadEventPartitionRange, partitions * k / workers, 
+                                           partitions * (k + 1) / workers, partitionSize, count, eventNames, 
+                                           eventDates, eventVenues, eventCategories, eventPrices, 
+                                           eventCapacities, eventAvailable, eventGenerations);
              }
-             eventPrices[eventCount] = stod(priceStr);
-             
-             // Extract capacity
-             string capStr = "";
-             for (int i = pipes[4] + 1; i < pipes[5]; i++) {
-                 capStr += line[i];
+             loadEventPartitionRange(0, partitions / workers, partitionSize, count, eventNames, eventDates, 
+                                     eventVenues, eventCategories, eventPrices, eventCapacities, 
+                                     eventAvailable, eventGenerations);
+             for (int k = 1; k < workers; k++) {
+                 workerThreads[k].join();
              }
-             eventCapacities[eventCount] = stoi(capStr);
-             
-             // Extract available
-             string availStr = "";
-             for (int i = pipes[5] + 1; i < (int)line.length(); i++) {
-                 availStr += line[i];
+             eventCount = count;
+         }
+     } else {
+         ifstream file("events.txt");
+         
+         if (!file.is_open()) {
+             return;
+         }
+         
+         while (eventCount < getMaxEvents() && getline(file, line)) {
+             if (parseEventLine(line, eventCount, eventNames, eventDates, eventVenues, eventCategories, 
+                                eventPrices, eventCapacities, eventAvailable, eventGenerations)) {
+                 eventCount++;
              }
-             eventAvailable[eventCount] = stoi(availStr);
-             
-             eventCount++;
          }
+         
+         file.close();
      }
      
-     file.close();
- }
- 
- void saveEventsToTXT(string eventNames[], string eventDates[], string eventVenues[], 
-                      string eventCategories[], double eventPrices[], int eventCapacities[], 
-                      int eventAvailable[], int eventCount) {
-     ofstream file("events.txt");
-     //t0_string is converting event price to string which was in double. When we will read from the file we will use stoi()function to convert from string to integer or stod().
+     // An odd generation is a tombstone, its slot goes back on the free list
      for (int i = 0; i < eventCount; i++) {
-         file << eventNames[i] << "|" << eventDates[i] << "|" << eventVenues[i] << "|"
-              << eventCategories[i] << "|" << to_string(eventPrices[i]) << "|"
-              << to_string(eventCapacities[i]) << "|" << to_string(eventAvailable[i]) << endl;
+         if (eventGenerations[i] % 2 == 1) {
+             eventFreeList[eventFreeCount] = i;
+             eventFreeCount++;
+         }
      }
      
-     file.close();
+     // Bookings since the last full save only updated events.avail
+     loadSeatRecords(eventAvailable, eventGenerations, eventCount);
  }
  
- void loadTicketsFromTXT(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                         int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                         string ticketDates[], int& ticketCount) {
-     ifstream file("tickets.txt");
+ bool parseEventLine(string line, int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[]) {
+     // Parse TXT: name|date|venue|category|price|capacity|available|generation
+     // Files written before generations were stored have no eighth field and load as generation 0
+     int starts[getEventColumnCount()];
+     int ends[getEventColumnCount()];
+     int columns = splitColumns(line, starts, ends, getEventColumnCount());
+     if (columns != 7 && columns != 8) {
+         return false;
+     }
+     eventGenerations[slot] = columns == 8 ? readIntColumn(line, starts[7], ends[7]) : 0;
      
-     if (!file.is_open()) {
-         return;
+     // A tombstone keeps its slot with empty fields
+     if (eventGenerations[slot] % 2 == 1) {
+         clearEventRow(slot, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                       eventCapacities, eventAvailable);
+         return true;
      }
      
-     ticketCount = 0;
-     string line;
-     while (ticketCount < getMaxTickets() && getline(file, line)) {
-         // Parse TXT: ticketID|username|email|eventID|quantity|cost|date
-         int pipes[6];
-         int pipeIndex = 0;
-         
-         for (int i = 0; i < (int)line.length() && pipeIndex < 6; i++) {
-             if (line[i] == '|') {
-                 pipes[pipeIndex] = i;
-                 pipeIndex++;
-             }
-         }
-         
-         if (pipeIndex == 6) {
-             // Extract ticketID
-             string idStr = "";
-             for (int i = 0; i < pipes[0]; i++) {
-                 idStr += line[i];
-             }
-             ticketIDs[ticketCount] = stoi(idStr);
-             
-             // Extract username
-             ticketUsernames[ticketCount] = "";
-             for (int i = pipes[0] + 1; i < pipes[1]; i++) {
-                 ticketUsernames[ticketCount] += line[i];
-             }
-             
-             // Extract email
-             ticketEmails[ticketCount] = "";
-             for (int i = pipes[1] + 1; i < pipes[2]; i++) {
-                 ticketEmails[ticketCount] += line[i];
-             }
-             
-             // Extract eventID
-             string eventIDStr = "";
-             for (int i = pipes[2] + 1; i < pipes[3]; i++) {
-                 eventIDStr += line[i];
-             }
-             ticketEventIDs[ticketCount] = stoi(eventIDStr);
-             
-             // Extract quantity
-             string qtyStr = "";
-             for (int i = pipes[3] + 1; i < pipes[4]; i++) {
-                 qtyStr += line[i];
-             }
-             ticketQuantities[ticketCount] = stoi(qtyStr);
-             
-             // Extract cost
-             string costStr = "";
-             for (int i = pipes[4] + 1; i < pipes[5]; i++) {
-                 costStr += line[i];
-             }
-             ticketCosts[ticketCount] = stod(costStr);
-             
-             // Extract date
-             ticketDates[ticketCount] = "";
-             for (int i = pipes[5] + 1; i < (int)line.length(); i++) {
-                 ticketDates[ticketCount] += line[i];
+     // The string columns are assigned straight out of the line, the numbers are read in place
+     eventNames[slot].assign(line, starts[0], ends[0] - starts[0]);
+     eventDates[slot] = readDateColumn(line, starts[1], ends[1]);
+     eventVenues[slot].assign(line, starts[2], ends[2] - starts[2]);
+     eventCategories[slot].assign(line, starts[3], ends[3] - starts[3]);
+     eventPrices[slot] = readDoubleColumn(line, starts[4], ends[4]);
+     eventCapacities[slot] = readIntColumn(line, starts[5], ends[5]);
+     eventAvailable[slot] = readIntColumn(line, starts[6], ends[6]);
+     
+     return true;
+ }
+ 
+ void loadEventPartitionRange(int firstPartition, int lastPartition, int partitionSize, int eventCount, 
+                              string eventNames[], int eventDates[], string eventVenues[], 
+                              string eventCategories[], double eventPrices[], int eventCapacities[], 
+                              int eventAvailable[], int eventGenerations[]) {
+     // Line j of events_k.txt is slot k * partitionSize + j
+     for (int k = firstPartition; k < lastPartition; k++) {
+         ifstream file(getEventPartitionFileName(k));
+         int slot = k * partitionSize;
+         int end = min(slot + partitionSize, eventCount);
+         string line;
+         while (slot < end && getline(file, line)) {
+             if (!parseEventLine(line, slot, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                 eventCapacities, eventAvailable, eventGenerations)) {
+                 eventGenerations[slot] = 1;
              }
-             
-             ticketCount++;
+             slot++;
          }
      }
-     
-     file.close();
  }
  
- void saveTicketsToTXT(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                       int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                       string ticketDates[], int ticketCount) {
-     ofstream file("tickets.txt");
+ long long saveEventsToTXT(string eventNames[], int eventDates[], string eventVenues[], 
+                           string eventCategories[], double eventPrices[], int eventCapacities[], 
+                           int eventAvailable[], int eventGenerations[], unsigned long long eventSeatMaps[], 
+                           int eventCount, int dirtyPartitions[]) {
+     // Only dirty partitions are rewritten, and any whose file is missing, so the first save after the
+     // single events.txt writes them all. Files cut at another partition size are all rewritten
+     string header = "";
+     ifstream previous("events.idx");
+     getline(previous, header);
+     previous.close();
+     bool sameLayout = header.substr(header.find('|') + 1) == to_string(getEventPartitionSize());
      
-     for (int i = 0; i < ticketCount; i++) {
-         file << to_string(ticketIDs[i]) << "|" << ticketUsernames[i] << "|" 
-              << ticketEmails[i] << "|" << to_string(ticketEventIDs[i]) << "|"
-              << to_string(ticketQuantities[i]) << "|" << to_string(ticketCosts[i]) 
-              << "|" << ticketDates[i] << endl;
+     int partitions = (eventCount + getEventPartitionSize() - 1) / getEventPartitionSize();
+     long long bytes = 0;
+     string sizes = "";
+     for (int k = 0; k < partitions; k++) {
+         long long size = getFileSize(getEventPartitionFileName(k));
+         if (dirtyPartitions[k] || size < 0 || !sameLayout) {
+             ofstream file(getEventPartitionFileName(k));
+             int end = min((k + 1) * getEventPartitionSize(), eventCount);
+             for (int i = k * getEventPartitionSize(); i < end; i++) {
+                 file << formatEventLine(i, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                         eventCapacities, eventAvailable, eventGenerations, eventCount) << endl;
+             }
+             size = file ? (long long)file.tellp() : 0;
+             bytes += size;
+             file.close();
+         }
+         sizes += to_string(size) + "\n";
+     }
+     for (int k = partitions; remove(getEventPartitionFileName(k).c_str()) == 0; k++) {
      }
      
-     file.close();
- }
- 
- // Validation Functions
- bool isUsernameUnique(string username, string usernames[], int userCount) {
-     for (int i = 0; i < userCount; i++) {
-         if (usernames[i] == username) {
-             return false;
+     // Written once the partitions are complete, a crash before this leaves the previous layout readable
+     ofstream manifest("events.idx.tmp");
+     manifest << eventCount << "|" << getEventPartitionSize() << "\n" << sizes;
+     bytes += manifest ? (long long)manifest.tellp() : 0;
+     manifest.close();
+     replaceFile("events.idx.tmp", "events.idx");
+     remove("events.txt");
+     
+     // Seat counts and seat maps have one fixed-width record per slot, a dirty partition overwrites its run
+     // of records in place unless the files no longer hold one record per slot
+     bool inPlace = sameLayout && getFileSize("events.avail") == (long long)eventCount * getSeatRecordWidth() && 
+                    getFileSize("events.seats") == (long long)eventCount * getSeatMapRecordWidth();
+     fstream seats("events.avail", inPlace ? (ios::in | ios::out | ios::binary) : (ios::out | ios::binary));
+     fstream seatMaps("events.seats", inPlace ? (ios::in | ios::out | ios::binary) : (ios::out | ios::binary));
+     for (int k = 0; k < partitions; k++) {
+         if (inPlace && !dirtyPartitions[k]) {
+             continue;
+         }
+         int first = k * getEventPartitionSize();
+         int end = min(first + getEventPartitionSize(), eventCount);
+         seats.seekp((long long)first * getSeatRecordWidth());
+         seatMaps.seekp((long long)first * getSeatMapRecordWidth());
+         for (int i = first; i < end; i++) {
+             seats << formatSeatRecord(isSlotLive(i, eventGenerations, eventCount) ? eventAvailable[i] : 0);
+             seatMaps << formatSeatMapRecord(eventSeatMaps + i * getMaxSeatRows());
          }
+         bytes += (long long)(end - first) * (getSeatRecordWidth() + getSeatMapRecordWidth());
      }
-     return true;
+     seats.close();
+     seatMaps.close();
+     return bytes;
  }
  
- bool isValidEmail(string email) {
-     int atPos = -1;
-     int dotPos = -1;
-     
-     for (int i = 0; i < (int)email.length(); i++) {
-         if (email[i] == '@') {
-             atPos = i;
-         }
-         if (email[i] == '.' && atPos != -1) {
-             dotPos = i;
-         }
+ string formatEventLine(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                        string eventCategories[], double eventPrices[], int eventCapacities[], 
+                        int eventAvailable[], int eventGenerations[], int eventCount) {
+     // Tombstones keep their line with empty fields so later slots do not move
+     if (!isSlotLive(slot, eventGenerations, eventCount)) {
+         return "|||||||" + to_string(eventGenerations[slot]);
      }
-     
-     return (atPos > 0 && dotPos > atPos + 1 && dotPos < (int)email.length() - 1);
+     return eventNames[slot] + "|" + formatDate(eventDates[slot]) + "|" + eventVenues[slot] + "|" + 
+            eventCategories[slot] + "|" + to_string(eventPrices[slot]) + "|" + to_string(eventCapacities[slot]) + 
+            "|" + to_string(eventAvailable[slot]) + "|" + to_string(eventGenerations[slot]);
  }
  
- bool isValidNumber(string input) {
-     if ((int)input.length() == 0) return false;
-     
-     for (int i = 0; i < (int)input.length(); i++) {
-         if (input[i] < '0' || input[i] > '9') {
-             if (i == 0 && input[i] == '-') continue;
-             if (input[i] == '.' && i > 0) continue;
-             return false;
-         }
+ string getEventPartitionFileName(int partition) {
+     return "events_" + to_string(partition) + ".txt";
+ }
+ 
+ string getTicketPartitionFileName(int partition) {
+     return "tickets_" + to_string(partition) + ".txt";
+ }
+ 
+ long long getFileSize(string filename) {
+     // -1 when the file does not exist
+     ifstream file(filename, ios::binary | ios::ate);
+     return file.is_open() ? (long long)file.tellg() : -1;
+ }
+ 
+ bool replaceFile(string temporary, string target) {
+     // rename() swaps the finished file in at once, so a reader (a follower reloading, say) sees the old
+     // contents or the new ones and never a half written file. Windows will not rename over an existing file
+     if (rename(temporary.c_str(), target.c_str()) == 0) {
+         return true;
      }
-     return true;
+     remove(target.c_str());
+     return rename(temporary.c_str(), target.c_str()) == 0;
  }
  
- int getValidInteger(string prompt) {
-     string input;
-     int value;
-     
-     cout << bright_yellow << prompt << reset;
-     cin >> input;
-     
-     while (!isValidNumber(input)) {
-         clearInputBuffer();
-         cout << bright_red << "Invalid input! Enter a valid number: " << reset;
-         cin >> input;
+ string formatSeatRecord(int available) {
+     string digits = to_string(max(available, 0));
+     while ((int)digits.length() < getSeatRecordWidth() - 1) {
+         digits = "0" + digits;
      }
-     
-     value = stoi(input);
-     return value;
+     return digits + "\n";
  }
  
- double getValidDouble(string prompt) {
-     string input;
-     double value;
-     
-     cout << bright_yellow << prompt << reset;
-     cin >> input;
-     
-     bool valid = true;
-     int dotCount = 0;
+ void loadSeatRecords(int eventAvailable[], int eventGenerations[], int eventCount) {
+     ifstream seats("events.avail", ios::binary | ios::ate);
      
-     for (int i = 0; i < (int)input.length(); i++) {
-         if (input[i] == '.') {
-             dotCount++;
-             if (dotCount > 1) {
-                 valid = false;
-                 break;
-             }
-         } else if (input[i] < '0' || input[i] > '9') {
-             if (i == 0 && input[i] == '-') continue;
-             valid = false;
-             break;
-         }
+     // Only trust the file when it has exactly one record per slot in events.txt
+     if (!seats.is_open() || (long long)seats.tellg() != (long long)eventCount * getSeatRecordWidth()) {
+         return;
      }
+     seats.seekg(0);
      
-     while (!valid) {
-         clearInputBuffer();
-         cout << bright_red << "Invalid input! Enter a valid number: " << reset;
-         cin >> input;
-         valid = true;
-         dotCount = 0;
-         for (int i = 0; i < (int)input.length(); i++) {
-             if (input[i] == '.') {
-                 dotCount++;
-                 if (dotCount > 1) {
-                     valid = false;
-                     break;
-                 }
-             } else if (input[i] < '0' || input[i] > '9') {
-                 if (i == 0 && input[i] == '-') continue;
-                 valid = false;
-                 break;
-             }
+     string record(getSeatRecordWidth(), ' ');
+     for (int i = 0; i < eventCount; i++) {
+         seats.read(&record[0], getSeatRecordWidth());
+         if (isSlotLive(i, eventGenerations, eventCount) && isDigitColumn(record, 0, getSeatRecordWidth() - 1, 9)) {
+             eventAvailable[i] = readIntColumn(record, 0, getSeatRecordWidth() - 1);
          }
      }
-     
-     value = stod(input);
-     return value;
- }
- 
- void clearInputBuffer() {
-     cin.clear();
-     cin.ignore(numeric_limits<streamsize>::max(), '\n');
- }
- 
- // Utility Functions
- string getCurrentDate() {
-     // Simple date format - can be enhanced
-     return "17-12-2025";
  }
  
- // Constants Functions (Replaced global variables)
- const int getMaxUsers() {
-     return 100;
- }
- 
- const int getMaxEvents() {
-     return 100;
- }
- 
- const int getMaxTickets() {
-     return 500;
- }
- 
- string getAdminUsername() {
-     return "admin";
+ long long writeSeatRecord(int eventIndex, int available) {
+     fstream seats("events.avail", ios::in | ios::out | ios::binary);
+     
+     if (!seats.is_open()) {
+         return 0;
+     }
+     
+     // One positioned write in place of rewriting events.txt
+     seats.seekp((long long)eventIndex * getSeatRecordWidth());
+     seats << formatSeatRecord(available);
+     return seats ? getSeatRecordWidth() : 0;
  }
  
- string getAdminPassword() {
-     return "admin123";
+ string formatSeatMapRecord(unsigned long long rowWords[]) {
+     const char* hexDigits = "0123456789abcdef";
+     string record(getSeatMapRecordWidth(), '0');
+     for (int row = 0; row < getMaxSeatRows(); row++) {
+         for (int digit = 0; digit < 16; digit++) {
+             record[row * 16 + digit] = hexDigits[(rowWords[row] >> (60 - digit * 4)) & 15];
+         }
+     }
+     record[getSeatMapRecordWidth() - 1] = '\n';
+     return record;
  }
  
- // Event Management Functions
- string addEvent(string name, string date, string venue, string category, double price, 
-                 int capacity, string eventNames[], string eventDates[], string eventVenues[], 
-                 string eventCategories[], double eventPrices[], int eventCapacities[], 
-                 int eventAvailable[], int& eventCount) {
-     if (eventCount >= getMaxEvents()) {
-         return "Event limit reached!";
+ void loadSeatMaps(unsigned long long eventSeatMaps[], int eventGenerations[], int eventCount) {
+     for (int i = 0; i < getMaxEvents() * getMaxSeatRows(); i++) {
+         eventSeatMaps[i] = 0;
      }
      
-     eventNames[eventCount] = name;
-     eventDates[eventCount] = date;
-     eventVenues[eventCount] = venue;
-     eventCategories[eventCount] = category;
-     eventPrices[eventCount] = price;
-     eventCapacities[eventCount] = capacity;
-     eventAvailable[eventCount] = capacity;
-     eventCount++;
+     ifstream seatMaps("events.seats", ios::binary | ios::ate);
      
-     return "Event added successfully!";
- }
- 
- string viewAllEvents(string eventNames[], string eventDates[], string eventVenues[], 
-                      string eventCategories[], double eventPrices[], int eventCapacities[], 
-                      int eventAvailable[], int eventCount) {
-     if (eventCount == 0) {
-         return "\nNo events available!";
+     // Same rule as events.avail: one record per slot or the file is ignored and every seat starts free
+     if (!seatMaps.is_open() || (long long)seatMaps.tellg() != (long long)eventCount * getSeatMapRecordWidth()) {
+         return;
      }
+     seatMaps.seekg(0);
      
-     string result = "\n========== ALL EVENTS ==========\n";
-     
+     string record(getSeatMapRecordWidth(), ' ');
      for (int i = 0; i < eventCount; i++) {
-         result += "\nEvent #" + to_string(i + 1) + "\n";
-         result += "Name: " + eventNames[i] + "\n";
-         result += "Date: " + eventDates[i] + "\n";
-         result += "Venue: " + eventVenues[i] + "\n";
-         result += "Category: " + eventCategories[i] + "\n";
-         result += "Price: $" + to_string(eventPrices[i]) + "\n";
-         result += "Capacity: " + to_string(eventCapacities[i]) + "\n";
-         result += "Available: " + to_string(eventAvailable[i]) + "\n";
-         result += "--------------------------------\n";
+         seatMaps.read(&record[0], getSeatMapRecordWidth());
+         if (!isSlotLive(i, eventGenerations, eventCount)) {
+             continue;
+         }
+         for (int row = 0; row < getMaxSeatRows(); row++) {
+             eventSeatMaps[i * getMaxSeatRows() + row] = strtoull(record.substr(row * 16, 16).c_str(), NULL, 
+             16);
+         }
      }
-     
-     return result;
  }
  
- string updateEvent(int index, string name, string date, string venue, string category, 
-                    double price, int capacity, int available, string eventNames[], 
-                    string eventDates[], string eventVenues[], string eventCategories[], 
-                    double eventPrices[], int eventCapacities[], int eventAvailable[]) {
-     if (index < 0) {
-         return "Invalid event index!";
-     }
+ long long writeSeatMapRecord(int eventIndex, unsigned long long rowWords[]) {
+     fstream seatMaps("events.seats", ios::in | ios::out | ios::binary);
      
-     eventNames[index] = name;
-     eventDates[index] = date;
-     eventVenues[index] = venue;
-     eventCategories[index] = category;
-     eventPrices[index] = price;
-     eventCapacities[index] = capacity;
-     eventAvailable[index] = available;
+     if (!seatMaps.is_open()) {
+         return 0;
+     }
      
-     return "Event updated successfully!";
+     seatMaps.seekp((long long)eventIndex * getSeatMapRecordWidth());
+     seatMaps << formatSeatMapRecord(rowWords);
+     return seatMaps ? getSeatMapRecordWidth() : 0;
  }
  
- string deleteEvent(int index, string eventNames[], string eventDates[], string eventVenues[], 
-                    string eventCategories[], double eventPrices[], int eventCapacities[], 
-                    int eventAvailable[], int& eventCount) {
-     if (index < 0 || index >= eventCount) {
-         return "Invalid event index!";
+ void loadWaitlistFromTXT(int waitlistUserIDs[], int waitlistQuantities[], int waitlistHeads[], 
+                          int waitlistSizes[], int eventGenerations[], int eventCount) {
+     for (int i = 0; i < getMaxEvents() * getWaitlistCapacity(); i++) {
+         waitlistUserIDs[i] = -1;
+         waitlistQuantities[i] = 0;
      }
-     
-     for (int i = index; i < eventCount - 1; i++) {
-         eventNames[i] = eventNames[i + 1];
-         eventDates[i] = eventDates[i + 1];
-         eventVenues[i] = eventVenues[i + 1];
-         eventCategories[i] = eventCategories[i + 1];
-         eventPrices[i] = eventPrices[i + 1];
-         eventCapacities[i] = eventCapacities[i + 1];
-         eventAvailable[i] = eventAvailable[i + 1];
+     for (int i = 0; i < getMaxEvents(); i++) {
+         waitlistHeads[i] = 0;
+         waitlistSizes[i] = 0;
      }
      
-     eventCount--;
-     return "Event deleted successfully!";
- }
- 
- string searchEventByName(string name, string eventNames[], string eventDates[], 
-                          string eventVenues[], string eventCategories[], double eventPrices[], 
-                          int eventCapacities[], int eventAvailable[], int eventCount) {
-     bool found = false;
-     string result = "\n========== SEARCH RESULTS ==========\n";
+     ifstream file("waitlist.txt");
+     if (!file.is_open()) {
+         return;
+     }
      
-     for (int i = 0; i < eventCount; i++) {
-         if ((int)eventNames[i].find(name) != -1) {
-             found = true;
-             result += "\nEvent #" + to_string(i + 1) + "\n";
-             result += "Name: " + eventNames[i] + "\n";
-             result += "Date: " + eventDates[i] + "\n";
-             result += "Venue: " + eventVenues[i] + "\n";
-             result += "Category: " + eventCategories[i] + "\n";
-             result += "Price: $" + to_string(eventPrices[i]) + "\n";
-             result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
-             result += "--------------------------------\n";
+     // Rows are eventHandle|userHandle|quantity in queue order, rows of deleted events are dropped
+     string line;
+     while (getline(file, line)) {
+         int first = (int)line.find('|');
+         int second = (int)line.find('|', first + 1);
+         if (first == -1 || second == -1) {
+             continue;
+         }
+         string eventStr = line.substr(0, first);
+         string userStr = line.substr(first + 1, second - first - 1);
+         string quantityStr = line.substr(second + 1);
+         if (!isValidNumber(eventStr) || !isValidNumber(userStr) || !isValidNumber(quantityStr)) {
+             continue;
+         }
+         int eventIndex = resolveHandle(stoi(eventStr), eventGenerations, eventCount);
+         if (eventIndex == -1 || waitlistSizes[eventIndex] == getWaitlistCapacity()) {
+             continue;
          }
+         int position = eventIndex * getWaitlistCapacity() + waitlistSizes[eventIndex];
+         waitlistUserIDs[position] = stoi(userStr);
+         waitlistQuantities[position] = stoi(quantityStr);
+         waitlistSizes[eventIndex]++;
      }
      
-     if (!found) {
-         return "\nNo events found with that name!";
+     file.close();
+ }
+ 
+ long long saveWaitlistToTXT(int waitlistEventIDs[], int waitlistUserIDs[], int waitlistQuantities[], 
+                             int waitlistRows) {
+     ofstream file("waitlist.txt");
+     for (int i = 0; i < waitlistRows; i++) {
+         file << to_string(waitlistEventIDs[i]) << "|" << to_string(waitlistUserIDs[i]) << "|" 
+              << to_string(waitlistQuantities[i]) << endl;
      }
      
-     return result;
+     long long bytes = file ? (long long)file.tellp() : 0;
+     file.close();
+     return bytes;
  }
  
- string searchEventByCategory(string category, string eventNames[], string eventDates[], 
-                              string eventVenues[], string eventCategories[], double eventPrices[], 
-                              int eventCapacities[], int eventAvailable[], int eventCount) {
-     bool found = false;
-     string result = "\n========== SEARCH RESULTS ==========\n";
+ void loadTicketsFromTXT(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                         double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                         int ticketTiers[], int& ticketCount, string usernames[], int userGenerations[], 
+                         int userCount) {
+     ifstream file("tickets.txt", ios::binary | ios::ate);
      
-     for (int i = 0; i < eventCount; i++) {
-         if ((int)eventCategories[i].find(category) != -1) {
-             found = true;
-             result += "\nEvent #" + to_string(i + 1) + "\n";
-             result += "Name: " + eventNames[i] + "\n";
-             result += "Date: " + eventDates[i] + "\n";
-             result += "Venue: " + eventVenues[i] + "\n";
-             result += "Category: " + eventCategories[i] + "\n";
-             result += "Price: $" + to_string(eventPrices[i]) + "\n";
-             result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
-             result += "--------------------------------\n";
+     // Without the single tickets.txt from before partitioning, read whatever partitions exist in order.
+     // Only a missing or stale tickets.idx gets here, otherwise they are paged in a partition at a time
+     if (!file.is_open()) {
+         ticketCount = 0;
+         string line;
+         for (int k = 0; ticketCount < getMaxTickets(); k++) {
+             ifstream partition(getTicketPartitionFileName(k));
+             if (!partition.is_open()) {
+                 break;
+             }
+             while (ticketCount < getMaxTickets() && getline(partition, line)) {
+                 if (parseTicketLine(line, ticketCount, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                     ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketSeats, 
+                                     ticketTiers, usernames, userGenerations, userCount)) {
+                     ticketCount++;
+                 }
+             }
          }
+         return;
      }
      
-     if (!found) {
-         return "\nNo events found in that category!";
+     // Split the file into byte ranges that each start right after a newline, one per worker
+     long long size = (long long)file.tellg();
+     int workers = getLoadThreadCount(size);
+     long long bounds[getMaxLoadThreads() + 1];
+     bounds[0] = 0;
+     bounds[workers] = size;
+     for (int k = 1; k < workers; k++) {
+         file.clear();
+         file.seekg(size * k / workers - 1);
+         file.ignore(numeric_limits<streamsize>::max(), '\n');
+         bounds[k] = file.eof() ? size : max(bounds[k - 1], (long long)file.tellg());
      }
+     file.close();
      
-     return result;
- }
- 
- // User Management Functions
- string addUser(string username, string password, string email, string usernames[], 
-                string passwords[], string emails[], int& userCount) {
-     if (userCount >= getMaxUsers()) {
-         return "User limit reached!";
+     // Pass 1: count the lines in every other range, so each worker knows the first slot its rows go to
+     int lineCounts[getMaxLoadThreads()];
+     thread workerThreads[getMaxLoadThreads()];
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k] = thread(countTicketLines, bounds[k - 1], bounds[k], ref(lineCounts[k - 1]));
      }
-     
-     usernames[userCount] = username;
-     passwords[userCount] = password;
-     emails[userCount] = email;
-     userCount++;
-     
-     return "User added successfully!";
- }
- 
- string deleteUser(int index, string usernames[], string passwords[], string emails[], int& userCount) {
-     if (index < 0 || index >= userCount) {
-         return "Invalid user index!";
+     int firstPositions[getMaxLoadThreads()];
+     firstPositions[0] = 0;
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k].join();
+         firstPositions[k] = firstPositions[k - 1] + lineCounts[k - 1];
      }
      
-     for (int i = index; i < userCount - 1; i++) {
-         usernames[i] = usernames[i + 1];
-         passwords[i] = passwords[i + 1];
-         emails[i] = emails[i + 1];
+     // Pass 2: every worker parses its range straight into its own slots of the shared arrays
+     int rejected[getMaxLoadThreads()];
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k] = thread(parseTicketRange, bounds[k], bounds[k + 1], firstPositions[k], ticketIDs, 
+                                   ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, 
+                                   ticketHours, ticketSeats, ticketTiers, usernames, userGenerations, 
+                                   userCount, ref(lineCounts[k]), ref(rejected[k]));
      }
-     
-     userCount--;
-     return "User deleted successfully!";
- }
- 
- string viewAllUsers(string usernames[], string emails[], int userCount) {
-     // This function is kept for compatibility but colors are added at call sites
-     if (userCount == 0) {
-         return "\nNo users registered!";
+     parseTicketRange(bounds[0], bounds[1], 0, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                      ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, usernames, 
+                      userGenerations, userCount, lineCounts[0], rejected[0]);
+     int rejectedTotal = rejected[0];
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k].join();
+         rejectedTotal += rejected[k];
      }
      
-     string result = "\n========== ALL USERS ==========\n";
-     
-     for (int i = 0; i < userCount; i++) {
-         result += "\nUser #" + to_string(i + 1) + "\n";
-         result += "Username: " + usernames[i] + "\n";
-         result += "Email: " + emails[i] + "\n";
-         result += "--------------------------------\n";
+     // Merge: rows that did not parse left a hole (ID -1), close them up keeping file order
+     int total = min(firstPositions[workers - 1] + lineCounts[workers - 1], getMaxTickets());
+     if (rejectedTotal == 0) {
+         ticketCount = total;
+         return;
      }
-     
-     return result;
- }
- 
- int findUserIndex(string username, string usernames[], int userCount) {
-     for (int i = 0; i < userCount; i++) {
-         if (usernames[i] == username) {
-             return i;
+     ticketCount = 0;
+     for (int i = 0; i < total; i++) {
+         if (ticketIDs[i] == -1) {
+             continue;
          }
+         moveTicketRow(i, ticketCount, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                       ticketDates, ticketHours, ticketSeats, ticketTiers);
+         ticketCount++;
      }
-     return -1;
  }
  
- string getUserEmail(string username, string usernames[], string emails[], int userCount) {
-     int index = findUserIndex(username, usernames, userCount);
-     if (index != -1) {
-         return emails[index];
+ long long saveTicketsToTXT(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                            int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                            int ticketHours[], int ticketSeats[], int ticketTiers[], int ticketCount, 
+                            int firstDirty) {
+     // tickets_k.txt holds tickets k * getTicketSegmentSize() onwards. Only partitions holding a ticket at or
+     // past firstDirty are rewritten, and any whose file is missing, so a booking touches the last one only
+     string header = "";
+     ifstream previous("tickets.idx");
+     getline(previous, header);
+     previous.close();
+     bool sameLayout = header.substr(header.find('|') + 1) == to_string(getTicketSegmentSize());
+     
+     // Note the size and ticket ID range of every partition for tickets.idx
+     int partitions = (ticketCount + getTicketSegmentSize() - 1) / getTicketSegmentSize();
+     long long bytes = 0;
+     string segments = "";
+     for (int k = 0; k < partitions; k++) {
+         int first = k * getTicketSegmentSize();
+         int end = min(first + getTicketSegmentSize(), ticketCount);
+         int minID = ticketIDs[first];
+         int maxID = ticketIDs[first];
+         for (int i = first + 1; i < end; i++) {
+             minID = min(minID, ticketIDs[i]);
+             maxID = max(maxID, ticketIDs[i]);
+         }
+         
+         long long size = getFileSize(getTicketPartitionFileName(k));
+         if (end > firstDirty || size < 0 || !sameLayout) {
+             ofstream file(getTicketPartitionFileName(k));
+             for (int i = first; i < end; i++) {
+                 file << formatTicketLine(i, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                 ticketCosts, 
+                                          ticketDates, ticketHours, ticketSeats, ticketTiers) << endl;
+             }
+             size = file ? (long long)file.tellp() : 0;
+             bytes += size;
+             file.close();
+         }
+         segments += to_string(size) + "|" + to_string(minID) + "|" + to_string(maxID) + "\n";
      }
-     return "";
+     for (int k = partitions; remove(getTicketPartitionFileName(k).c_str()) == 0; k++) {
+     }
+     
+     // Written after the partitions are complete, the sizes let the next start spot a stale index
+     ofstream index("tickets.idx.tmp");
+     index << ticketCount << "|" << getTicketSegmentSize() << "\n" << segments;
+     long long indexBytes = index ? (long long)index.tellp() : 0;
+     index.close();
+     replaceFile("tickets.idx.tmp", "tickets.idx");
+     remove("tickets.txt");
+     return bytes + indexBytes;
  }
  
- // Ticket Management Functions
- int generateTicketID(int ticketIDs[], int ticketCount) {
-     int maxID = 1000;
-     for (int i = 0; i < ticketCount; i++) {
-         if (ticketIDs[i] > maxID) {
-             maxID = ticketIDs[i];
-         }
-     }
-     return maxID + 1;
+ string formatTicketLine(int i, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                         int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                         int ticketSeats[], int ticketTiers[]) {
+     return to_string(ticketIDs[i]) + "|" + to_string(ticketUserIDs[i]) + "|" + to_string(ticketEventIDs[i]) + "|" + 
+            to_string(ticketQuantities[i]) + "|" + compactNumber(ticketCosts[i]) + "|" + formatDate(ticketDates[i]) + 
+            "|" + to_string(ticketHours[i]) + "|" + (ticketSeats[i] < 0 ? "" : to_string(ticketSeats[i])) + "|" + 
+            to_string(ticketTiers[i]);
  }
  
- string bookTicket(string username, string email, int eventIndex, int quantity, 
-                   string eventNames[], double eventPrices[], int eventAvailable[], 
-                   int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                   int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                   string ticketDates[], int& ticketCount) {
-     if (ticketCount >= getMaxTickets()) {
-         return "Ticket limit reached!";
+ bool parseTicketLine(string line, int position, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                      int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                      int ticketSeats[], int ticketTiers[], string usernames[], int userGenerations[], 
+                      int userCount) {
+     // Parse TXT: ticketID|userHandle|eventHandle|quantity|cost|date|hour|seat|tier, the seat is empty for
+     // general admission. Files from before price tiers stop at the seat and files from before seating at
+     // the hour. Older ones store username|email instead of userHandle (with or without the hour field),
+     // those rows are migrated by looking the username up in the user table. Plain indexes from before
+     // handles existed read back as generation 0 handles.
+     int starts[getTicketColumnCount()];
+     int ends[getTicketColumnCount()];
+     int columns = splitColumns(line, starts, ends, getTicketColumnCount());
+     if (columns < 7) {
+         return false;
      }
      
-     if (eventIndex < 0) {
-         return "Invalid event index!";
+     // A legacy row is one whose third field is an email
+     bool legacy = false;
+     for (int i = starts[2]; i < ends[2]; i++) {
+         if (line[i] == '@') {
+             legacy = true;
+             break;
+         }
      }
+     int first = legacy ? 3 : 2;
      
-     if (quantity <= 0) {
-         return "Invalid quantity!";
+     ticketIDs[position] = readIntColumn(line, starts[0], ends[0]);
+     if (legacy) {
+         int userIndex = findUserIndex(line.substr(starts[1], ends[1] - starts[1]), usernames, userCount);
+         ticketUserIDs[position] = userIndex == -1 ? -1 : makeHandle(userIndex, userGenerations[userIndex]);
+     } else {
+         ticketUserIDs[position] = readIntColumn(line, starts[1], ends[1]);
      }
+     ticketEventIDs[position] = readIntColumn(line, starts[first], ends[first]);
+     ticketQuantities[position] = readIntColumn(line, starts[first + 1], ends[first + 1]);
+     ticketCosts[position] = readDoubleColumn(line, starts[first + 2], ends[first + 2]);
+     ticketDates[position] = readDateColumn(line, starts[first + 3], ends[first + 3]);
      
-     if (eventAvailable[eventIndex] < quantity) {
-         return "Not enough seats available! Available: " + to_string(eventAvailable[eventIndex]);
+     // Legacy rows written before hours were recorded get -1, rows from before assigned seating are
+     // general admission and rows from before price tiers were sold at the standard price
+     ticketHours[position] = first + 4 < columns ? readIntColumn(line, starts[first + 4], ends[first + 4]) : -1;
+     ticketSeats[position] = -1;
+     if (first + 5 < columns && ends[first + 5] > starts[first + 5]) {
+         ticketSeats[position] = readIntColumn(line, starts[first + 5], ends[first + 5]);
+     }
+     ticketTiers[position] = 1;
+     if (first + 6 < columns && ends[first + 6] > starts[first + 6]) {
+         ticketTiers[position] = readIntColumn(line, starts[first + 6], ends[first + 6]);
      }
      
-     // Create ticket
-     ticketIDs[ticketCount] = generateTicketID(ticketIDs, ticketCount);
-     ticketUsernames[ticketCount] = username;
-     ticketEmails[ticketCount] = email;
-     ticketEventIDs[ticketCount] = eventIndex;
-     ticketQuantities[ticketCount] = quantity;
-     ticketCosts[ticketCount] = eventPrices[eventIndex] * quantity;
-     ticketDates[ticketCount] = getCurrentDate();
-     
-     // Update available seats
+     return true;
+ }
+ 
+ bool loadTicketIndex(long long ticketSegmentOffsets[], int ticketSegmentMinIDs[], 
+                      int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], 
+                      int& ticketSegmentCount, int& ticketCount) {
+     // Header: ticketCount|partition size, then size|minID|maxID per tickets_N.txt partition
+     ifstream index("tickets.idx");
+     if (!index.is_open()) {
+         return false;
+     }
+     
+     string line;
+     if (!getline(index, line)) {
+         return false;
+     }
+     // The index from before partitioning has a third header field and describes tickets.txt instead.
+     // Every field is checked for plain digits first, a damaged index is treated like a missing one
+     int first = (int)line.find('|');
+     if (first == -1 || !isDigitColumn(line, 0, first, 9) || 
+         !isDigitColumn(line, first + 1, (int)line.length(), 9)) {
+         return false;
+     }
+     int count = readIntColumn(line, 0, first);
+     int segmentSize = readIntColumn(line, first + 1, (int)line.length());
+     if (count > getMaxTickets() || segmentSize != getTicketSegmentSize()) {
+         return false;
+     }
+     
+     // A partition written by anything other than saveTicketsToTXT no longer matches the index,
+     // ticketSegmentOffsets keeps where each would start in one file to size the load workers
+     int segmentCount = (count + getTicketSegmentSize() - 1) / getTicketSegmentSize();
+     long long offset = 0;
+     for (int i = 0; i < segmentCount; i++) {
+         if (!getline(index, line)) {
+             return false;
+         }
+         first = (int)line.find('|');
+         int second = first == -1 ? -1 : (int)line.find('|', first + 1);
+         if (second == -1 || !isDigitColumn(line, 0, first, 18) || !isDigitColumn(line, first + 1, second, 9) || 
+             !isDigitColumn(line, second + 1, (int)line.length(), 9)) {
+             return false;
+         }
+         long long size = stoll(line.substr(0, first));
+         if (getFileSize(getTicketPartitionFileName(i)) != size) {
+             return false;
+         }
+         ticketSegmentOffsets[i] = offset;
+         offset += size;
+         ticketSegmentMinIDs[i] = readIntColumn(line, first + 1, second);
+         ticketSegmentMaxIDs[i] = readIntColumn(line, second + 1, (int)line.length());
+         ticketSegmentLoaded[i] = false;
+     }
+     
+     ticketSegmentCount = segmentCount;
+     ticketCount = count;
+     return true;
+ }
+ 
+ void loadTicketSegment(int segment, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                        int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                        int ticketSeats[], int ticketTiers[], bool ticketSegmentLoaded[], int ticketCount, 
+                        string usernames[], int userGenerations[], int userCount) {
+     ifstream file(getTicketPartitionFileName(segment));
+     if (!file.is_open()) {
+         return;
+     }
+     
+     // Segment k holds tickets k * getTicketSegmentSize() onwards, in file order
+     int position = segment * getTicketSegmentSize();
+     int end = min(position + getTicketSegmentSize(), ticketCount);
+     string line;
+     while (position < end && getline(file, line)) {
+         if (parseTicketLine(line, position, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                             ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, usernames, 
+                             userGenerations, userCount)) {
+             position++;
+         }
+     }
+     
+     ticketSegmentLoaded[segment] = true;
+     file.close();
+ }
+ 
+ bool ensureTicketsLoaded(bool& ticketsLoaded, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                          int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                          int ticketSeats[], int ticketTiers[], long long ticketSegmentOffsets[], 
+                          bool ticketSegmentLoaded[], int ticketSegmentCount, int ticketCount, 
+                          string usernames[], int userGenerations[], int userCount) {
+     // Returns true when this call paged the store in, so the caller knows to rebuild what derives from it
+     if (ticketsLoaded) {
+         return false;
+     }
+     
+     // Segments are independent, so each worker pages in its own contiguous block of them
+     int workers = ticketSegmentCount == 0 ? 1 : 
+                   min(getLoadThreadCount(ticketSegmentOffsets[ticketSegmentCount - 1]), ticketSegmentCount);
+     thread workerThreads[getMaxLoadThreads()];
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k] = thread(loadTicketSegmentRange, ticketSegmentCount * k / workers, 
+                                   ticketSegmentCount * (k + 1) / workers, ticketIDs, ticketUserIDs, 
+                                   ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                                   ticketSeats, ticketTiers, ticketSegmentLoaded, ticketCount, usernames, 
+                                   userGenerations, userCount);
+     }
+     loadTicketSegmentRange(0, ticketSegmentCount / workers, ticketIDs, ticketUserIDs, ticketEventIDs, 
+                            ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                            ticketSegmentLoaded, ticketCount, usernames, userGenerations, userCount);
+     for (int k = 1; k < workers; k++) {
+         workerThreads[k].join();
+     }
+     
+     ticketsLoaded = true;
+     return true;
+ }
+ 
+ int findTicketSegment(int ticketID, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                       int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                       int ticketSeats[], int ticketTiers[], int ticketIDTable[], int ticketSegmentMinIDs[], 
+                       int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], int ticketSegmentCount, 
+                       int ticketCount, bool ticketsLoaded, string usernames[], int userGenerations[], 
+                       int userCount) {
+     // Returns the segment holding the ticket or -1, paging in only segments whose ID range covers it;
+     // once everything is in memory the ticket-ID table answers directly
+     if (ticketsLoaded) {
+         int index = findTicketIndex(ticketID, ticketIDTable, ticketIDs);
+         return index == -1 ? -1 : index / getTicketSegmentSize();
+     }
+     
+     for (int segment = 0; segment < ticketSegmentCount; segment++) {
+         if (ticketID < ticketSegmentMinIDs[segment] || ticketID > ticketSegmentMaxIDs[segment]) {
+             continue;
+         }
+         if (!ticketSegmentLoaded[segment]) {
+             loadTicketSegment(segment, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                               ticketDates, ticketHours, ticketSeats, ticketTiers, ticketSegmentLoaded, 
+                               ticketCount, usernames, userGenerations, userCount);
+         }
+         int end = min((segment + 1) * getTicketSegmentSize(), ticketCount);
+         for (int i = segment * getTicketSegmentSize(); i < end; i++) {
+             if (ticketIDs[i] == ticketID) {
+                 return segment;
+             }
+         }
+     }
+     return -1;
+ }
+ 
+ int getLoadThreadCount(long long bytes) {
+     // One worker per core, at most getMaxLoadThreads(), and none for less than a worker's share of bytes
+     int cores = (int)thread::hardware_concurrency();
+     long long byBytes = bytes / getMinLoadBytesPerThread();
+     int workers = min(max(cores, 1), getMaxLoadThreads());
+     if (byBytes < workers) {
+         workers = (int)max(byBytes, 1LL);
+     }
+     return workers;
+ }
+ 
+ void countTicketLines(long long begin, long long end, int& lineCount) {
+     ifstream file("tickets.txt", ios::binary);
+     file.seekg(begin);
+     
+     char buffer[65536];
+     char last = '\n';
+     long long remaining = end - begin;
+     lineCount = 0;
+     while (remaining > 0) {
+         file.read(buffer, (streamsize)min((long long)sizeof(buffer), remaining));
+         long long got = (long long)file.gcount();
+         if (got <= 0) {
+             break;
+         }
+         for (long long i = 0; i < got; i++) {
+             if (buffer[i] == '\n') {
+                 lineCount++;
+             }
+         }
+         last = buffer[got - 1];
+         remaining -= got;
+     }
+     // A last line without a newline still counts, getline returns it too
+     if (end > begin && last != '\n') {
+         lineCount++;
+     }
+ }
+ 
+ void parseTicketRange(long long begin, long long end, int firstPosition, int ticketIDs[], 
+                       int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                       double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                       int ticketTiers[], string usernames[], int userGenerations[], int userCount, 
+                       int& lineCount, int& rejected) {
+     ifstream file("tickets.txt", ios::binary);
+     file.seekg(begin);
+     
+     lineCount = 0;
+     rejected = 0;
+     long long consumed = 0;
+     int position = firstPosition;
+     string line;
+     while (consumed < end - begin && position < getMaxTickets() && getline(file, line)) {
+         consumed += (long long)line.length() + 1;
+         if ((int)line.length() > 0 && line[line.length() - 1] == '\r') {
+             line.erase(line.length() - 1);
+         }
+         if (!parseTicketLine(line, position, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                              ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, usernames, 
+                              userGenerations, userCount)) {
+             ticketIDs[position] = -1;
+             rejected++;
+         }
+         position++;
+         lineCount++;
+     }
+ }
+ 
+ void loadTicketSegmentRange(int firstSegment, int lastSegment, int ticketIDs[], int ticketUserIDs[], 
+                             int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                             int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                             bool ticketSegmentLoaded[], int ticketCount, string usernames[], 
+                             int userGenerations[], int userCount) {
+     for (int i = firstSegment; i < lastSegment; i++) {
+         if (!ticketSegmentLoaded[i]) {
+             loadTicketSegment(i, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                               ticketDates, ticketHours, ticketSeats, ticketTiers, ticketSegmentLoaded, 
+                               ticketCount, usernames, userGenerations, userCount);
+         }
+     }
+ }
+ 
+ // Record Schema Functions
+ int splitColumns(string& line, int starts[], int ends[], int maxColumns) {
+     // One pass over the line, the last column stops at the next '|' so newer trailing columns are ignored
+     int length = (int)line.length();
+     int count = 0;
+     int start = 0;
+     for (int i = 0; i <= length && count < maxColumns; i++) {
+         if (i == length || line[i] == '|') {
+             starts[count] = start;
+             ends[count] = i;
+             count++;
+             start = i + 1;
+         }
+     }
+     return count;
+ }
+ 
+ int readIntColumn(string& line, int start, int end) {
+     // Reads the digits in place instead of copying the column out for stoi, an empty column reads as 0
+     bool negative = start < end && line[start] == '-';
+     int value = 0;
+     for (int i = negative ? start + 1 : start; i < end && line[i] >= '0' && line[i] <= '9'; i++) {
+         value = value * 10 + (line[i] - '0');
+     }
+     return negative ? -value : value;
+ }
+ 
+ bool isDigitColumn(string& line, int start, int end, int maxDigits) {
+     // True for 1 to maxDigits plain digits, so the column can be converted without overflowing or throwing
+     if (end <= start || end - start > maxDigits) {
+         return false;
+     }
+     for (int i = start; i < end; i++) {
+         if (line[i] < '0' || line[i] > '9') {
+             return false;
+         }
+     }
+     return true;
+ }
+ 
+ double readDoubleColumn(string& line, int start, int end) {
+     if (start >= end) {
+         return 0.0;
+     }
+     // strtod stops at the '|' that ends the column
+     return strtod(line.c_str() + start, NULL);
+ }
+ 
+ int readDateColumn(string& line, int start, int end) {
+     // Accepts DD-MM-YYYY only, returns -1 when the date is malformed or before 1970
+     if (end - start != 10 || line[start + 2] != '-' || line[start + 5] != '-') {
+         return -1;
+     }
+     for (int i = 0; i < 10; i++) {
+         if (i == 2 || i == 5) continue;
+         if (line[start + i] < '0' || line[start + i] > '9') {
+             return -1;
+         }
+     }
+     
+     const char* date = line.c_str() + start;
+     int day = (date[0] - '0') * 10 + (date[1] - '0');
+     int month = (date[3] - '0') * 10 + (date[4] - '0');
+     int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+     if (year < 1970 || month < 1 || month > 12 || day < 1) {
+         return -1;
+     }
+     
+     int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+     bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+     int lastDay = daysInMonth[month - 1] + ((month == 2 && leapYear) ? 1 : 0);
+     if (day > lastDay) {
+         return -1;
+     }
+     
+     return dateToDays(day, month, year);
+ }
+ 
+ void moveUserRow(int from, int to, string usernames[], string passwords[], string emails[], 
+                  int userGenerations[]) {
+     usernames[to] = usernames[from];
+     passwords[to] = passwords[from];
+     emails[to] = emails[from];
+     userGenerations[to] = userGenerations[from];
+ }
+ 
+ void clearUserRow(int slot, string usernames[], string passwords[], string emails[]) {
+     // The generation is left to the caller, which decides whether the slot is a tombstone
+     usernames[slot] = "";
+     passwords[slot] = "";
+     emails[slot] = "";
+ }
+ 
+ void moveEventRow(int from, int to, string eventNames[], int eventDates[], string eventVenues[], 
+                   string eventCategories[], double eventPrices[], int eventCapacities[], 
+                   int eventAvailable[], int eventGenerations[]) {
+     eventNames[to] = eventNames[from];
+     eventDates[to] = eventDates[from];
+     eventVenues[to] = eventVenues[from];
+     eventCategories[to] = eventCategories[from];
+     eventPrices[to] = eventPrices[from];
+     eventCapacities[to] = eventCapacities[from];
+     eventAvailable[to] = eventAvailable[from];
+     eventGenerations[to] = eventGenerations[from];
+ }
+ 
+ void clearEventRow(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                    string eventCategories[], double eventPrices[], int eventCapacities[], 
+                    int eventAvailable[]) {
+     eventNames[slot] = "";
+     eventDates[slot] = -1;
+     eventVenues[slot] = "";
+     eventCategories[slot] = "";
+     eventPrices[slot] = 0.0;
+     eventCapacities[slot] = 0;
+     eventAvailable[slot] = 0;
+ }
+ 
+ void moveTicketRow(int from, int to, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                    int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                    int ticketSeats[], int ticketTiers[]) {
+     ticketIDs[to] = ticketIDs[from];
+     ticketUserIDs[to] = ticketUserIDs[from];
+     ticketEventIDs[to] = ticketEventIDs[from];
+     ticketQuantities[to] = ticketQuantities[from];
+     ticketCosts[to] = ticketCosts[from];
+     ticketDates[to] = ticketDates[from];
+     ticketHours[to] = ticketHours[from];
+     ticketSeats[to] = ticketSeats[from];
+     ticketTiers[to] = ticketTiers[from];
+ }
+ 
+ // Validation Functions
+ bool isUsernameUnique(string username, string usernames[], int userCount) {
+     for (int i = 0; i < userCount; i++) {
+         if (usernames[i] == username) {
+             return false;
+         }
+     }
+     return true;
+ }
+ 
+ bool isValidEmail(string email) {
+     int atPos = -1;
+     int dotPos = -1;
+     
+     for (int i = 0; i < (int)email.length(); i++) {
+         if (email[i] == '@') {
+             atPos = i;
+         }
+         if (email[i] == '.' && atPos != -1) {
+             dotPos = i;
+         }
+     }
+     
+     return (atPos > 0 && dotPos > atPos + 1 && dotPos < (int)email.length() - 1);
+ }
+ 
+ bool isValidNumber(string input) {
+     if ((int)input.length() == 0) return false;
+     
+     for (int i = 0; i < (int)input.length(); i++) {
+         if (input[i] < '0' || input[i] > '9') {
+             if (i == 0 && input[i] == '-') continue;
+             if (input[i] == '.' && i > 0) continue;
+             return false;
+         }
+     }
+     return true;
+ }
+ 
+ int getValidInteger(string prompt) {
+     string input;
+     int value;
+     
+     cout << bright_yellow << prompt << reset;
+     cin >> input;
+     
+     while (!isValidNumber(input)) {
+         clearInputBuffer();
+         cout << bright_red << "Invalid input! Enter a valid number: " << reset;
+         cin >> input;
+     }
+     
+     value = stoi(input);
+     return value;
+ }
+ 
+ double getValidDouble(string prompt) {
+     string input;
+     double value;
+     
+     cout << bright_yellow << prompt << reset;
+     cin >> input;
+     
+     bool valid = true;
+     int dotCount = 0;
+     
+     for (int i = 0; i < (int)input.length(); i++) {
+         if (input[i] == '.') {
+             dotCount++;
+             if (dotCount > 1) {
+                 valid = false;
+                 break;
+             }
+         } else if (input[i] < '0' || input[i] > '9') {
+             if (i == 0 && input[i] == '-') continue;
+             valid = false;
+             break;
+         }
+     }
+     
+     while (!valid) {
+         clearInputBuffer();
+         cout << bright_red << "Invalid input! Enter a valid number: " << reset;
+         cin >> input;
+         valid = true;
+         dotCount = 0;
+         for (int i = 0; i < (int)input.length(); i++) {
+             if (input[i] == '.') {
+                 dotCount++;
+                 if (dotCount > 1) {
+                     valid = false;
+                     break;
+                 }
+             } else if (input[i] < '0' || input[i] > '9') {
+                 if (i == 0 && input[i] == '-') continue;
+                 valid = false;
+                 break;
+             }
+         }
+     }
+     
+     value = stod(input);
+     return value;
+ }
+ 
+ void clearInputBuffer() {
+     cin.clear();
+     cin.ignore(numeric_limits<streamsize>::max(), '\n');
+ }
+ 
+ // Utility Functions
+ int getCurrentDate() {
+     // Today's local calendar day taken from the system clock
+     time_t now = time(0);
+     tm* local = localtime(&now);
+     return dateToDays(local->tm_mday, local->tm_mon + 1, local->tm_year + 1900);
+ }
+ 
+ long long getCurrentMillis() {
+     return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+ }
+ 
+ long long getWallMillis() {
+     // Milliseconds since 1970, unlike getCurrentMillis() comparable between two processes
+     return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+ }
+ 
+ int getCurrentHour() {
+     time_t now = time(0);
+     tm* local = localtime(&now);
+     return local->tm_hour;
+ }
+ 
+ int dateToDays(int day, int month, int year) {
+     // Civil (Gregorian) date to days since 01-01-1970
+     if (month <= 2) {
+         year--;
+     }
+     int era = year / 400;
+     int yearOfEra = year - era * 400;
+     int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+     int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+     return era * 146097 + dayOfEra - 719468;
+ }
+ 
+ int parseDate(string date) {
+     // Accepts DD-MM-YYYY only, returns -1 when the date is malformed or before 1970
+     return readDateColumn(date, 0, (int)date.length());
+ }
+ 
+ string formatDate(int days) {
+     if (days < 0) {
+         return "Unknown";
+     }
+     
+     // Days since 01-01-1970 back to DD-MM-YYYY
+     int shifted = days + 719468;
+     int era = shifted / 146097;
+     int dayOfEra = shifted - era * 146097;
+     int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+     int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+     int monthIndex = (5 * dayOfYear + 2) / 153;
+     int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+     int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+     int year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+     
+     string result = "";
+     if (day < 10) result += "0";
+     result += to_string(day) + "-";
+     if (month < 10) result += "0";
+     result += to_string(month) + "-" + to_string(year);
+     return result;
+ }
+ 
+ string compactNumber(double value) {
+     // to_string without the trailing zeros, keeps the saved files small
+     string result = to_string(value);
+     int end = (int)result.length();
+     while (end > 0 && result[end - 1] == '0') {
+         end--;
+     }
+     if (end > 0 && result[end - 1] == '.') {
+         end--;
+     }
+     return result.substr(0, end);
+ }
+ 
+ // Constants Functions (Replaced global variables)
+ const int getMaxUsers() {
+     return EVENT_SYSTEM_MAX_USERS;
+ }
+ 
+ const int getMaxEvents() {
+     return EVENT_SYSTEM_MAX_EVENTS;
+ }
+ 
+ const int getMaxTickets() {
+     return EVENT_SYSTEM_MAX_TICKETS;
+ }
+ 
+ const int getBrowsePageSize() {
+     return 5;
+ }
+ 
+ const int getLeaderboardMetricCount() {
+     return 3;
+ }
+ 
+ const int getLeaderboardSize() {
+     return 10;
+ }
+ 
+ const int getRollupHours() {
+     return 7 * 24;
+ }
+ 
+ const int getRollupDays() {
+     return 366;
+ }
+ 
+ const int getEventRollupHours() {
+     return 48;
+ }
+ 
+ const int getEventRollupDays() {
+     return 92;
+ }
+ 
+ const int getRollupSize() {
+     return getRollupHours() + getRollupDays() + 
+            getMaxEvents() * (getEventRollupHours() + getEventRollupDays());
+ }
+ 
+ const int getHandleSlotSpan() {
+     return 65536;  // handle = generation * span + slot
+ }
+ 
+ const int getGenerationLimit() {
+     return 1024;  // compaction starts generations over past this, long before generation * span overflows an int
+ }
+ 
+ const int getMetricCount() {
+     return 17;
+ }
+ 
+ const int getMetricSubBuckets() {
+     return 16;  // buckets per power of two, about 6% resolution
+ }
+ 
+ const int getMetricBucketCount() {
+     return 29 * getMetricSubBuckets();  // up to 2^32 microseconds, anything slower lands in the last bucket
+ }
+ 
+ const int getMetricStatCount() {
+     return 4;  // calls, total microseconds, max microseconds, bytes written
+ }
+ 
+ const int getTraceCapacity() {
+     return 2048;  // spans kept per ring, older spans are overwritten
+ }
+ 
+ const int getTraceRingCount() {
+     return 3;  // one ring per thread that records spans: 0 main, 1 event loader, 2 persistence worker
+ }
+ 
+ const bool isTraceEnabled() {
+ #ifdef EVENT_SYSTEM_TRACE
+     return true;
+ #else
+     return false;
+ #endif
+ }
+ 
+ const int getTicketSegmentSize() {
+     return 4096;  // tickets per tickets_N.txt partition, the unit that gets saved and paged in
+ }
+ 
+ const int getMaxTicketSegments() {
+     return getMaxTickets() / getTicketSegmentSize() + 1;
+ }
+ 
+ const int getEventPartitionSize() {
+     return 32;  // event slots per events_N.txt partition
+ }
+ 
+ const int getMaxEventPartitions() {
+     return (getMaxEvents() + getEventPartitionSize() - 1) / getEventPartitionSize();
+ }
+ 
+ const int getMaxQueryTerms() {
+     return 24;  // room for four OR groups of every field
+ }
+ 
+ const int getMaxLoadThreads() {
+     return 8;
+ }
+ 
+ const int getMinLoadBytesPerThread() {
+     return 1 << 20;  // smaller files are not worth a thread
+ }
+ 
+ const int getPersistDelayMillis() {
+     return 50;  // how long the persistence worker waits for more edits before writing
+ }
+ 
+ const int getSeatRecordWidth() {
+     return 8;  // seven zero-padded digits and a newline per event slot in events.avail
+ }
+ 
+ const int getTicketIDTableSize() {
+     return 2 * getMaxTickets();  // kept at most half full so probes stay short
+ }
+ 
+ const int getWaitlistCapacity() {
+     return 32;  // waiting requests per event
+ }
+ 
+ const int getWaitlistScanLimit() {
+     return 8;  // requests tried past the ones that only lack side-by-side seats, per promotion
+ }
+ 
+ const int getSeatsPerRow() {
+     return 64;  // one 64-bit word per row
+ }
+ 
+ const int getMaxSeatRows() {
+     return 64;  // events with more than 64 x 64 seats are sold as general admission
+ }
+ 
+ const int getRowsPerSection() {
+     return 8;
+ }
+ 
+ const int getSeatMapRecordWidth() {
+     return getMaxSeatRows() * 16 + 1;  // a hex word per row and a newline per event slot in events.seats
+ }
+ 
+ const int getEarlyBirdDays() {
+     return 30;  // early-bird prices end this many days before the event
+ }
+ 
+ const int getLastSeatsCount() {
+     return 100;  // the surcharge starts at the last 100 seats (or last 10% of a smaller event)
+ }
+ 
+ const int getRequestKeyTableSize() {
+     return 16384;  // fixed, old keys are overwritten rather than the table growing
+ }
+ 
+ const int getRequestKeyProbes() {
+     return 8;  // slots a key may sit in after its home slot
+ }
+ 
+ const int getRequestKeySeconds() {
+     return 600;  // how long a kiosk may keep retrying the same request
+ }
+ 
+ const int getTicketCapPerUser() {
+     return EVENT_SYSTEM_TICKET_CAP;
+ }
+ 
+ const int getPurchaseTableSize() {
+     return 2 * getMaxTickets();  // every ticket adds at most one user and event pair, so never over half full
+ }
+ 
+ const int getUserBookingBurst() {
+     return 5;  // bookings a customer can make back to back
+ }
+ 
+ const int getUserBookingInterval() {
+     return 10000;  // milliseconds per booking after the burst, 6 a minute
+ }
+ 
+ const int getEventBookingBurst() {
+     return 200;
+ }
+ 
+ const int getEventBookingInterval() {
+     return 20;  // milliseconds per booking after the burst, 50 a second per event
+ }
+ 
+ const int getJournalPollMillis() {
+     return 100;  // how often a follower checks journal.txt for new lines once it has caught up
+ }
+ 
+ const int getUserColumnCount() {
+     return 4;  // username|password|email|generation
+ }
+ 
+ const int getEventColumnCount() {
+     return 8;  // name|date|venue|category|price|capacity|available|generation
+ }
+ 
+ const int getTicketColumnCount() {
+     return 9;  // ticketID|userHandle|eventHandle|quantity|cost|date|hour|seat|tier
+ }
+ 
+ const int getBloomFilterWords() {
+     return (16 * getMaxTickets() + 63) / 64;  // 16 bits per ticket, about 1 forged ID in 700 gets past the filter
+ }
+ 
+ const int getBloomHashCount() {
+     return 5;
+ }
+ 
+ const int getCheckInSpan() {
+     return 8 * getMaxTickets();  // ticket IDs from the lowest live one the gate bitmap covers, room for archived gaps
+ }
+ 
+ const int getCheckInWords() {
+     return (getCheckInSpan() + 63) / 64;
+ }
+ 
+ string getAdminUsername() {
+     return "admin";
+ }
+ 
+ string getAdminPassword() {
+     return "admin123";
+ }
+ 
+ // Event Management Functions
+ string addEvent(string name, int date, string venue, string category, double price, 
+                 int capacity, string eventNames[], int eventDates[], string eventVenues[], 
+                 string eventCategories[], double eventPrices[], int eventCapacities[], 
+                 int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                 int availableEvents[], int availablePos[], int& availableCount, 
+                 double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                 int leaderboardPos[], int eventGenerations[], int eventFreeList[], 
+                 int& eventFreeCount, int& eventCount) {
+     // The indexes and rankings only hold live events
+     int liveCount = eventCount - eventFreeCount;
+     int slot = allocateSlot(eventGenerations, eventFreeList, eventFreeCount, eventCount, getMaxEvents());
+     if (slot == -1) {
+         return "Event limit reached!";
+     }
+     
+     eventNames[slot] = name;
+     eventDates[slot] = date;
+     eventVenues[slot] = venue;
+     eventCategories[slot] = category;
+     eventPrices[slot] = price;
+     eventCapacities[slot] = capacity;
+     eventAvailable[slot] = capacity;
+     insertDateIndex(slot, eventDateIndex, eventDates, liveCount);
+     insertPriceIndex(slot, eventPriceIndex, eventPrices, liveCount);
+     availablePos[slot] = -1;
+     syncAvailableSet(slot, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+     eventRevenue[slot] = 0.0;
+     eventSeatsSold[slot] = 0;
+     for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+         leaderboardRanks[metric * getMaxEvents() + liveCount] = slot;
+         leaderboardPos[metric * getMaxEvents() + slot] = liveCount;
+     }
+     updateLeaderboards(slot, eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                        leaderboardRanks, leaderboardPos, liveCount + 1);
+     
+     return "Event added successfully!";
+ }
+ 
+ string viewAllEvents(string eventNames[], int eventDates[], string eventVenues[], 
+                      string eventCategories[], double eventPrices[], int eventCapacities[], 
+                      int eventAvailable[], int eventGenerations[], int eventCount) {
+     string result = "\n========== ALL EVENTS ==========\n";
+     bool found = false;
+     
+     for (int i = 0; i < eventCount; i++) {
+         if (!isSlotLive(i, eventGenerations, eventCount)) {
+             continue;
+         }
+         found = true;
+         result += "\nEvent #" + to_string(i + 1) + "\n";
+         result += "Name: " + eventNames[i] + "\n";
+         result += "Date: " + formatDate(eventDates[i]) + "\n";
+         result += "Venue: " + eventVenues[i] + "\n";
+         result += "Category: " + eventCategories[i] + "\n";
+         result += "Price: $" + to_string(eventPrices[i]) + "\n";
+         result += "Capacity: " + to_string(eventCapacities[i]) + "\n";
+         result += "Available: " + to_string(eventAvailable[i]) + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     if (!found) {
+         return "\nNo events available!";
+     }
+     
+     return result;
+ }
+ 
+ string updateEvent(int index, string name, int date, string venue, string category, 
+                    double price, int capacity, int available, string eventNames[], 
+                    int eventDates[], string eventVenues[], string eventCategories[], 
+                    double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                    int eventDateIndex[], int eventPriceIndex[], int availableEvents[], 
+                    int availablePos[], int& availableCount, double eventRevenue[], 
+                    int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                    int eventGenerations[], int eventFreeCount, int eventCount) {
+     if (!isSlotLive(index, eventGenerations, eventCount)) {
+         return "Invalid event index!";
+     }
+     
+     int liveCount = eventCount - eventFreeCount;
+     if (eventDates[index] != date) {
+         removeDateIndex(index, eventDateIndex, eventDates, liveCount);
+         eventDates[index] = date;
+         insertDateIndex(index, eventDateIndex, eventDates, liveCount - 1);
+     }
+     if (eventPrices[index] != price) {
+         // Taken out of the available set too, the sync below puts it back at its new price
+         removePriceIndex(index, eventPriceIndex, eventPrices, liveCount);
+         removeAvailableEvent(index, availableEvents, availablePos, availableCount);
+         eventPrices[index] = price;
+         insertPriceIndex(index, eventPriceIndex, eventPrices, liveCount - 1);
+     }
+     eventNames[index] = name;
+     eventVenues[index] = venue;
+     eventCategories[index] = category;
+     eventPrices[index] = price;
+     eventCapacities[index] = capacity;
+     eventAvailable[index] = available;
+     syncAvailableSet(index, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+     updateLeaderboards(index, eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                        leaderboardRanks, leaderboardPos, liveCount);
+     
+     return "Event updated successfully!";
+ }
+ 
+ string deleteEvent(int index, string eventNames[], int eventDates[], string eventVenues[], 
+                    string eventCategories[], double eventPrices[], int eventCapacities[], 
+                    int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                    int availableEvents[], int availablePos[], int& availableCount, 
+                    double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                    int leaderboardPos[], int rollupKeys[], double rollupRevenue[], 
+                    int rollupTickets[], int eventGenerations[], int eventFreeList[], 
+                    int& eventFreeCount, int eventCount) {
+     if (!isSlotLive(index, eventGenerations, eventCount)) {
+         return "Invalid event index!";
+     }
+     
+     // Only the indexes that list live events are touched, the slot itself is tombstoned
+     // in place so every other event and every ticket handle stays where it is
+     int liveCount = eventCount - eventFreeCount;
+     removeDateIndex(index, eventDateIndex, eventDates, liveCount);
+     removePriceIndex(index, eventPriceIndex, eventPrices, liveCount);
+     eventAvailable[index] = 0;
+     syncAvailableSet(index, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+     removeFromLeaderboards(index, leaderboardRanks, leaderboardPos, liveCount);
+     for (int level = 0; level < 2; level++) {
+         int start = getRollupRingStart(level, index);
+         for (int j = 0; j < getRollupRingSize(level, index); j++) {
+             rollupKeys[start + j] = -1;
+             rollupRevenue[start + j] = 0.0;
+             rollupTickets[start + j] = 0;
+         }
+     }
+     
+     clearEventRow(index, eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                   eventAvailable);
+     eventRevenue[index] = 0.0;
+     eventSeatsSold[index] = 0;
+     releaseSlot(index, eventGenerations, eventFreeList, eventFreeCount);
+     
+     return "Event deleted successfully!";
+ }
+ 
+ string searchEventByName(string name, string eventNames[], int eventDates[], 
+                          string eventVenues[], string eventCategories[], double eventPrices[], 
+                          int eventCapacities[], int eventAvailable[], int eventCount) {
+     bool found = false;
+     string result = "\n========== SEARCH RESULTS ==========\n";
+     
+     for (int i = 0; i < eventCount; i++) {
+         if ((int)eventNames[i].find(name) != -1) {
+             found = true;
+             result += "\nEvent #" + to_string(i + 1) + "\n";
+             result += "Name: " + eventNames[i] + "\n";
+             result += "Date: " + formatDate(eventDates[i]) + "\n";
+             result += "Venue: " + eventVenues[i] + "\n";
+             result += "Category: " + eventCategories[i] + "\n";
+             result += "Price: $" + to_string(eventPrices[i]) + "\n";
+             result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+             result += "--------------------------------\n";
+         }
+     }
+     
+     if (!found) {
+         return "\nNo events found with that name!";
+     }
+     
+     return result;
+ }
+ 
+ string searchEventByCategory(string category, string eventNames[], int eventDates[], 
+                              string eventVenues[], string eventCategories[], double eventPrices[], 
+                              int eventCapacities[], int eventAvailable[], int eventCount) {
+     bool found = false;
+     string result = "\n========== SEARCH RESULTS ==========\n";
+     
+     for (int i = 0; i < eventCount; i++) {
+         if ((int)eventCategories[i].find(category) != -1) {
+             found = true;
+             result += "\nEvent #" + to_string(i + 1) + "\n";
+             result += "Name: " + eventNames[i] + "\n";
+             result += "Date: " + formatDate(eventDates[i]) + "\n";
+             result += "Venue: " + eventVenues[i] + "\n";
+             result += "Category: " + eventCategories[i] + "\n";
+             result += "Price: $" + to_string(eventPrices[i]) + "\n";
+             result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+             result += "--------------------------------\n";
+         }
+     }
+     
+     if (!found) {
+         return "\nNo events found in that category!";
+     }
+     
+     return result;
+ }
+ 
+ // Date Index Functions
+ void buildDateIndex(int dateIndex[], int dates[], int count) {
+     for (int i = 0; i < count; i++) {
+         dateIndex[i] = i;
+     }
+     // Stable so ids with the same date keep their insertion order
+     stable_sort(dateIndex, dateIndex + count, [dates](int a, int b) {
+         return dates[a] < dates[b];
+     });
+ }
+ 
+ int lowerBoundDate(int date, int dateIndex[], int dates[], int count) {
+     // First position in the index whose date is >= date
+     int low = 0;
+     int high = count;
+     while (low < high) {
+         int mid = low + (high - low) / 2;
+         if (dates[dateIndex[mid]] < date) {
+             low = mid + 1;
+         } else {
+             high = mid;
+         }
+     }
+     return low;
+ }
+ 
+ void insertDateIndex(int id, int dateIndex[], int dates[], int count) {
+     // count is the number of entries before the insert; appends in O(1) when dates arrive in order
+     int pos = lowerBoundDate(dates[id] + 1, dateIndex, dates, count);
+     for (int i = count; i > pos; i--) {
+         dateIndex[i] = dateIndex[i - 1];
+     }
+     dateIndex[pos] = id;
+ }
+ 
+ void removeDateIndex(int id, int dateIndex[], int dates[], int count) {
+     int pos = lowerBoundDate(dates[id], dateIndex, dates, count);
+     while (pos < count && dateIndex[pos] != id) {
+         pos++;
+     }
+     if (pos == count) {
+         return;
+     }
+     for (int i = pos; i < count - 1; i++) {
+         dateIndex[i] = dateIndex[i + 1];
+     }
+ }
+ 
+ string viewUpcomingEvents(string eventNames[], int eventDates[], string eventVenues[], 
+                           string eventCategories[], double eventPrices[], int eventCapacities[], 
+                           int eventAvailable[], int eventDateIndex[], int eventCount) {
+     int start = lowerBoundDate(getCurrentDate(), eventDateIndex, eventDates, eventCount);
+     if (start == eventCount) {
+         return "\nNo upcoming events!";
+     }
+     
+     string result = "\n========== UPCOMING EVENTS ==========\n";
+     
+     for (int pos = start; pos < eventCount; pos++) {
+         int i = eventDateIndex[pos];
+         result += "\nEvent #" + to_string(i + 1) + "\n";
+         result += "Name: " + eventNames[i] + "\n";
+         result += "Date: " + formatDate(eventDates[i]) + "\n";
+         result += "Venue: " + eventVenues[i] + "\n";
+         result += "Category: " + eventCategories[i] + "\n";
+         result += "Price: $" + to_string(eventPrices[i]) + "\n";
+         result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     return result;
+ }
+ 
+ string searchEventsByDateRange(int fromDate, int toDate, string eventNames[], int eventDates[], 
+                                string eventVenues[], string eventCategories[], double eventPrices[], 
+                                int eventCapacities[], int eventAvailable[], int eventDateIndex[], 
+                                int eventCount) {
+     int start = lowerBoundDate(fromDate, eventDateIndex, eventDates, eventCount);
+     int end = lowerBoundDate(toDate + 1, eventDateIndex, eventDates, eventCount);
+     if (start >= end) {
+         return "\nNo events found between those dates!";
+     }
+     
+     string result = "\n========== SEARCH RESULTS ==========\n";
+     
+     for (int pos = start; pos < end; pos++) {
+         int i = eventDateIndex[pos];
+         result += "\nEvent #" + to_string(i + 1) + "\n";
+         result += "Name: " + eventNames[i] + "\n";
+         result += "Date: " + formatDate(eventDates[i]) + "\n";
+         result += "Venue: " + eventVenues[i] + "\n";
+         result += "Category: " + eventCategories[i] + "\n";
+         result += "Price: $" + to_string(eventPrices[i]) + "\n";
+         result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     return result;
+ }
+ 
+ string viewTicketsSoldOnDate(int date, int ticketIDs[], int ticketUserIDs[], 
+                              int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                              int ticketDates[], int ticketDateIndex[], string eventNames[], 
+                              string usernames[], int ticketCount, int eventGenerations[], 
+                              int eventCount, int userGenerations[], int userCount) {
+     int start = lowerBoundDate(date, ticketDateIndex, ticketDates, ticketCount);
+     int end = lowerBoundDate(date + 1, ticketDateIndex, ticketDates, ticketCount);
+     if (start >= end) {
+         return "\nNo tickets sold on " + formatDate(date) + "!";
+     }
+     
+     string result = "\n========== TICKETS SOLD ON " + formatDate(date) + " ==========\n";
+     int totalQuantity = 0;
+     double totalRevenue = 0.0;
+     
+     for (int pos = start; pos < end; pos++) {
+         int i = ticketDateIndex[pos];
+         result += "\nTicket ID: TKT-" + to_string(ticketIDs[i]) + "\n";
+         result += "User: " + resolveUsername(ticketUserIDs[i], usernames, userGenerations, userCount) + "\n";
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         if (eventIndex != -1) {
+             result += "Event: " + eventNames[eventIndex] + "\n";
+         }
+         result += "Quantity: " + to_string(ticketQuantities[i]) + "\n";
+         result += "Cost: $" + to_string(ticketCosts[i]) + "\n";
+         result += "--------------------------------\n";
+         totalQuantity += ticketQuantities[i];
+         totalRevenue += ticketCosts[i];
+     }
+     
+     result += "\nTickets Sold: " + to_string(totalQuantity) + "\n";
+     result += "Revenue: $" + to_string(totalRevenue) + "\n";
+     return result;
+ }
+ 
+ // Price & Availability Index Functions
+ void buildPriceIndex(int priceIndex[], double prices[], int count) {
+     for (int i = 0; i < count; i++) {
+         priceIndex[i] = i;
+     }
+     stable_sort(priceIndex, priceIndex + count, [prices](int a, int b) {
+         return prices[a] < prices[b];
+     });
+ }
+ 
+ int lowerBoundPrice(double price, int priceIndex[], double prices[], int count) {
+     // First position in the index whose price is >= price
+     int low = 0;
+     int high = count;
+     while (low < high) {
+         int mid = low + (high - low) / 2;
+         if (prices[priceIndex[mid]] < price) {
+             low = mid + 1;
+         } else {
+             high = mid;
+         }
+     }
+     return low;
+ }
+ 
+ int upperBoundPrice(double price, int priceIndex[], double prices[], int count) {
+     // First position in the index whose price is > price
+     int low = 0;
+     int high = count;
+     while (low < high) {
+         int mid = low + (high - low) / 2;
+         if (prices[priceIndex[mid]] <= price) {
+             low = mid + 1;
+         } else {
+             high = mid;
+         }
+     }
+     return low;
+ }
+ 
+ void insertPriceIndex(int id, int priceIndex[], double prices[], int count) {
+     // count is the number of entries before the insert
+     int pos = upperBoundPrice(prices[id], priceIndex, prices, count);
+     for (int i = count; i > pos; i--) {
+         priceIndex[i] = priceIndex[i - 1];
+     }
+     priceIndex[pos] = id;
+ }
+ 
+ void removePriceIndex(int id, int priceIndex[], double prices[], int count) {
+     int pos = lowerBoundPrice(prices[id], priceIndex, prices, count);
+     while (pos < count && priceIndex[pos] != id) {
+         pos++;
+     }
+     if (pos == count) {
+         return;
+     }
+     for (int i = pos; i < count - 1; i++) {
+         priceIndex[i] = priceIndex[i + 1];
+     }
+ }
+ 
+ void buildAvailableSet(int eventAvailable[], double eventPrices[], int eventCount, int availableEvents[], 
+                        int availablePos[], int& availableCount) {
+     availableCount = 0;
+     for (int i = 0; i < eventCount; i++) {
+         availablePos[i] = -1;
+         if (eventAvailable[i] > 0) {
+             availableEvents[availableCount] = i;
+             availableCount++;
+         }
+     }
+     sortAvailableSet(eventPrices, availableEvents, availablePos, availableCount);
+ }
+ 
+ void sortAvailableSet(double eventPrices[], int availableEvents[], int availablePos[], int availableCount) {
+     stable_sort(availableEvents, availableEvents + availableCount, [eventPrices](int a, int b) {
+         return eventPrices[a] < eventPrices[b];
+     });
+     for (int pos = 0; pos < availableCount; pos++) {
+         availablePos[availableEvents[pos]] = pos;
+     }
+ }
+ 
+ void syncAvailableSet(int eventIndex, int eventAvailable[], double eventPrices[], int availableEvents[], 
+                       int availablePos[], int& availableCount) {
+     // availableEvents[] holds the events with seats left in price order, so browsing them pages like the
+     // price index; availablePos[e] is the slot of event e in it, or -1 when sold out
+     bool inSet = availablePos[eventIndex] != -1;
+     
+     if (eventAvailable[eventIndex] > 0 && !inSet) {
+         int pos = upperBoundPrice(eventPrices[eventIndex], availableEvents, eventPrices, availableCount);
+         for (int i = availableCount; i > pos; i--) {
+             availableEvents[i] = availableEvents[i - 1];
+             availablePos[availableEvents[i]] = i;
+         }
+         availableEvents[pos] = eventIndex;
+         availablePos[eventIndex] = pos;
+         availableCount++;
+     } else if (eventAvailable[eventIndex] <= 0 && inSet) {
+         removeAvailableEvent(eventIndex, availableEvents, availablePos, availableCount);
+     }
+ }
+ 
+ void removeAvailableEvent(int eventIndex, int availableEvents[], int availablePos[], int& availableCount) {
+     // Later members shift down one place to keep the price order
+     int pos = availablePos[eventIndex];
+     if (pos == -1) {
+         return;
+     }
+     for (int i = pos; i < availableCount - 1; i++) {
+         availableEvents[i] = availableEvents[i + 1];
+         availablePos[availableEvents[i]] = i;
+     }
+     availablePos[eventIndex] = -1;
+     availableCount--;
+ }
+ 
+ string browseEventsByPrice(double minPrice, double maxPrice, bool onlyAvailable, int page, 
+                            string eventNames[], int eventDates[], string eventVenues[], 
+                            string eventCategories[], double eventPrices[], int eventCapacities[], 
+                            int eventAvailable[], int eventPriceIndex[], int availableEvents[], 
+                            int availableCount, int eventCount) {
+     // Both indexes are in price order and every entry in the range matches, so jump straight to the page
+     int start = onlyAvailable ? lowerBoundPrice(minPrice, availableEvents, eventPrices, availableCount) : 
+                                 lowerBoundPrice(minPrice, eventPriceIndex, eventPrices, eventCount);
+     int end = onlyAvailable ? upperBoundPrice(maxPrice, availableEvents, eventPrices, availableCount) : 
+                               upperBoundPrice(maxPrice, eventPriceIndex, eventPrices, eventCount);
+     int shown = 0;
+     int pos = start + (page - 1) * getBrowsePageSize();
+     
+     string result = "\n========== BROWSE RESULTS (PAGE " + to_string(page) + ") ==========\n";
+     
+     for (; pos < end && shown < getBrowsePageSize(); pos++) {
+         int i = onlyAvailable ? availableEvents[pos] : eventPriceIndex[pos];
+         shown++;
+         result += "\nEvent #" + to_string(i + 1) + "\n";
+         result += "Name: " + eventNames[i] + "\n";
+         result += "Date: " + formatDate(eventDates[i]) + "\n";
+         result += "Venue: " + eventVenues[i] + "\n";
+         result += "Category: " + eventCategories[i] + "\n";
+         result += "Price: $" + to_string(eventPrices[i]) + "\n";
+         result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     if (shown == 0) {
+         return "\nNo events found in that price range!";
+     }
+     
+     if (pos < end) {
+         result += "\nMore results on page " + to_string(page + 1) + "\n";
+     }
+     
+     return result;
+ }
+ 
+ // Query Functions
+ bool matchesQueryTerm(int eventIndex, int field, string text, double low, double high, string eventNames[], 
+                       int eventDates[], string eventVenues[], string eventCategories[], double eventPrices[], 
+                       int eventAvailable[]) {
+     if (field == 0) {
+         return (int)eventNames[eventIndex].find(text) != -1;
+     } else if (field == 1) {
+         return (int)eventCategories[eventIndex].find(text) != -1;
+     } else if (field == 2) {
+         return (int)eventVenues[eventIndex].find(text) != -1;
+     } else if (field == 3) {
+         return eventDates[eventIndex] >= low && eventDates[eventIndex] <= high;
+     } else if (field == 4) {
+         return eventPrices[eventIndex] >= low && eventPrices[eventIndex] <= high;
+     }
+     return eventAvailable[eventIndex] > 0;
+ }
+ 
+ int estimateQueryTerm(int field, double low, double high, int eventDates[], int eventDateIndex[], 
+                       double eventPrices[], int eventPriceIndex[], int availableCount, int liveCount, 
+                       int& first, int& last) {
+     // Returns how many events the term's index would hand over, and their positions in that index.
+     // Text fields have no index, so they cost a scan of every live event.
+     first = 0;
+     last = liveCount;
+     if (field == 3) {
+         first = lowerBoundDate((int)low, eventDateIndex, eventDates, liveCount);
+         last = lowerBoundDate((int)high + 1, eventDateIndex, eventDates, liveCount);
+     } else if (field == 4) {
+         first = lowerBoundPrice(low, eventPriceIndex, eventPrices, liveCount);
+         last = upperBoundPrice(high, eventPriceIndex, eventPrices, liveCount);
+     } else if (field == 5) {
+         last = availableCount;
+     }
+     return max(0, last - first);
+ }
+ 
+ int queryEvents(int termFields[], int termGroups[], string termTexts[], double termLows[], 
+                 double termHighs[], int termCount, int groupCount, string eventNames[], int eventDates[], 
+                 string eventVenues[], string eventCategories[], double eventPrices[], int eventAvailable[], 
+                 int eventDateIndex[], int eventPriceIndex[], int availableEvents[], int availableCount, 
+                 int eventGenerations[], int eventFreeCount, int eventCount, int results[]) {
+     // Fills results with the handles of matching events and returns how many there are
+     int liveCount = eventCount - eventFreeCount;
+     bool matched[getMaxEvents()];
+     for (int i = 0; i < eventCount; i++) {
+         matched[i] = false;
+     }
+     int resultCount = 0;
+     
+     for (int group = 0; group < groupCount; group++) {
+         // Plan: drive the group from the term whose index yields the fewest candidates
+         int planField = 0;
+         int planFirst = 0;
+         int planLast = liveCount;
+         int planSize = liveCount;
+         bool indexed = false;
+         for (int t = 0; t < termCount; t++) {
+             if (termGroups[t] != group || termFields[t] < 3) {
+                 continue;
+             }
+             int first = 0;
+             int last = 0;
+             int size = estimateQueryTerm(termFields[t], termLows[t], termHighs[t], eventDates, eventDateIndex, 
+                                          eventPrices, eventPriceIndex, availableCount, liveCount, first, last);
+             if (!indexed || size < planSize) {
+                 planField = termFields[t];
+                 planFirst = first;
+                 planLast = last;
+                 planSize = size;
+                 indexed = true;
+             }
+         }
+         
+         // Without an indexed term the candidates are every slot, dead ones included
+         int candidateEnd = indexed ? planLast : eventCount;
+         for (int pos = indexed ? planFirst : 0; pos < candidateEnd; pos++) {
+             int i = pos;
+             if (indexed && planField == 3) {
+                 i = eventDateIndex[pos];
+             } else if (indexed && planField == 4) {
+                 i = eventPriceIndex[pos];
+             } else if (indexed && planField == 5) {
+                 i = availableEvents[pos];
+             } else if (!isSlotLive(i, eventGenerations, eventCount)) {
+                 continue;
+             }
+             if (matched[i]) {
+                 continue;
+             }
+             
+             // Verify the remaining terms of the group
+             bool match = true;
+             for (int t = 0; t < termCount && match; t++) {
+                 if (termGroups[t] == group) {
+                     match = matchesQueryTerm(i, termFields[t], termTexts[t], termLows[t], termHighs[t], 
+                                              eventNames, eventDates, eventVenues, eventCategories, 
+                                              eventPrices, eventAvailable);
+                 }
+             }
+             if (match) {
+                 matched[i] = true;
+                 results[resultCount] = makeHandle(i, eventGenerations[i]);
+                 resultCount++;
+             }
+         }
+     }
+     
+     return resultCount;
+ }
+ 
+ string formatQueryResults(int results[], int resultCount, string eventNames[], int eventDates[], 
+                           string eventVenues[], string eventCategories[], double eventPrices[], 
+                           int eventCapacities[], int eventAvailable[], int eventGenerations[], int eventCount) {
+     string result = "\n========== SEARCH RESULTS ==========\n";
+     int shown = 0;
+     
+     for (int r = 0; r < resultCount; r++) {
+         int i = resolveHandle(results[r], eventGenerations, eventCount);
+         if (i == -1) {
+             continue;
+         }
+         shown++;
+         result += "\nEvent #" + to_string(i + 1) + "\n";
+         result += "Name: " + eventNames[i] + "\n";
+         result += "Date: " + formatDate(eventDates[i]) + "\n";
+         result += "Venue: " + eventVenues[i] + "\n";
+         result += "Category: " + eventCategories[i] + "\n";
+         result += "Price: $" + to_string(eventPrices[i]) + "\n";
+         result += "Available: " + to_string(eventAvailable[i]) + "/" + to_string(eventCapacities[i]) + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     if (shown == 0) {
+         return "\nNo events found matching the query!";
+     }
+     
+     return result;
+ }
+ 
+ // Leaderboard Functions
+ double getLeaderboardScore(int metric, int eventIndex, double eventRevenue[], int eventSeatsSold[], 
+                            int eventCapacities[], int eventAvailable[]) {
+     if (metric == 0) {
+         return eventRevenue[eventIndex];
+     }
+     if (metric == 1) {
+         return eventSeatsSold[eventIndex];
+     }
+     if (eventCapacities[eventIndex] <= 0) {
+         return 0.0;
+     }
+     return 1.0 - (double)eventAvailable[eventIndex] / eventCapacities[eventIndex];
+ }
+ 
+ string getLeaderboardMetricName(int metric) {
+     if (metric == 0) {
+         return "Revenue";
+     }
+     if (metric == 1) {
+         return "Seats Sold";
+     }
+     return "Sell-Through";
+ }
+ 
+ bool ranksAhead(int metric, int a, int b, double eventRevenue[], int eventSeatsSold[], 
+                 int eventCapacities[], int eventAvailable[]) {
+     // Higher score first, ties keep the older event first so the order is stable
+     double scoreA = getLeaderboardScore(metric, a, eventRevenue, eventSeatsSold, eventCapacities, 
+     eventAvailable);
+     double scoreB = getLeaderboardScore(metric, b, eventRevenue, eventSeatsSold, eventCapacities, 
+     eventAvailable);
+     return scoreA > scoreB || (scoreA == scoreB && a < b);
+ }
+ 
+ void buildLeaderboards(int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                        int ticketCount, int eventCapacities[], int eventAvailable[], 
+                        double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                        int leaderboardPos[], int eventGenerations[], int eventCount) {
+     // Single pass over the tickets, after this only bookings touch the totals
+     for (int i = 0; i < eventCount; i++) {
+         eventRevenue[i] = 0.0;
+         eventSeatsSold[i] = 0;
+     }
+     for (int i = 0; i < ticketCount; i++) {
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         if (eventIndex != -1) {
+             eventRevenue[eventIndex] += ticketCosts[i];
+             eventSeatsSold[eventIndex] += ticketQuantities[i];
+         }
+     }
+     
+     rankLeaderboards(eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                      leaderboardRanks, leaderboardPos, eventGenerations, eventCount);
+ }
+ 
+ void rankLeaderboards(int eventCapacities[], int eventAvailable[], double eventRevenue[], 
+                       int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                       int eventGenerations[], int eventCount) {
+     for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+         int* ranks = leaderboardRanks + metric * getMaxEvents();
+         int* pos = leaderboardPos + metric * getMaxEvents();
+         
+         // Only live slots are ranked, so a ranking is as long as the live event count
+         int ranked = 0;
+         for (int i = 0; i < eventCount; i++) {
+             if (isSlotLive(i, eventGenerations, eventCount)) {
+                 ranks[ranked] = i;
+                 ranked++;
+             }
+         }
+         sort(ranks, ranks + ranked, [&](int a, int b) {
+             return ranksAhead(metric, a, b, eventRevenue, eventSeatsSold, eventCapacities, eventAvailable);
+         });
+         for (int r = 0; r < ranked; r++) {
+             pos[ranks[r]] = r;
+         }
+     }
+ }
+ 
+ void updateLeaderboards(int eventIndex, int eventCapacities[], int eventAvailable[], 
+                         double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                         int leaderboardPos[], int eventCount) {
+     // Move the event up or down each ranking until its neighbours are in order again
+     for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+         int* ranks = leaderboardRanks + metric * getMaxEvents();
+         int* pos = leaderboardPos + metric * getMaxEvents();
+         int r = pos[eventIndex];
+         
+         while (r > 0 && ranksAhead(metric, eventIndex, ranks[r - 1], eventRevenue, eventSeatsSold, 
+                                    eventCapacities, eventAvailable)) {
+             ranks[r] = ranks[r - 1];
+             pos[ranks[r]] = r;
+             r--;
+         }
+         while (r < eventCount - 1 && ranksAhead(metric, ranks[r + 1], eventIndex, eventRevenue, 
+                                                 eventSeatsSold, eventCapacities, eventAvailable)) {
+             ranks[r] = ranks[r + 1];
+             pos[ranks[r]] = r;
+             r++;
+         }
+         ranks[r] = eventIndex;
+         pos[eventIndex] = r;
+     }
+ }
+ 
+ void removeFromLeaderboards(int eventIndex, int leaderboardRanks[], int leaderboardPos[], int eventCount) {
+     // Close the gap the event leaves in each ranking, eventCount is the ranking length before removal
+     for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+         int* ranks = leaderboardRanks + metric * getMaxEvents();
+         int* pos = leaderboardPos + metric * getMaxEvents();
+         for (int r = pos[eventIndex]; r < eventCount - 1; r++) {
+             ranks[r] = ranks[r + 1];
+             pos[ranks[r]] = r;
+         }
+     }
+ }
+ 
+ string viewLeaderboard(int metric, string eventNames[], int eventCapacities[], int eventAvailable[], 
+                        double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], 
+                        int eventCount) {
+     if (eventCount == 0) {
+         return "\nNo events available!";
+     }
+     
+     // Reads the head of the ranking only, no ticket scan and no sort
+     int* ranks = leaderboardRanks + metric * getMaxEvents();
+     int shown = eventCount < getLeaderboardSize() ? eventCount : getLeaderboardSize();
+     string result = "\n--- Top " + to_string(shown) + " by " + getLeaderboardMetricName(metric) + " ---\n";
+     
+     for (int r = 0; r < shown; r++) {
+         int i = ranks[r];
+         result += to_string(r + 1) + ". " + eventNames[i] + " - ";
+         if (metric == 0) {
+             result += "$" + to_string(eventRevenue[i]);
+         } else if (metric == 1) {
+             result += to_string(eventSeatsSold[i]) + " seats";
+         } else {
+             double sellThrough = getLeaderboardScore(metric, i, eventRevenue, eventSeatsSold, 
+                                                      eventCapacities, eventAvailable);
+             result += to_string((int)(sellThrough * 100 + 0.5)) + "% sold";
+         }
+         result += "\n";
+     }
+     
+     return result;
+ }
+ 
+ // Sales Rollup Functions
+ int getRollupRingStart(int level, int eventIndex) {
+     // Layout: global hours | global days | per-event hours | per-event days
+     if (eventIndex < 0) {
+         return level == 0 ? 0 : getRollupHours();
+     }
+     int eventStart = getRollupHours() + getRollupDays();
+     if (level == 0) {
+         return eventStart + eventIndex * getEventRollupHours();
+     }
+     return eventStart + getMaxEvents() * getEventRollupHours() + eventIndex * getEventRollupDays();
+ }
+ 
+ int getRollupRingSize(int level, int eventIndex) {
+     if (eventIndex < 0) {
+         return level == 0 ? getRollupHours() : getRollupDays();
+     }
+     return level == 0 ? getEventRollupHours() : getEventRollupDays();
+ }
+ 
+ void clearRollups(int rollupKeys[], double rollupRevenue[], int rollupTickets[]) {
+     for (int i = 0; i < getRollupSize(); i++) {
+         rollupKeys[i] = -1;
+         rollupRevenue[i] = 0.0;
+         rollupTickets[i] = 0;
+     }
+ }
+ 
+ void addToRollup(int level, int eventIndex, int key, double revenue, int quantity, 
+                  int rollupKeys[], double rollupRevenue[], int rollupTickets[]) {
+     // Each ring slot belongs to the newest key that maps onto it, older keys are dropped
+     int slot = getRollupRingStart(level, eventIndex) + key % getRollupRingSize(level, eventIndex);
+     if (rollupKeys[slot] > key) {
+         return;
+     }
+     if (rollupKeys[slot] != key) {
+         rollupKeys[slot] = key;
+         rollupRevenue[slot] = 0.0;
+         rollupTickets[slot] = 0;
+     }
+     rollupRevenue[slot] += revenue;
+     rollupTickets[slot] += quantity;
+ }
+ 
+ void recordSale(int eventIndex, int date, int hour, double revenue, int quantity, 
+                 int rollupKeys[], double rollupRevenue[], int rollupTickets[]) {
+     if (date < 0) {
+         return;
+     }
+     addToRollup(1, -1, date, revenue, quantity, rollupKeys, rollupRevenue, rollupTickets);
+     if (eventIndex >= 0) {
+         addToRollup(1, eventIndex, date, revenue, quantity, rollupKeys, rollupRevenue, rollupTickets);
+     }
+     // Tickets saved before booking hours were recorded only count towards days
+     if (hour >= 0) {
+         addToRollup(0, -1, date * 24 + hour, revenue, quantity, rollupKeys, rollupRevenue, rollupTickets);
+         if (eventIndex >= 0) {
+             addToRollup(0, eventIndex, date * 24 + hour, revenue, quantity, rollupKeys, rollupRevenue, rollupTickets);
+         }
+     }
+ }
+ 
+ void buildRollups(int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                   int ticketDates[], int ticketHours[], int ticketCount, int rollupKeys[], 
+                   double rollupRevenue[], int rollupTickets[], int eventGenerations[], int eventCount) {
+     clearRollups(rollupKeys, rollupRevenue, rollupTickets);
+     for (int i = 0; i < ticketCount; i++) {
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         recordSale(eventIndex, ticketDates[i], ticketHours[i], ticketCosts[i], ticketQuantities[i], 
+                    rollupKeys, rollupRevenue, rollupTickets);
+     }
+ }
+ 
+ int readRollup(int level, int eventIndex, int key, int rollupKeys[], double rollupRevenue[], 
+                int rollupTickets[], double& revenue) {
+     // Returns tickets sold in the bucket and sets revenue, both 0 when the bucket is empty
+     int slot = getRollupRingStart(level, eventIndex) + key % getRollupRingSize(level, eventIndex);
+     if (rollupKeys[slot] != key) {
+         revenue = 0.0;
+         return 0;
+     }
+     revenue = rollupRevenue[slot];
+     return rollupTickets[slot];
+ }
+ 
+ string viewSalesRollups(int eventIndex, string eventNames[], int rollupKeys[], 
+                         double rollupRevenue[], int rollupTickets[]) {
+     int today = getCurrentDate();
+     int nowHour = today * 24 + getCurrentHour();
+     double revenue = 0.0;
+     int tickets = 0;
+     string result = "\n========== SALES ROLLUPS: " + (eventIndex < 0 ? string("ALL EVENTS") : eventNames[eventIndex]) + " ==========\n";
+     
+     result += "\n--- Last 24 Hours ---\n";
+     for (int key = nowHour - 23; key <= nowHour; key++) {
+         tickets = readRollup(0, eventIndex, key, rollupKeys, rollupRevenue, rollupTickets, revenue);
+         if (tickets > 0) {
+             result += formatDate(key / 24) + " " + (key % 24 < 10 ? "0" : "") + to_string(key % 24) + ":00  " 
+                     + to_string(tickets) + " tickets  $" + to_string(revenue) + "\n";
+         }
+     }
+     
+     result += "\n--- Last 14 Days ---\n";
+     for (int day = today - 13; day <= today; day++) {
+         tickets = readRollup(1, eventIndex, day, rollupKeys, rollupRevenue, rollupTickets, revenue);
+         if (tickets > 0) {
+             result += formatDate(day) + "  " + to_string(tickets) + " tickets  $" + to_string(revenue) + "\n";
+         }
+     }
+     
+     // Months are derived from the day buckets that are still inside the ring
+     result += "\n--- Monthly ---\n";
+     int oldestDay = today - getRollupRingSize(1, eventIndex) + 1;
+     string month = "";
+     double monthRevenue = 0.0;
+     int monthTickets = 0;
+     for (int day = oldestDay; day <= today + 1; day++) {
+         string dayMonth = day <= today ? formatDate(day).substr(3) : "";
+         if (dayMonth != month) {
+             if (monthTickets > 0) {
+                 result += month + "  " + to_string(monthTickets) + " tickets  $" + to_string(monthRevenue) + "\n";
+             }
+             month = dayMonth;
+             monthRevenue = 0.0;
+             monthTickets = 0;
+         }
+         if (day <= today) {
+             monthTickets += readRollup(1, eventIndex, day, rollupKeys, rollupRevenue, rollupTickets, revenue);
+             monthRevenue += revenue;
+         }
+     }
+     
+     return result;
+ }
+ 
+ // Metrics Functions
+ long long getMicros() {
+ #if defined(EVENT_SYSTEM_NO_METRICS) && !defined(EVENT_SYSTEM_TRACE)
+     return 0;
+ #else
+     return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+ #endif
+ }
+ 
+ int getMetricBucket(long long micros) {
+     // The first getMetricSubBuckets() values get a bucket each, every power of two above
+     // that is split into getMetricSubBuckets() equal buckets
+     int sub = getMetricSubBuckets();
+     if (micros < sub) {
+         return micros < 0 ? 0 : (int)micros;
+     }
+     int octave = 0;
+     while ((micros >> octave) >= 2 * sub) {
+         octave++;
+     }
+     int bucket = (octave + 1) * sub + (int)(micros >> octave) - sub;
+     return bucket < getMetricBucketCount() ? bucket : getMetricBucketCount() - 1;
+ }
+ 
+ long long getMetricBucketLimit(int bucket) {
+     // Largest value that lands in the bucket
+     int sub = getMetricSubBuckets();
+     if (bucket < sub) {
+         return bucket;
+     }
+     int octave = bucket / sub - 1;
+     return ((long long)(bucket % sub + sub + 1) << octave) - 1;
+ }
+ 
+ string getMetricName(int metric) {
+     string names[] = {"bookTicket", "loadUsersFromTXT", "loadEventsFromTXT", "loadTicketsFromTXT", 
+                       "saveUsersToTXT", "saveEventsToTXT", "saveTicketsToTXT", "searchEventByName", 
+                       "searchEventByCategory", "searchEventsByDateRange", "browseEventsByPrice", 
+                       "generateReports", "queryEvents", "replicationLag", "checkInTicket", "writeSeatRecord", 
+                       "saveWaitlistToTXT"};
+     return names[metric];
+ }
+ 
+ void clearMetrics(long long metricBuckets[], long long metricStats[]) {
+     for (int i = 0; i < getMetricCount() * getMetricBucketCount(); i++) {
+         metricBuckets[i] = 0;
+     }
+     for (int i = 0; i < getMetricCount() * getMetricStatCount(); i++) {
+         metricStats[i] = 0;
+     }
+ }
+ 
+ #ifdef EVENT_SYSTEM_NO_METRICS
+ void recordMetric(int, long long, long long, long long[], long long[]) {
+ }
+ #else
+ void recordMetric(int metric, long long micros, long long bytes, long long metricBuckets[], 
+                   long long metricStats[]) {
+     long long* stats = metricStats + metric * getMetricStatCount();
+     metricBuckets[metric * getMetricBucketCount() + getMetricBucket(micros)]++;
+     stats[0]++;
+     stats[1] += micros;
+     if (micros > stats[2]) {
+         stats[2] = micros;
+     }
+     stats[3] += bytes;
+ }
+ #endif
+ 
+ long long getMetricPercentile(int metric, double percentile, long long metricBuckets[], 
+                               long long metricStats[]) {
+     // Reports the top of the bucket holding the percentile, capped at the exact maximum
+     long long calls = metricStats[metric * getMetricStatCount()];
+     long long target = (long long)(percentile * calls + 0.999999);
+     long long seen = 0;
+     for (int bucket = 0; bucket < getMetricBucketCount(); bucket++) {
+         seen += metricBuckets[metric * getMetricBucketCount() + bucket];
+         if (seen >= target && seen > 0) {
+             long long limit = getMetricBucketLimit(bucket);
+             long long max = metricStats[metric * getMetricStatCount() + 2];
+             return limit < max ? limit : max;
+         }
+     }
+     return 0;
+ }
+ 
+ #ifdef EVENT_SYSTEM_NO_METRICS
+ string viewMetrics(long long[], long long[]) {
+     return "\nMetrics are disabled in this build!";
+ }
+ #else
+ string viewMetrics(long long metricBuckets[], long long metricStats[]) {
+     string result = "\n========== PERFORMANCE METRICS (microseconds) ==========\n";
+     bool found = false;
+     
+     for (int metric = 0; metric < getMetricCount(); metric++) {
+         long long* stats = metricStats + metric * getMetricStatCount();
+         if (stats[0] == 0) {
+             continue;
+         }
+         found = true;
+         result += "\n" + getMetricName(metric) + "\n";
+         result += "Calls: " + to_string(stats[0]) + "  Mean: " + to_string(stats[1] / stats[0]) + "\n";
+         result += "p50: " + to_string(getMetricPercentile(metric, 0.50, metricBuckets, metricStats)) 
+                 + "  p90: " + to_string(getMetricPercentile(metric, 0.90, metricBuckets, metricStats)) 
+                 + "  p99: " + to_string(getMetricPercentile(metric, 0.99, metricBuckets, metricStats)) 
+                 + "  Max: " + to_string(stats[2]) + "\n";
+         if (stats[3] > 0) {
+             result += "Bytes Written: " + to_string(stats[3]) + "\n";
+         }
+         result += "--------------------------------\n";
+     }
+     
+     if (!found) {
+         return "\nNo calls recorded yet!";
+     }
+     
+     return result;
+ }
+ #endif
+ 
+ string dumpMetricsToFile(string filename, long long metricBuckets[], long long metricStats[]) {
+     ofstream file(filename.c_str());
+     if (!file.is_open()) {
+         return "Could not open " + filename + "!";
+     }
+     
+     // Summary first, then the raw non-empty buckets as metric|bucketLimit|count for offline merging
+     file << viewMetrics(metricBuckets, metricStats) << endl;
+     file << "\n# metric|bucketLimitMicros|count" << endl;
+     for (int metric = 0; metric < getMetricCount(); metric++) {
+         for (int bucket = 0; bucket < getMetricBucketCount(); bucket++) {
+             long long count = metricBuckets[metric * getMetricBucketCount() + bucket];
+             if (count > 0) {
+                 file << getMetricName(metric) << "|" << getMetricBucketLimit(bucket) << "|" << count << endl;
+             }
+         }
+     }
+     file.close();
+     return "Metrics written to " + filename + "!";
+ }
+ 
+ // Trace Functions
+ #ifndef EVENT_SYSTEM_TRACE
+ void recordTrace(int, long long, long long, long long, long long[], long long&) {
+ }
+ #else
+ void recordTrace(int metric, long long start, long long micros, long long bytes, long long traceSpans[], 
+                  long long& traceCount) {
+     // Every thread writes only its own ring, so no locking is needed
+     long long* span = traceSpans + (traceCount % getTraceCapacity()) * 5;
+     span[0] = metric;
+     span[1] = start;
+     span[2] = micros;
+     span[3] = bytes;
+     span[4] = (long long)(hash<thread::id>()(this_thread::get_id()) & 0x7FFFFFFF);
+     traceCount++;
+ }
+ #endif
+ 
+ void finishTimedCall(int metric, long long start, long long bytes, long long metricBuckets[], 
+                      long long metricStats[], long long traceSpans[], long long& traceCount) {
+     long long micros = getMicros() - start;
+     recordMetric(metric, micros, bytes, metricBuckets, metricStats);
+     recordTrace(metric, start, micros, bytes, traceSpans, traceCount);
+ }
+ 
+ void finishLockedCall(int metric, long long start, long long bytes, long long metricBuckets[], 
+                       long long metricStats[], long long traceSpans[], long long& traceCount, mutex& metricLock) {
+     // For threads other than main: the span goes to the caller's own ring, the metric row is updated under
+     // metricLock because the front end reads every row when it shows the metrics
+     long long micros = getMicros() - start;
+     recordTrace(metric, start, micros, bytes, traceSpans, traceCount);
+     lock_guard<mutex> lock(metricLock);
+     recordMetric(metric, micros, bytes, metricBuckets, metricStats);
+ }
+ 
+ string writeTraceToFile(string filename, long long traceSpans[], long long traceCounts[]) {
+     ofstream file(filename.c_str());
+     if (!file.is_open()) {
+         return "Could not open " + filename + "!";
+     }
+     
+     // Chrome trace-event format, each span is a complete ("X") event in microseconds. The rings are written
+     // one after another, each as its own lane (tid ring + 1) led by a metadata event naming it. The id of the
+     // thread that recorded a span goes in its args, not the tid, because the system hands a finished thread's
+     // id to the next thread it starts (the event loader's id comes back for the persistence worker)
+     string ringNames[] = {"main", "event loader", "persistence worker"};
+     bool firstEvent = true;
+     file << "{\"traceEvents\":[";
+     for (int ring = 0; ring < getTraceRingCount(); ring++) {
+         long long* spans = traceSpans + ring * getTraceCapacity() * 5;
+         long long first = traceCounts[ring] > getTraceCapacity() ? traceCounts[ring] - getTraceCapacity() : 0;
+         for (long long i = first; i < traceCounts[ring]; i++) {
+             long long* span = spans + (i % getTraceCapacity()) * 5;
+             if (i == first) {
+                 file << (firstEvent ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                      << ring + 1 << ",\"args\":{\"name\":\"" << ringNames[ring] << "\"}}";
+                 firstEvent = false;
+             }
+             file << ",\n{\"name\":\"" << getMetricName((int)span[0]) << "\",\"cat\":\"event-system\",\"ph\":\"X\","
+                  << "\"ts\":" << span[1] << ",\"dur\":" << span[2] << ",\"pid\":1,\"tid\":" << ring + 1 << ","
+                  << "\"args\":{\"bytes\":" << span[3] << ",\"thread\":" << span[4] << "}}";
+         }
+     }
+     file << "\n],\"displayTimeUnit\":\"ms\"}" << endl;
+     file.close();
+     return "Trace written to " + filename + "!";
+ }
+ 
+ // Slot Map Functions
+ int makeHandle(int slot, int generation) {
+     return generation * getHandleSlotSpan() + slot;
+ }
+ 
+ int resolveHandle(int handle, int generations[], int count) {
+     // Returns the slot a handle points at, or -1 once that slot was deleted or reused
+     if (handle < 0) {
+         return -1;
+     }
+     int slot = handle % getHandleSlotSpan();
+     if (slot >= count || generations[slot] != handle / getHandleSlotSpan() || generations[slot] % 2 == 1) {
+         return -1;
+     }
+     return slot;
+ }
+ 
+ bool isSlotLive(int slot, int generations[], int count) {
+     return slot >= 0 && slot < count && generations[slot] % 2 == 0;
+ }
+ 
+ int allocateSlot(int generations[], int freeList[], int& freeCount, int& count, int maxCount) {
+     // Reuse a tombstoned slot first, bumping its generation back to even invalidates old handles
+     if (freeCount > 0) {
+         freeCount--;
+         int slot = freeList[freeCount];
+         generations[slot]++;
+         return slot;
+     }
+     if (count >= maxCount) {
+         return -1;
+     }
+     generations[count] = 0;
+     count++;
+     return count - 1;
+ }
+ 
+ void releaseSlot(int slot, int generations[], int freeList[], int& freeCount) {
+     generations[slot]++;
+     freeList[freeCount] = slot;
+     freeCount++;
+ }
+ 
+ bool hasOldGeneration(int generations[], int count) {
+     for (int i = 0; i < count; i++) {
+         if (generations[i] >= getGenerationLimit()) {
+             return true;
+         }
+     }
+     return false;
+ }
+ 
+ void remapHandles(int handles[], int handleCount, int newSlots[], int generations[], int count) {
+     // Handles to deleted slots become -1, the rest follow their slot to its compacted position. Every
+     // stored handle is rewritten here, so compaction starts the live slots over at generation 0
+     for (int i = 0; i < handleCount; i++) {
+         int slot = resolveHandle(handles[i], generations, count);
+         handles[i] = slot == -1 ? -1 : makeHandle(newSlots[slot], 0);
+     }
+ }
+ 
+ bool compactEvents(string eventNames[], int eventDates[], string eventVenues[], 
+                    string eventCategories[], double eventPrices[], int eventCapacities[], 
+                    int eventAvailable[], int eventGenerations[], int& eventFreeCount, 
+                    int& eventCount, int ticketEventIDs[], int ticketCount, int waitlistUserIDs[], 
+                    int waitlistQuantities[], int waitlistHeads[], int waitlistSizes[], 
+                    unsigned long long eventSeatMaps[]) {
+     // Runs at startup before any index is built, returns true when slots moved or generations started over.
+     // Each delete and reuse adds 2 to a slot's generation, so a busy slot is compacted before it overflows
+     if (eventFreeCount == 0 && !hasOldGeneration(eventGenerations, eventCount)) {
+         return false;
+     }
+     
+     int newSlots[getMaxEvents()];
+     int live = 0;
+     for (int i = 0; i < eventCount; i++) {
+         newSlots[i] = -1;
+         if (isSlotLive(i, eventGenerations, eventCount)) {
+             newSlots[i] = live;
+             live++;
+         }
+     }
+     remapHandles(ticketEventIDs, ticketCount, newSlots, eventGenerations, eventCount);
+     
+     for (int i = 0; i < eventCount; i++) {
+         int to = newSlots[i];
+         if (to != -1 && to != i) {
+             moveEventRow(i, to, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                          eventCapacities, eventAvailable, eventGenerations);
+             for (int j = 0; j < getWaitlistCapacity(); j++) {
+                 waitlistUserIDs[to * getWaitlistCapacity() + j] = waitlistUserIDs[i * getWaitlistCapacity() + j];
+                 waitlistQuantities[to * getWaitlistCapacity() + j] = waitlistQuantities[i * getWaitlistCapacity() + j];
+             }
+             waitlistHeads[to] = waitlistHeads[i];
+             waitlistSizes[to] = waitlistSizes[i];
+             for (int row = 0; row < getMaxSeatRows(); row++) {
+                 eventSeatMaps[to * getMaxSeatRows() + row] = eventSeatMaps[i * getMaxSeatRows() + row];
+             }
+         }
+     }
+     // The queues and seat maps of removed events go with them
+     for (int i = live; i < eventCount; i++) {
+         waitlistSizes[i] = 0;
+         clearSeatMap(i, eventSeatMaps);
+     }
+     for (int i = 0; i < live; i++) {
+         eventGenerations[i] = 0;
+     }
+     
+     eventCount = live;
+     eventFreeCount = 0;
+     return true;
+ }
+ 
+ bool compactUsers(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                   int& userFreeCount, int& userCount, int ticketUserIDs[], int ticketCount, 
+                   int waitlistUserIDs[]) {
+     if (userFreeCount == 0 && !hasOldGeneration(userGenerations, userCount)) {
+         return false;
+     }
+     
+     int newSlots[getMaxUsers()];
+     int live = 0;
+     for (int i = 0; i < userCount; i++) {
+         newSlots[i] = -1;
+         if (isSlotLive(i, userGenerations, userCount)) {
+             newSlots[i] = live;
+             live++;
+         }
+     }
+     remapHandles(ticketUserIDs, ticketCount, newSlots, userGenerations, userCount);
+     remapHandles(waitlistUserIDs, getMaxEvents() * getWaitlistCapacity(), newSlots, userGenerations, userCount);
+     
+     for (int i = 0; i < userCount; i++) {
+         int to = newSlots[i];
+         if (to != -1 && to != i) {
+             moveUserRow(i, to, usernames, passwords, emails, userGenerations);
+         }
+     }
+     for (int i = 0; i < live; i++) {
+         userGenerations[i] = 0;
+     }
+     
+     userCount = live;
+     userFreeCount = 0;
+     return true;
+ }
+ 
+ // User Management Functions
+ string addUser(string username, string password, string email, string usernames[], 
+                string passwords[], string emails[], int userGenerations[], int userFreeList[], 
+                int& userFreeCount, int& userCount) {
+     int slot = allocateSlot(userGenerations, userFreeList, userFreeCount, userCount, getMaxUsers());
+     if (slot == -1) {
+         return "User limit reached!";
+     }
+     
+     usernames[slot] = username;
+     passwords[slot] = password;
+     emails[slot] = email;
+     
+     return "User added successfully!";
+ }
+ 
+ string deleteUser(int index, string usernames[], string passwords[], string emails[], 
+                   int userGenerations[], int userFreeList[], int& userFreeCount, int userCount) {
+     if (!isSlotLive(index, userGenerations, userCount)) {
+         return "Invalid user index!";
+     }
+     
+     // Tombstone the slot, the user's ticket handles stop resolving once the generation moves on
+     clearUserRow(index, usernames, passwords, emails);
+     releaseSlot(index, userGenerations, userFreeList, userFreeCount);
+     
+     return "User deleted successfully!";
+ }
+ 
+ string viewAllUsers(string usernames[], string emails[], int userGenerations[], int userCount) {
+     // This function is kept for compatibility but colors are added at call sites
+     string result = "\n========== ALL USERS ==========\n";
+     bool found = false;
+     
+     for (int i = 0; i < userCount; i++) {
+         if (!isSlotLive(i, userGenerations, userCount)) {
+             continue;
+         }
+         found = true;
+         result += "\nUser #" + to_string(i + 1) + "\n";
+         result += "Username: " + usernames[i] + "\n";
+         result += "Email: " + emails[i] + "\n";
+         result += "--------------------------------\n";
+     }
+     
+     if (!found) {
+         return "\nNo users registered!";
+     }
+     
+     return result;
+ }
+ 
+ int findUserIndex(string username, string usernames[], int userCount) {
+     for (int i = 0; i < userCount; i++) {
+         if (usernames[i] == username) {
+             return i;
+         }
+     }
+     return -1;
+ }
+ 
+ string getUserEmail(string username, string usernames[], string emails[], int userCount) {
+     int index = findUserIndex(username, usernames, userCount);
+     if (index != -1) {
+         return emails[index];
+     }
+     return "";
+ }
+ 
+ string resolveUsername(int userHandle, string usernames[], int userGenerations[], int userCount) {
+     int index = resolveHandle(userHandle, userGenerations, userCount);
+     if (index != -1) {
+         return usernames[index];
+     }
+     return "Deleted User";
+ }
+ 
+ string resolveEmail(int userHandle, string emails[], int userGenerations[], int userCount) {
+     int index = resolveHandle(userHandle, userGenerations, userCount);
+     if (index != -1) {
+         return emails[index];
+     }
+     return "-";
+ }
+ 
+ // Ticket Management Functions
+ int generateTicketID(int ticketIDs[], int ticketIDTable[], int ticketCount, int lastArchivedTicketID) {
+     // New tickets are appended with increasing IDs, so the last one is normally the highest. Archived
+     // tickets have left the arrays, their IDs must not be handed out again either. The ID table
+     // skips past any live ID that is still higher (files written before IDs were ordered)
+     int nextID = max(1000, lastArchivedTicketID) + 1;
+     if (ticketCount > 0) {
+         nextID = max(nextID, ticketIDs[ticketCount - 1] + 1);
+     }
+     while (findTicketIndex(nextID, ticketIDTable, ticketIDs) != -1) {
+         nextID++;
+     }
+     return nextID;
+ }
+ 
+ string bookTicket(int userHandle, int eventIndex, int quantity, string eventNames[], double eventPrices[], 
+                   int eventAvailable[], int availableEvents[], int availablePos[], int& availableCount, 
+                   int eventCapacities[], unsigned long long eventSeatMaps[], int eventDates[], 
+                   int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[], 
+                   double eventRevenue[], int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                   int eventGenerations[], int eventFreeCount, int eventCount, int ticketIDs[], 
+                   int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                   int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                   int ticketDateIndex[], int ticketIDTable[], int rollupKeys[], double rollupRevenue[], 
+                   int rollupTickets[], int& ticketCount, int lastArchivedTicketID, long long now, 
+                   long long userRateTimes[], long long eventRateTimes[], long long purchaseKeys[], 
+                   int purchaseCounts[]) {
+     if (ticketCount >= getMaxTickets()) {
+         return "Ticket limit reached!";
+     }
+     
+     if (!isSlotLive(eventIndex, eventGenerations, eventCount)) {
+         return "Invalid event index!";
+     }
+     
+     if (quantity <= 0) {
+         return "Invalid quantity!";
+     }
+     
+     // Flash-sale guards, all O(1): the per-customer cap here, the rate tokens once nothing else can refuse
+     int eventHandle = makeHandle(eventIndex, eventGenerations[eventIndex]);
+     int held = getPurchaseCount(userHandle, eventHandle, purchaseKeys, purchaseCounts);
+     if (held + quantity > getTicketCapPerUser()) {
+         return "Limit is " + to_string(getTicketCapPerUser()) + " tickets per customer for this event! " + 
+                "You already hold " + to_string(held) + ".";
+     }
+     
+     if (eventAvailable[eventIndex] < quantity) {
+         return "Not enough seats available! Available: " + to_string(eventAvailable[eventIndex]);
+     }
+     
+     // Seated events put a group side by side in one row, general admission events get seat -1
+     int firstSeat = -1;
+     if (getSeatRowCount(eventCapacities[eventIndex]) > 0) {
+         firstSeat = findSeatBlock(eventIndex, quantity, eventSeatMaps, eventCapacities);
+         if (firstSeat == -1) {
+             return "No " + to_string(quantity) + " adjacent seats left together! Largest block: " + 
+                    to_string(getLargestSeatBlock(eventIndex, eventSeatMaps, eventCapacities));
+         }
+     }
+     
+     // A token from the customer's bucket and one from the event's, so a refused booking costs none.
+     // Waitlist promotions pass now as -1, they drew their token when joining the queue
+     if (now >= 0) {
+         long long& userRateTime = userRateTimes[userHandle % getHandleSlotSpan()];
+         long long userRateBefore = userRateTime;
+         if (!takeRateToken(userRateTime, now, getUserBookingInterval(), getUserBookingBurst())) {
+             return "Too many booking attempts! Please wait a few seconds and try again.";
+         }
+         if (!takeRateToken(eventRateTimes[eventIndex], now, getEventBookingInterval(), getEventBookingBurst())) {
+             userRateTime = userRateBefore;
+             return "This event is taking too many bookings right now! Please try again in a moment.";
+         }
+     }
+     
+     // The price tier is cached per event, it is only worked out again once a seat or date boundary is crossed
+     int today = getCurrentDate();
+     if (eventAvailable[eventIndex] <= eventTierSeatLimits[eventIndex] || today >= eventTierDateLimits[eventIndex]) {
+         updatePriceTier(eventIndex, today, eventDates, eventCapacities, eventAvailable, eventTiers, 
+                         eventTierSeatLimits, eventTierDateLimits);
+     }
+     
+     // Create ticket, it records the tier its first seat was sold at
+     int lastSeatsSold = quantity - getSeatsAtTierPrice(eventIndex, quantity, eventAvailable, eventTiers, 
+                                                        eventTierSeatLimits);
+     ticketIDs[ticketCount] = generateTicketID(ticketIDs, ticketIDTable, ticketCount, lastArchivedTicketID);
+     ticketUserIDs[ticketCount] = userHandle;
+     ticketEventIDs[ticketCount] = eventHandle;
+     ticketQuantities[ticketCount] = quantity;
+     ticketCosts[ticketCount] = getOrderCost(eventIndex, quantity, eventPrices, eventAvailable, eventTiers, 
+                                             eventTierSeatLimits);
+     ticketDates[ticketCount] = today;
+     ticketHours[ticketCount] = getCurrentHour();
+     ticketSeats[ticketCount] = firstSeat;
+     ticketTiers[ticketCount] = eventTiers[eventIndex];
+     insertDateIndex(ticketCount, ticketDateIndex, ticketDates, ticketCount);
+     insertTicketID(ticketCount, ticketIDTable, ticketIDs);
+     addPurchaseCount(userHandle, eventHandle, quantity, purchaseKeys, purchaseCounts);
+     
+     // Update available seats, a sold out event leaves the available set in O(1)
      eventAvailable[eventIndex] -= quantity;
+     syncAvailableSet(eventIndex, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+     setSeats(eventIndex, firstSeat, quantity, true, eventSeatMaps);
+     
+     // Keep the best-seller rankings current without rescanning tickets
+     eventRevenue[eventIndex] += ticketCosts[ticketCount];
+     eventSeatsSold[eventIndex] += quantity;
+     updateLeaderboards(eventIndex, eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                        leaderboardRanks, leaderboardPos, eventCount - eventFreeCount);
+     recordSale(eventIndex, ticketDates[ticketCount], ticketHours[ticketCount], ticketCosts[ticketCount], 
+                quantity, rollupKeys, rollupRevenue, rollupTickets);
+     
+     ticketCount++;
+     
+     string result = "Ticket booked successfully!\n" + 
+                     formatBookingResult(ticketCount - 1, eventNames, ticketIDs, ticketEventIDs, ticketQuantities, 
+                                         ticketCosts, ticketSeats, ticketTiers, eventGenerations, eventCount);
+     if (lastSeatsSold > 0 && lastSeatsSold < quantity) {
+         result += "\n" + to_string(lastSeatsSold) + " of these seats were sold at the " + getPriceTierName(2) + 
+                   " price ($" + to_string(eventPrices[eventIndex] * getPriceTierMultiplier(2)) + " each)";
+     }
+     return result;
+ }
+ 
+ string formatBookingResult(int ticketIndex, string eventNames[], int ticketIDs[], int ticketEventIDs[], 
+                            int ticketQuantities[], double ticketCosts[], int ticketSeats[], int ticketTiers[], 
+                            int eventGenerations[], int eventCount) {
+     int quantity = ticketQuantities[ticketIndex];
+     int eventIndex = resolveHandle(ticketEventIDs[ticketIndex], eventGenerations, eventCount);
+     
+     string result = "Ticket ID: TKT-" + to_string(ticketIDs[ticketIndex]) + "\n";
+     if (eventIndex != -1) {
+         result += "Event: " + eventNames[eventIndex] + "\n";
+     }
+     if (quantity == 0) {
+         return result + "Status: Cancelled";
+     }
+     result += "Quantity: " + to_string(quantity) + "\n";
+     result += "Seats: " + formatSeats(ticketSeats[ticketIndex], quantity) + "\n";
+     result += "Price Tier: " + getPriceTierName(ticketTiers[ticketIndex]) + " ($" + 
+               to_string(ticketCosts[ticketIndex] / quantity) + " each)\n";
+     result += "Total Cost: $" + to_string(ticketCosts[ticketIndex]);
+     
+     return result;
+ }
+ 
+ string viewUserTickets(int userHandle, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                        int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketSeats[], 
+                        int ticketTiers[], string eventNames[], int ticketCount, int eventGenerations[], 
+                        int eventCount) {
+     bool found = false;
+     
+     cout << "\n" << bright_cyan << bold << "========== MY BOOKINGS ==========\n" << reset;
+     
+     for (int i = 0; i < ticketCount; i++) {
+         if (ticketUserIDs[i] == userHandle) {
+             found = true;
+             cout << "\n" << bright_yellow << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
+             int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+             if (eventIndex != -1) {
+                 cout << cyan << "Event: " << reset << bright_white << eventNames[eventIndex] << reset << endl;
+             }
+             cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
+             if (ticketQuantities[i] > 0) {
+                 cout << cyan << "Seats: " << reset << formatSeats(ticketSeats[i], ticketQuantities[i]) << endl;
+                 cout << cyan << "Price Tier: " << reset << getPriceTierName(ticketTiers[i]) << endl;
+             }
+             cout << cyan << "Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
+             cout << cyan << "Booking Date: " << reset << formatDate(ticketDates[i]) << endl;
+             if (ticketQuantities[i] == 0) {
+                 cout << cyan << "Status: " << reset << red << "Cancelled" << reset << endl;
+             }
+             cout << grey << "--------------------------------" << reset << endl;
+         }
+     }
+     
+     if (!found) {
+         return "\nNo bookings found!";
+     }
+     
+     return "";
+ }
+ 
+ string viewTicketByID(int ticketID, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                       int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketSeats[], 
+                       int ticketTiers[], string eventNames[], string usernames[], string emails[], 
+                       int ticketCount, int eventGenerations[], int eventCount, int userGenerations[], 
+                       int userCount) {
+     for (int i = 0; i < ticketCount; i++) {
+         if (ticketIDs[i] == ticketID) {
+             cout << "\n" << bright_green << bold << "========== OFFICIAL TICKET ==========\n" << reset;
+             cout << bright_yellow << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
+             cout << cyan << "Name: " << reset << bright_white << resolveUsername(ticketUserIDs[i], usernames, userGenerations, userCount) << reset << endl;
+             cout << cyan << "Email: " << reset << resolveEmail(ticketUserIDs[i], emails, userGenerations, userCount) << endl;
+             int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+             if (eventIndex != -1) {
+                 cout << cyan << "Event: " << reset << bright_white << eventNames[eventIndex] << reset << endl;
+             }
+             cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
+             if (ticketQuantities[i] > 0) {
+                 cout << cyan << "Seats: " << reset << formatSeats(ticketSeats[i], ticketQuantities[i]) << endl;
+                 cout << cyan << "Price Tier: " << reset << getPriceTierName(ticketTiers[i]) << endl;
+             }
+             cout << cyan << "Total Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
+             cout << cyan << "Booking Date: " << reset << formatDate(ticketDates[i]) << endl;
+             if (ticketQuantities[i] == 0) {
+                 cout << cyan << "Status: " << reset << red << "Cancelled" << reset << endl;
+             }
+             cout << bright_green << "=====================================\n" << reset;
+             return "";
+         }
+     }
+     
+     return "\nTicket not found!";
+ }
+ 
+ string viewAllRegistrations(int ticketIDs[], int ticketUserIDs[], 
+                             int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                             int ticketDates[], string eventNames[], string usernames[], 
+                             string emails[], int ticketCount, int eventGenerations[], int eventCount, 
+                             int userGenerations[], int userCount) {
+     cout << "\n" << bright_magenta << bold << "========== ALL REGISTRATIONS ==========\n" << reset;
+     
+     if (ticketCount == 0) {
+         return "\nNo registrations found!";
+     }
+     
+     for (int i = 0; i < ticketCount; i++) {
+         cout << "\n" << bright_yellow << "Registration #" << (i + 1) << reset << endl;
+         cout << cyan << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
+         cout << cyan << "User: " << reset << bright_white << resolveUsername(ticketUserIDs[i], usernames, userGenerations, userCount) << reset << endl;
+         cout << cyan << "Email: " << reset << resolveEmail(ticketUserIDs[i], emails, userGenerations, userCount) << endl;
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         if (eventIndex != -1) {
+             cout << cyan << "Event: " << reset << bright_white << eventNames[eventIndex] << reset << endl;
+         }
+         cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
+         cout << cyan << "Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
+         cout << cyan << "Date: " << reset << formatDate(ticketDates[i]) << endl;
+         cout << grey << "--------------------------------" << reset << endl;
+     }
+     
+     return "";
+ }
+ 
+ // Report Functions
+ void generateReports(int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                      int ticketQuantities[], double ticketCosts[], string eventNames[], 
+                      double eventPrices[], int ticketCount, int eventGenerations[], 
+                      int eventCount) {
+     cout << "\n" << bright_magenta << bold << "========== SALES REPORTS & ANALYTICS ==========\n" << reset;
+     
+     double totalRevenue = calculateTotalRevenue(ticketIDs, ticketCosts, ticketCount);
+     int totalBookings = calculateTotalBookings(ticketIDs, ticketQuantities, ticketCount);
+     
+     cout << "\n" << bright_cyan << bold << "--- Overall Statistics ---\n" << reset;
+     cout << cyan << "Total Revenue: " << reset << bright_green << "$" << to_string(totalRevenue) << reset << endl;
+     cout << cyan << "Total Bookings: " << reset << bright_yellow << to_string(totalBookings) << reset << endl;
+     int liveEvents = 0;
+     for (int i = 0; i < eventCount; i++) {
+         if (isSlotLive(i, eventGenerations, eventCount)) {
+             liveEvents++;
+         }
+     }
+     cout << cyan << "Total Events: " << reset << bright_yellow << to_string(liveEvents) << reset << endl;
+     
+     cout << "\n" << bright_cyan << bold << "--- Event-wise Statistics ---\n" << reset;
+     for (int i = 0; i < eventCount; i++) {
+         if (!isSlotLive(i, eventGenerations, eventCount)) {
+             continue;
+         }
+         int handle = makeHandle(i, eventGenerations[i]);
+         int bookings = calculateEventBookings(handle, ticketEventIDs, ticketQuantities, ticketCount);
+         double revenue = 0.0;
+         
+         for (int j = 0; j < ticketCount; j++) {
+             if (ticketEventIDs[j] == handle) {
+                 revenue += ticketCosts[j];
+             }
+         }
+         
+         cout << "\n" << bright_yellow << "Event: " << reset << bright_white << eventNames[i] << reset << endl;
+         cout << cyan << "Bookings: " << reset << to_string(bookings) << endl;
+         cout << cyan << "Revenue: " << reset << bright_green << "$" << to_string(revenue) << reset << endl;
+     }
+     
+     cout << "\n" << bright_magenta << "==========================================\n" << reset;
+ }
+ 
+ double calculateTotalRevenue(int ticketIDs[], double ticketCosts[], int ticketCount) {
+     double total = 0.0;
+     for (int i = 0; i < ticketCount; i++) {
+         total += ticketCosts[i];
+     }
+     return total;
+ }
+ 
+ int calculateTotalBookings(int ticketIDs[], int ticketQuantities[], int ticketCount) {
+     // Cancelled tickets keep their row with a quantity of 0
+     int count = 0;
+     for (int i = 0; i < ticketCount; i++) {
+         if (ticketQuantities[i] > 0) {
+             count++;
+         }
+     }
+     return count;
+ }
+ 
+ int calculateEventBookings(int eventHandle, int ticketEventIDs[], int ticketQuantities[], int ticketCount) {
+     int count = 0;
+     for (int i = 0; i < ticketCount; i++) {
+         if (ticketEventIDs[i] == eventHandle && ticketQuantities[i] > 0) {
+             count++;
+         }
+     }
+     return count;
+ }
+ 
+ 
+ // Cancellation & Waitlist Functions
+ void buildTicketIDTable(int ticketIDTable[], int ticketIDs[], int ticketCount) {
+     for (int i = 0; i < getTicketIDTableSize(); i++) {
+         ticketIDTable[i] = -1;
+     }
+     for (int i = 0; i < ticketCount; i++) {
+         insertTicketID(i, ticketIDTable, ticketIDs);
+     }
+ }
+ 
+ void insertTicketID(int ticketIndex, int ticketIDTable[], int ticketIDs[]) {
+     // Open addressing on the ticket ID, each entry holds the ticket's index in the arrays
+     int slot = ticketIDs[ticketIndex] % getTicketIDTableSize();
+     while (ticketIDTable[slot] != -1 && ticketIDs[ticketIDTable[slot]] != ticketIDs[ticketIndex]) {
+         slot = (slot + 1) % getTicketIDTableSize();
+     }
+     ticketIDTable[slot] = ticketIndex;
+ }
+ 
+ int findTicketIndex(int ticketID, int ticketIDTable[], int ticketIDs[]) {
+     if (ticketID < 0) {
+         return -1;
+     }
+     int slot = ticketID % getTicketIDTableSize();
+     while (ticketIDTable[slot] != -1) {
+         if (ticketIDs[ticketIDTable[slot]] == ticketID) {
+             return ticketIDTable[slot];
+         }
+         slot = (slot + 1) % getTicketIDTableSize();
+     }
+     return -1;
+ }
+ 
+ string cancelTicket(int ticketID, int userHandle, int ticketIDTable[], int ticketIDs[], int ticketUserIDs[], 
+                     int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                     int ticketHours[], int ticketSeats[], int eventAvailable[], double eventPrices[], 
+                     int availableEvents[], int availablePos[], int& availableCount, int eventCapacities[], 
+                     unsigned long long eventSeatMaps[], double eventRevenue[], int eventSeatsSold[], 
+                     int leaderboardRanks[], int leaderboardPos[], int rollupKeys[], double rollupRevenue[], 
+                     int rollupTickets[], int eventGenerations[], int eventFreeCount, int eventCount, 
+                     long long purchaseKeys[], int purchaseCounts[], int& eventIndex) {
+     eventIndex = -1;
+     int ticketIndex = findTicketIndex(ticketID, ticketIDTable, ticketIDs);
+     if (ticketIndex == -1 || ticketUserIDs[ticketIndex] != userHandle) {
+         return "Ticket not found in your bookings!";
+     }
+     if (ticketQuantities[ticketIndex] == 0) {
+         return "Ticket TKT-" + to_string(ticketID) + " is already cancelled!";
+     }
+     int slot = resolveHandle(ticketEventIDs[ticketIndex], eventGenerations, eventCount);
+     if (slot == -1) {
+         return "The event for this ticket no longer exists!";
+     }
      
-     ticketCount++;
+     // Hand the seats back and take the sale out of every running total
+     int quantity = ticketQuantities[ticketIndex];
+     double cost = ticketCosts[ticketIndex];
+     eventAvailable[slot] += quantity;
+     syncAvailableSet(slot, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+     setSeats(slot, ticketSeats[ticketIndex], quantity, false, eventSeatMaps);
+     eventRevenue[slot] -= cost;
+     eventSeatsSold[slot] -= quantity;
+     updateLeaderboards(slot, eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                        leaderboardRanks, leaderboardPos, eventCount - eventFreeCount);
+     recordSale(slot, ticketDates[ticketIndex], ticketHours[ticketIndex], -cost, -quantity, 
+                rollupKeys, rollupRevenue, rollupTickets);
+     addPurchaseCount(userHandle, ticketEventIDs[ticketIndex], -quantity, purchaseKeys, purchaseCounts);
      
-     string result = "Ticket booked successfully!\n";
-     result += "Ticket ID: TKT-" + to_string(ticketIDs[ticketCount - 1]) + "\n";
-     result += "Event: " + eventNames[eventIndex] + "\n";
-     result += "Quantity: " + to_string(quantity) + "\n";
-     result += "Total Cost: $" + to_string(ticketCosts[ticketCount - 1]);
+     // The row stays so the ID is never reused, a quantity of 0 marks it void
+     ticketQuantities[ticketIndex] = 0;
+     ticketCosts[ticketIndex] = 0.0;
+     eventIndex = slot;
+     
+     return "Ticket TKT-" + to_string(ticketID) + " cancelled, " + to_string(quantity) + " seat(s) returned.";
+ }
+ 
+ string joinWaitlist(int eventIndex, int userHandle, int quantity, int waitlistUserIDs[], 
+                     int waitlistQuantities[], int waitlistHeads[], int waitlistSizes[]) {
+     if (waitlistSizes[eventIndex] == getWaitlistCapacity()) {
+         return "The waitlist for this event is full!";
+     }
+     for (int i = 0; i < waitlistSizes[eventIndex]; i++) {
+         int position = eventIndex * getWaitlistCapacity() + (waitlistHeads[eventIndex] + i) % getWaitlistCapacity();
+         if (waitlistUserIDs[position] == userHandle) {
+             return "You are already on the waitlist for this event!";
+         }
+     }
+     
+     int tail = eventIndex * getWaitlistCapacity() + 
+                (waitlistHeads[eventIndex] + waitlistSizes[eventIndex]) % getWaitlistCapacity();
+     waitlistUserIDs[tail] = userHandle;
+     waitlistQuantities[tail] = quantity;
+     waitlistSizes[eventIndex]++;
+     
+     return "Added to the waitlist at position " + to_string(waitlistSizes[eventIndex]) + 
+            ". Your tickets are booked automatically when seats come back.";
+ }
+ 
+ int countWaitingRequests(int waitlistSizes[], int eventCount) {
+     int total = 0;
+     for (int i = 0; i < eventCount; i++) {
+         total += waitlistSizes[i];
+     }
+     return total;
+ }
+ 
+ bool isWaitlistShortOfSeats(int eventIndex, int eventAvailable[], int waitlistQuantities[], int waitlistHeads[], 
+                             int waitlistSizes[]) {
+     // New bookings queue up only while the oldest request is waiting for seats to come back. When it has
+     // enough seats that are just not side by side, holding everyone else back would freeze the event
+     if (waitlistSizes[eventIndex] == 0) {
+         return false;
+     }
+     int head = eventIndex * getWaitlistCapacity() + waitlistHeads[eventIndex];
+     return eventAvailable[eventIndex] < waitlistQuantities[head];
+ }
+ 
+ void removeWaitlistRequest(int eventIndex, int offset, int waitlistUserIDs[], int waitlistQuantities[], 
+                            int waitlistHeads[], int waitlistSizes[]) {
+     // Takes out the request offset places behind the head, the ones in front of it move up one place
+     for (int k = offset; k > 0; k--) {
+         int to = eventIndex * getWaitlistCapacity() + (waitlistHeads[eventIndex] + k) % getWaitlistCapacity();
+         int from = eventIndex * getWaitlistCapacity() + (waitlistHeads[eventIndex] + k - 1) % getWaitlistCapacity();
+         waitlistUserIDs[to] = waitlistUserIDs[from];
+         waitlistQuantities[to] = waitlistQuantities[from];
+     }
+     waitlistHeads[eventIndex] = (waitlistHeads[eventIndex] + 1) % getWaitlistCapacity();
+     waitlistSizes[eventIndex]--;
+ }
+ 
+ string promoteWaitlist(int eventIndex, string eventNames[], double eventPrices[], int eventAvailable[], 
+                        int availableEvents[], int availablePos[], int& availableCount, int eventCapacities[], 
+                        unsigned long long eventSeatMaps[], int eventDates[], int eventTiers[], 
+                        int eventTierSeatLimits[], int eventTierDateLimits[], double eventRevenue[], 
+                        int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], 
+                        int eventGenerations[], int eventFreeCount, int eventCount, int ticketIDs[], 
+                        int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                        double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                        int ticketTiers[], int ticketDateIndex[], int ticketIDTable[], int rollupKeys[], 
+                        double rollupRevenue[], int rollupTickets[], int& ticketCount, 
+                        int lastArchivedTicketID, int waitlistUserIDs[], int waitlistQuantities[], 
+                        int waitlistHeads[], int waitlistSizes[], string usernames[], int userGenerations[], 
+                        int userCount, long long userRateTimes[], long long eventRateTimes[], 
+                        long long purchaseKeys[], int purchaseCounts[]) {
+     // First come first served: the queue stops at the first request there are not enough seats for. A
+     // request that has enough seats but no side-by-side block for them is stepped over, keeping its place,
+     // and up to getWaitlistScanLimit() of those are passed before the queue stops
+     string result = "";
+     int skipped = 0;
+     while (skipped < waitlistSizes[eventIndex] && ticketCount < getMaxTickets()) {
+         int position = eventIndex * getWaitlistCapacity() + 
+                        (waitlistHeads[eventIndex] + skipped) % getWaitlistCapacity();
+         int userHandle = waitlistUserIDs[position];
+         int quantity = waitlistQuantities[position];
+         
+         // Requests of deleted accounts, and of customers who have since reached the per-customer cap, are
+         // dropped, everyone else waits until bookTicket finds enough seats (and, for seated events, enough
+         // of them side by side)
+         int held = getPurchaseCount(userHandle, makeHandle(eventIndex, eventGenerations[eventIndex]), 
+                                     purchaseKeys, purchaseCounts);
+         if (resolveHandle(userHandle, userGenerations, userCount) != -1 && held + quantity <= getTicketCapPerUser()) {
+             int ticketsBefore = ticketCount;
+             bookTicket(userHandle, eventIndex, quantity, eventNames, eventPrices, eventAvailable, 
+                        availableEvents, availablePos, availableCount, eventCapacities, eventSeatMaps, 
+                        eventDates, eventTiers, eventTierSeatLimits, eventTierDateLimits, eventRevenue, 
+                        eventSeatsSold, leaderboardRanks, leaderboardPos, eventGenerations, eventFreeCount, 
+                        eventCount, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                        ticketDates, ticketHours, ticketSeats, ticketTiers, ticketDateIndex, ticketIDTable, 
+                        rollupKeys, rollupRevenue, rollupTickets, ticketCount, lastArchivedTicketID, -1, 
+                        userRateTimes, eventRateTimes, purchaseKeys, purchaseCounts);
+             if (ticketCount == ticketsBefore) {
+                 if (eventAvailable[eventIndex] < quantity || skipped == getWaitlistScanLimit()) {
+                     break;
+                 }
+                 skipped++;
+                 continue;
+             }
+             result += "\nWaitlist: TKT-" + to_string(ticketIDs[ticketCount - 1]) + " booked for " + 
+                       resolveUsername(userHandle, usernames, userGenerations, userCount) + " (" + 
+                       to_string(quantity) + " seat(s), " + formatSeats(ticketSeats[ticketCount - 1], 
+                       quantity) + ")";
+         }
+         removeWaitlistRequest(eventIndex, skipped, waitlistUserIDs, waitlistQuantities, waitlistHeads, 
+                               waitlistSizes);
+     }
+     if (waitlistSizes[eventIndex] == 0) {
+         waitlistHeads[eventIndex] = 0;
+     }
+     return result;
+ }
+ 
+ // Seat Map Functions
+ int getSeatRowCount(int capacity) {
+     // Events too big for the map are general admission and have no rows
+     if (capacity <= 0 || capacity > getSeatsPerRow() * getMaxSeatRows()) {
+         return 0;
+     }
+     return (capacity + getSeatsPerRow() - 1) / getSeatsPerRow();
+ }
+ 
+ unsigned long long getSeatRowMask(int row, int capacity) {
+     int seats = min(getSeatsPerRow(), capacity - row * getSeatsPerRow());
+     if (seats <= 0) {
+         return 0;
+     }
+     return seats == 64 ? ~0ULL : (1ULL << seats) - 1;
+ }
+ 
+ int findSeatBlock(int eventIndex, int quantity, unsigned long long eventSeatMaps[], int eventCapacities[]) {
+     if (quantity <= 0 || quantity > getSeatsPerRow()) {
+         return -1;
+     }
+     
+     int rows = getSeatRowCount(eventCapacities[eventIndex]);
+     for (int row = 0; row < rows; row++) {
+         unsigned long long runs = ~eventSeatMaps[eventIndex * getMaxSeatRows() + row] & 
+                                   getSeatRowMask(row, eventCapacities[eventIndex]);
+         
+         // After the loop bit c survives only if seats c .. c + quantity - 1 are all free. Each step
+         // doubles the run length already checked, so a block of N costs log2(N) shifts per row
+         int have = 1;
+         while (runs != 0 && have < quantity) {
+             int step = min(have, quantity - have);
+             runs &= runs >> step;
+             have += step;
+         }
+         if (runs != 0) {
+             return row * getSeatsPerRow() + __builtin_ctzll(runs);
+         }
+     }
+     return -1;
+ }
+ 
+ int getLargestSeatBlock(int eventIndex, unsigned long long eventSeatMaps[], int eventCapacities[]) {
+     int largest = 0;
+     int rows = getSeatRowCount(eventCapacities[eventIndex]);
+     for (int row = 0; row < rows; row++) {
+         unsigned long long runs = ~eventSeatMaps[eventIndex * getMaxSeatRows() + row] & 
+                                   getSeatRowMask(row, eventCapacities[eventIndex]);
+         
+         // Every pass shortens each run of free seats by one, so the pass count is the longest run
+         int length = 0;
+         while (runs != 0) {
+             runs &= runs >> 1;
+             length++;
+         }
+         largest = max(largest, length);
+     }
+     return largest;
+ }
+ 
+ void setSeats(int eventIndex, int firstSeat, int quantity, bool taken, unsigned long long eventSeatMaps[]) {
+     if (firstSeat < 0 || quantity <= 0) {
+         return;
+     }
+     
+     int row = firstSeat / getSeatsPerRow();
+     int column = firstSeat % getSeatsPerRow();
+     unsigned long long block = (quantity == 64 ? ~0ULL : (1ULL << quantity) - 1) << column;
+     if (taken) {
+         eventSeatMaps[eventIndex * getMaxSeatRows() + row] |= block;
+     } else {
+         eventSeatMaps[eventIndex * getMaxSeatRows() + row] &= ~block;
+     }
+ }
+ 
+ void clearSeatMap(int eventIndex, unsigned long long eventSeatMaps[]) {
+     for (int row = 0; row < getMaxSeatRows(); row++) {
+         eventSeatMaps[eventIndex * getMaxSeatRows() + row] = 0;
+     }
+ }
+ 
+ string formatSeats(int firstSeat, int quantity) {
+     if (firstSeat < 0) {
+         return "General Admission";
+     }
+     
+     int row = firstSeat / getSeatsPerRow();
+     int column = firstSeat % getSeatsPerRow();
+     string result = "Section " + string(1, (char)('A' + row / getRowsPerSection()));
+     result += ", Row " + to_string(row % getRowsPerSection() + 1);
+     if (quantity == 1) {
+         return result + ", Seat " + to_string(column + 1);
+     }
+     return result + ", Seats " + to_string(column + 1) + "-" + to_string(column + quantity);
+ }
+ 
+ void printSeatMap(int eventIndex, unsigned long long eventSeatMaps[], int eventCapacities[]) {
+     int rows = getSeatRowCount(eventCapacities[eventIndex]);
+     
+     cout << "\n" << bright_cyan << bold << "========== SEAT MAP ==========\n" << reset;
+     cout << grey << ". free   X taken" << reset << endl;
+     for (int row = 0; row < rows; row++) {
+         if (row % getRowsPerSection() == 0) {
+             cout << bright_yellow << "Section " << (char)('A' + row / getRowsPerSection()) << reset << endl;
+         }
+         unsigned long long taken = eventSeatMaps[eventIndex * getMaxSeatRows() + row];
+         unsigned long long mask = getSeatRowMask(row, eventCapacities[eventIndex]);
+         cout << cyan << "Row " << (row % getRowsPerSection() + 1) << (row % getRowsPerSection() + 1 < 10 ? "  " : " ") << reset;
+         for (int column = 0; column < getSeatsPerRow() && ((mask >> column) & 1); column++) {
+             if ((taken >> column) & 1) {
+                 cout << red << "X" << reset;
+             } else {
+                 cout << green << "." << reset;
+             }
+         }
+         cout << endl;
+     }
+ }
+ 
+ // Price Tier Functions
+ string getPriceTierName(int tier) {
+     if (tier == 0) {
+         return "Early Bird";
+     }
+     if (tier == 2) {
+         return "Last Seats";
+     }
+     return "Standard";
+ }
+ 
+ double getPriceTierMultiplier(int tier) {
+     const double multipliers[3] = {0.8, 1.0, 1.25};
+     return multipliers[tier];
+ }
+ 
+ int getLastSeatsLimit(int capacity) {
+     return min(getLastSeatsCount(), capacity / 10);
+ }
+ 
+ double getTierPrice(int eventIndex, double eventPrices[], int eventTiers[]) {
+     return eventPrices[eventIndex] * getPriceTierMultiplier(eventTiers[eventIndex]);
+ }
+ 
+ int getSeatsAtTierPrice(int eventIndex, int quantity, int eventAvailable[], int eventTiers[], 
+                         int eventTierSeatLimits[]) {
+     // Seats of one order sold before eventAvailable reaches the last seats limit, the rest are last seats
+     if (eventTiers[eventIndex] == 2 || eventTierSeatLimits[eventIndex] < 0) {
+         return quantity;
+     }
+     return max(0, min(quantity, eventAvailable[eventIndex] - eventTierSeatLimits[eventIndex]));
+ }
+ 
+ double getOrderCost(int eventIndex, int quantity, double eventPrices[], int eventAvailable[], int eventTiers[], 
+                     int eventTierSeatLimits[]) {
+     // An order that crosses into the last seats pays the cached tier up to the boundary and the last
+     // seats price after it, still two lookups rather than a price per seat
+     int tierSeats = getSeatsAtTierPrice(eventIndex, quantity, eventAvailable, eventTiers, eventTierSeatLimits);
+     return getTierPrice(eventIndex, eventPrices, eventTiers) * tierSeats + 
+            eventPrices[eventIndex] * getPriceTierMultiplier(2) * (quantity - tierSeats);
+ }
+ 
+ void updatePriceTier(int eventIndex, int today, int eventDates[], int eventCapacities[], int eventAvailable[], 
+                      int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[]) {
+     int lastSeats = getLastSeatsLimit(eventCapacities[eventIndex]);
+     int earlyBirdEnd = eventDates[eventIndex] - getEarlyBirdDays();
+     
+     // Besides the tier, note the next seat count and date at which it could change. Bookings only
+     // lower the seat count and the date only moves forward, so leaving the last seats tier takes a
+     // cancellation or an admin edit, and those call this directly
+     if (eventAvailable[eventIndex] <= lastSeats) {
+         eventTiers[eventIndex] = 2;
+         eventTierSeatLimits[eventIndex] = -1;
+         eventTierDateLimits[eventIndex] = numeric_limits<int>::max();
+     } else if (today < earlyBirdEnd) {
+         eventTiers[eventIndex] = 0;
+         eventTierSeatLimits[eventIndex] = lastSeats;
+         eventTierDateLimits[eventIndex] = earlyBirdEnd;
+     } else {
+         eventTiers[eventIndex] = 1;
+         eventTierSeatLimits[eventIndex] = lastSeats;
+         eventTierDateLimits[eventIndex] = numeric_limits<int>::max();
+     }
+ }
+ 
+ void buildPriceTiers(int today, int eventDates[], int eventCapacities[], int eventAvailable[], 
+                      int eventTiers[], int eventTierSeatLimits[], int eventTierDateLimits[], 
+                      int eventGenerations[], int eventCount) {
+     for (int i = 0; i < eventCount; i++) {
+         if (isSlotLive(i, eventGenerations, eventCount)) {
+             updatePriceTier(i, today, eventDates, eventCapacities, eventAvailable, eventTiers, 
+                             eventTierSeatLimits, eventTierDateLimits);
+         }
+     }
+ }
+ 
+ // Request Key Functions
+ unsigned long long hashRequestKey(string requestKey, int userHandle) {
+     // FNV-1a over the key and the user, so two customers that pick the same key never collide
+     string text = requestKey + "|" + to_string(userHandle);
+     unsigned long long hash = 14695981039346656037ULL;
+     for (int i = 0; i < (int)text.length(); i++) {
+         hash ^= (unsigned char)text[i];
+         hash *= 1099511628211ULL;
+     }
+     return hash == 0 ? 1 : hash;  // 0 marks an empty slot
+ }
+ 
+ void clearRequestKeys(unsigned long long requestKeyHashes[], int requestKeyTicketIDs[], 
+                       long long requestKeyTimes[]) {
+     for (int i = 0; i < getRequestKeyTableSize(); i++) {
+         requestKeyHashes[i] = 0;
+         requestKeyTicketIDs[i] = -1;
+         requestKeyTimes[i] = 0;
+     }
+ }
+ 
+ int findRequestKey(unsigned long long keyHash, long long now, unsigned long long requestKeyHashes[], 
+                    int requestKeyTicketIDs[], long long requestKeyTimes[]) {
+     int home = (int)(keyHash % getRequestKeyTableSize());
+     for (int probe = 0; probe < getRequestKeyProbes(); probe++) {
+         int slot = (home + probe) % getRequestKeyTableSize();
+         if (requestKeyHashes[slot] == keyHash && now - requestKeyTimes[slot] < getRequestKeySeconds()) {
+             return requestKeyTicketIDs[slot];
+         }
+     }
+     return -1;
+ }
+ 
+ void rememberRequestKey(unsigned long long keyHash, int ticketID, long long now, 
+                         unsigned long long requestKeyHashes[], int requestKeyTicketIDs[], 
+                         long long requestKeyTimes[]) {
+     // Take the first free or expired slot in the probe window, or else the oldest one. Memory stays
+     // fixed however many keys arrive, a key is only lost early if its whole window is busier than that
+     int home = (int)(keyHash % getRequestKeyTableSize());
+     int victim = home;
+     for (int probe = 0; probe < getRequestKeyProbes(); probe++) {
+         int slot = (home + probe) % getRequestKeyTableSize();
+         if (requestKeyHashes[slot] == 0 || now - requestKeyTimes[slot] >= getRequestKeySeconds()) {
+             victim = slot;
+             break;
+         }
+         if (requestKeyTimes[slot] < requestKeyTimes[victim]) {
+             victim = slot;
+         }
+     }
+     requestKeyHashes[victim] = keyHash;
+     requestKeyTicketIDs[victim] = ticketID;
+     requestKeyTimes[victim] = now;
+ }
+ 
+ string repeatBooking(int ticketID, int eventIndex, int ticketIDTable[], string eventNames[], int ticketIDs[], 
+                      int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketSeats[], 
+                      int ticketTiers[], int eventGenerations[], int eventCount) {
+     int ticketIndex = findTicketIndex(ticketID, ticketIDTable, ticketIDs);
+     if (ticketIndex == -1) {
+         return "Request already handled as TKT-" + to_string(ticketID) + ", no new ticket booked!";
+     }
+     if (resolveHandle(ticketEventIDs[ticketIndex], eventGenerations, eventCount) != eventIndex) {
+         return "This request key was already used for another event!";
+     }
+     return "Request already handled, no new ticket booked!\n" + 
+            formatBookingResult(ticketIndex, eventNames, ticketIDs, ticketEventIDs, ticketQuantities, 
+                                ticketCosts, ticketSeats, ticketTiers, eventGenerations, eventCount);
+ }
+ 
+ // Purchase Limit Functions
+ void clearRateLimits(long long rateTimes[], int count) {
+     for (int i = 0; i < count; i++) {
+         rateTimes[i] = 0;
+     }
+ }
+ 
+ bool takeRateToken(long long& rateTime, long long now, int interval, int burst) {
+     // A token bucket in one number: rateTime is when the bucket is full again, each booking pushes it
+     // one interval later, and a booking is refused while that would be more than the burst ahead of now
+     long long fullAt = max(rateTime, now);
+     if (fullAt + interval - now > (long long)interval * burst) {
+         return false;
+     }
+     rateTime = fullAt + interval;
+     return true;
+ }
+ 
+ long long makePurchaseKey(int userHandle, int eventHandle) {
+     return ((long long)userHandle << 32) | (unsigned int)eventHandle;
+ }
+ 
+ int findPurchaseSlot(long long key, long long purchaseKeys[]) {
+     // Open addressing like the ticket ID table, returns the pair's slot or the empty slot it would go in
+     int slot = (int)(((unsigned long long)key * 11400714819323198485ULL) % getPurchaseTableSize());
+     while (purchaseKeys[slot] != -1 && purchaseKeys[slot] != key) {
+         slot = (slot + 1) % getPurchaseTableSize();
+     }
+     return slot;
+ }
+ 
+ int getPurchaseCount(int userHandle, int eventHandle, long long purchaseKeys[], int purchaseCounts[]) {
+     long long key = makePurchaseKey(userHandle, eventHandle);
+     int slot = findPurchaseSlot(key, purchaseKeys);
+     return purchaseKeys[slot] == key ? purchaseCounts[slot] : 0;
+ }
+ 
+ void addPurchaseCount(int userHandle, int eventHandle, int quantity, long long purchaseKeys[], 
+                       int purchaseCounts[]) {
+     long long key = makePurchaseKey(userHandle, eventHandle);
+     int slot = findPurchaseSlot(key, purchaseKeys);
+     if (purchaseKeys[slot] != key) {
+         purchaseKeys[slot] = key;
+         purchaseCounts[slot] = 0;
+     }
+     purchaseCounts[slot] += quantity;
+ }
+ 
+ void buildPurchaseCounts(long long purchaseKeys[], int purchaseCounts[], int ticketUserIDs[], 
+                          int ticketEventIDs[], int ticketQuantities[], int ticketCount) {
+     for (int i = 0; i < getPurchaseTableSize(); i++) {
+         purchaseKeys[i] = -1;
+         purchaseCounts[i] = 0;
+     }
+     for (int i = 0; i < ticketCount; i++) {
+         if (ticketQuantities[i] > 0) {
+             addPurchaseCount(ticketUserIDs[i], ticketEventIDs[i], ticketQuantities[i], purchaseKeys, 
+                              purchaseCounts);
+         }
+     }
+ }
+ 
+ // Check-In Functions
+ unsigned long long hashTicketID(int ticketID) {
+     // splitmix64 finalizer, sequential IDs come out spread over the whole filter
+     unsigned long long hash = (unsigned long long)ticketID + 0x9E3779B97F4A7C15ULL;
+     hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+     hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+     return hash ^ (hash >> 31);
+ }
+ 
+ void addToBloomFilter(int ticketID, unsigned long long checkInBloom[]) {
+     // Bit k is low + k * high, so one hash gives every probe
+     unsigned long long hash = hashTicketID(ticketID);
+     unsigned long long low = hash & 0xFFFFFFFFULL;
+     unsigned long long step = (hash >> 32) | 1;
+     unsigned long long bits = (unsigned long long)getBloomFilterWords() * 64;
+     for (int k = 0; k < getBloomHashCount(); k++) {
+         unsigned long long bit = (low + k * step) % bits;
+         checkInBloom[bit / 64] |= 1ULL << (bit % 64);
+     }
+ }
+ 
+ bool mayContainTicketID(int ticketID, unsigned long long checkInBloom[]) {
+     // A forged ID usually stops at the first clear bit
+     unsigned long long hash = hashTicketID(ticketID);
+     unsigned long long low = hash & 0xFFFFFFFFULL;
+     unsigned long long step = (hash >> 32) | 1;
+     unsigned long long bits = (unsigned long long)getBloomFilterWords() * 64;
+     for (int k = 0; k < getBloomHashCount(); k++) {
+         unsigned long long bit = (low + k * step) % bits;
+         if ((checkInBloom[bit / 64] & (1ULL << (bit % 64))) == 0) {
+             return false;
+         }
+     }
+     return true;
+ }
+ 
+ void syncCheckInTables(unsigned long long checkInBloom[], unsigned long long checkInBitmap[], int ticketIDs[], 
+                        int ticketCount, int lastArchivedTicketID, long long checkInState[]) {
+     // New tickets are only ever appended, so only the rows added since the last sync go in. Archiving takes
+     // rows out and a Bloom filter cannot forget, so after an archive it is rebuilt. The lowest live ticket ID
+     // can only move then too, and the bitmap is replayed from checkins.txt starting at it
+     if (checkInState[0] == -1 || checkInState[0] > ticketCount || checkInState[1] != lastArchivedTicketID) {
+         for (int i = 0; i < getBloomFilterWords(); i++) {
+             checkInBloom[i] = 0;
+         }
+         // Tickets of future events stay behind when their older neighbours are archived, so the lowest live ID
+         // can sit below lastArchivedTicketID
+         int first = max(1001, lastArchivedTicketID + 1);
+         for (int i = 0; i < ticketCount; i++) {
+             first = min(first, ticketIDs[i]);
+         }
+         loadCheckInLog(checkInBitmap, first);
+         checkInState[0] = 0;
+         checkInState[1] = lastArchivedTicketID;
+         checkInState[8] = first;
+     }
+     for (int i = (int)checkInState[0]; i < ticketCount; i++) {
+         addToBloomFilter(ticketIDs[i], checkInBloom);
+     }
+     checkInState[0] = ticketCount;
+ }
+ 
+ void loadCheckInLog(unsigned long long checkInBitmap[], int firstTicketID) {
+     // checkins.txt: result|ticketID|seconds per scan, only admitted scans (A) of live IDs set a bit
+     for (int i = 0; i < getCheckInWords(); i++) {
+         checkInBitmap[i] = 0;
+     }
+     ifstream file("checkins.txt");
+     string line;
+     while (getline(file, line)) {
+         int starts[3];
+         int ends[3];
+         if (splitColumns(line, starts, ends, 3) != 3 || line[0] != 'A') {
+             continue;
+         }
+         int bit = readIntColumn(line, starts[1], ends[1]) - firstTicketID;
+         if (bit >= 0 && bit < getCheckInSpan()) {
+             checkInBitmap[bit / 64] |= 1ULL << (bit % 64);
+         }
+     }
+     file.close();
+ }
+ 
+ int checkInTicket(int ticketID, int gateEvent, unsigned long long checkInBloom[], unsigned long long checkInBitmap[], 
+                   int ticketIDTable[], int ticketIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                   int eventGenerations[], int eventCount, long long checkInState[]) {
+     if (!mayContainTicketID(ticketID, checkInBloom)) {
+         return 2;
+     }
+     long long bit = ticketID - checkInState[8];
+     if (bit < 0 || bit >= getCheckInSpan()) {
+         return 5;
+     }
+     unsigned long long mask = 1ULL << (bit % 64);
+     if (checkInBitmap[bit / 64] & mask) {
+         return 1;
+     }
+     
+     // Only IDs that got past the filter reach the ticket table, which also catches its false positives
+     int index = findTicketIndex(ticketID, ticketIDTable, ticketIDs);
+     if (index == -1) {
+         return 2;
+     }
+     int eventIndex = resolveHandle(ticketEventIDs[index], eventGenerations, eventCount);
+     if (ticketQuantities[index] == 0 || eventIndex == -1) {
+         return 3;
+     }
+     if (gateEvent != -1 && eventIndex != gateEvent) {
+         return 4;
+     }
+     checkInBitmap[bit / 64] |= mask;
+     return 0;
+ }
+ 
+ string getCheckInResultName(int result) {
+     string names[] = {"Admitted", "Already checked in", "Unknown ticket", "Cancelled ticket", 
+                       "Ticket for another event", "Outside the gate range"};
+     return names[result];
+ }
+ 
+ string checkInBatch(string scans, int gateEvent, unsigned long long checkInBloom[], 
+                     unsigned long long checkInBitmap[], int ticketIDTable[], int ticketIDs[], int ticketEventIDs[], 
+                     int ticketQuantities[], int eventGenerations[], int eventCount, long long checkInState[], 
+                     ofstream& checkInLog, long long metricBuckets[], long long metricStats[]) {
+     // Scans are separated by spaces, commas or tabs. The whole batch goes to checkins.txt in one write
+     if (!checkInLog.is_open()) {
+         checkInLog.open("checkins.txt", ios::app);
+     }
+     string letters = "ADUVWR";
+     string seconds = to_string(getWallMillis() / 1000);
+     string logLines = "";
+     string rejections = "";
+     int counts[6] = {0, 0, 0, 0, 0, 0};
+     int length = (int)scans.length();
+     int i = 0;
+     while (i < length) {
+         if (scans[i] == ' ' || scans[i] == ',' || scans[i] == '\t' || scans[i] == '\r') {
+             i++;
+             continue;
+         }
+         int start = i;
+         while (i < length && scans[i] != ' ' && scans[i] != ',' && scans[i] != '\t' && scans[i] != '\r') {
+             i++;
+         }
+         
+         long long scanStart = getMicros();
+         // Anything that is not a plain ticket number is rejected without a lookup
+         int result = 2;
+         bool numeric = i - start <= 9;
+         for (int c = start; c < i && numeric; c++) {
+             numeric = scans[c] >= '0' && scans[c] <= '9';
+         }
+         string token = numeric ? scans.substr(start, i - start) : "?";
+         if (numeric) {
+             result = checkInTicket(readIntColumn(scans, start, i), gateEvent, checkInBloom, checkInBitmap, 
+                                    ticketIDTable, ticketIDs, ticketEventIDs, ticketQuantities, eventGenerations, 
+                                    eventCount, checkInState);
+         }
+         string line = letters.substr(result, 1) + "|" + token + "|" + seconds + "\n";
+         logLines += line;
+         recordMetric(14, getMicros() - scanStart, (long long)line.length(), metricBuckets, metricStats);
+         
+         counts[result]++;
+         checkInState[2 + result]++;
+         if (result != 0) {
+             rejections += "  " + scans.substr(start, i - start) + " - " + getCheckInResultName(result) + "\n";
+         }
+     }
+     checkInLog << logLines;
+     checkInLog.flush();
+     
+     int scanned = counts[0] + counts[1] + counts[2] + counts[3] + counts[4] + counts[5];
+     if (scanned == 0) {
+         return "No ticket IDs in that line.\n";
+     }
+     if (scanned == counts[0]) {
+         return to_string(scanned) + " scanned, all admitted.\n";
+     }
+     return to_string(scanned) + " scanned, " + to_string(counts[0]) + " admitted, " + 
+            to_string(scanned - counts[0]) + " rejected:\n" + rejections;
+ }
+ 
+ // Bulk Update Functions
+ int selectEvents(string category, string venue, int fromDate, int toDate, string eventCategories[], 
+                  string eventVenues[], int eventDates[], int eventGenerations[], int eventCount, int selected[]) {
+     // Category and venue must match exactly so a bulk delete never catches a similar name, empty means any
+     int matches = 0;
+     for (int i = 0; i < eventCount; i++) {
+         selected[i] = eventGenerations[i] % 2 == 0 && eventDates[i] >= fromDate && eventDates[i] <= toDate;
+         if (selected[i] && category != "" && eventCategories[i] != category) {
+             selected[i] = 0;
+         }
+         if (selected[i] && venue != "" && eventVenues[i] != venue) {
+             selected[i] = 0;
+         }
+         matches += selected[i];
+     }
+     return matches;
+ }
+ 
+ int removeSelected(int index[], int count, int selected[]) {
+     // Drops the selected ids from a sorted index in one pass, the rest keep their order
+     int kept = 0;
+     for (int i = 0; i < count; i++) {
+         if (!selected[index[i]]) {
+             index[kept] = index[i];
+             kept++;
+         }
+     }
+     return kept;
+ }
+ 
+ string bulkUpdateEvents(int action, double amount, int selected[], string eventNames[], int eventDates[], 
+                         string eventVenues[], string eventCategories[], double eventPrices[], 
+                         int eventCapacities[], int eventAvailable[], int eventDateIndex[], int eventPriceIndex[], 
+                         int availableEvents[], int availablePos[], int& availableCount, double eventRevenue[], 
+                         int eventSeatsSold[], int leaderboardRanks[], int leaderboardPos[], int rollupKeys[], 
+                         double rollupRevenue[], int rollupTickets[], int eventTiers[], int eventTierSeatLimits[], 
+                         int eventTierDateLimits[], unsigned long long eventSeatMaps[], int waitlistHeads[], 
+                         int waitlistSizes[], int eventGenerations[], int eventFreeList[], int& eventFreeCount, 
+                         int eventCount) {
+     // The columns are changed for every selected slot in one pass, then each index is repaired once
+     // instead of once per event
+     int liveCount = eventCount - eventFreeCount;
+     int matches = 0;
+     for (int i = 0; i < eventCount; i++) {
+         matches += selected[i];
+     }
+     if (matches == 0) {
+         return "No events match!";
+     }
+     
+     if (action == 0) {
+         // No branch on the mask, so the loop vectorizes; prices are rounded to the cent
+         for (int i = 0; i < eventCount; i++) {
+             double scaled = (long long)(eventPrices[i] * amount * 100 + 0.5) / 100.0;
+             eventPrices[i] = selected[i] ? scaled : eventPrices[i];
+         }
+         stable_sort(eventPriceIndex, eventPriceIndex + liveCount, [eventPrices](int a, int b) {
+             return eventPrices[a] < eventPrices[b];
+         });
+         sortAvailableSet(eventPrices, availableEvents, availablePos, availableCount);
+         return "Repriced " + to_string(matches) + " events!";
+     }
+     
+     if (action == 1) {
+         // A seated event grown past the seat map would quietly turn into general admission and forget which
+         // seats are sold, so the whole update is refused instead
+         int seats = (int)amount;
+         int seatLimit = getSeatsPerRow() * getMaxSeatRows();
+         int tooBig = 0;
+         for (int i = 0; i < eventCount; i++) {
+             if (selected[i] && getSeatRowCount(eventCapacities[i]) > 0 && eventCapacities[i] + seats > seatLimit) {
+                 tooBig++;
+             }
+         }
+         if (tooBig > 0) {
+             return "Cannot add " + to_string(seats) + " seats: " + to_string(tooBig) + 
+                    " seated events would pass the " + to_string(seatLimit) + " seat map limit!";
+         }
+         
+         // Capacity and available seats grow together, so the seats already sold stay the same
+         for (int i = 0; i < eventCount; i++) {
+             eventCapacities[i] += selected[i] * seats;
+             eventAvailable[i] += selected[i] * seats;
+         }
+         int today = getCurrentDate();
+         for (int i = 0; i < eventCount; i++) {
+             if (selected[i]) {
+                 syncAvailableSet(i, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+                 updatePriceTier(i, today, eventDates, eventCapacities, eventAvailable, eventTiers, 
+                                 eventTierSeatLimits, eventTierDateLimits);
+             }
+         }
+         rankLeaderboards(eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                          leaderboardPos, eventGenerations, eventCount);
+         return "Added " + to_string(seats) + " seats to " + to_string(matches) + " events!";
+     }
+     
+     // Delete: every selected slot is tombstoned like deleteEvent, with its queue, seat map and rollups
+     removeSelected(eventDateIndex, liveCount, selected);
+     removeSelected(eventPriceIndex, liveCount, selected);
+     for (int i = 0; i < eventCount; i++) {
+         if (!selected[i]) {
+             continue;
+         }
+         clearEventRow(i, eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                       eventAvailable);
+         syncAvailableSet(i, eventAvailable, eventPrices, availableEvents, availablePos, availableCount);
+         eventRevenue[i] = 0.0;
+         eventSeatsSold[i] = 0;
+         for (int level = 0; level < 2; level++) {
+             int start = getRollupRingStart(level, i);
+             for (int j = 0; j < getRollupRingSize(level, i); j++) {
+                 rollupKeys[start + j] = -1;
+                 rollupRevenue[start + j] = 0.0;
+                 rollupTickets[start + j] = 0;
+             }
+         }
+         clearSeatMap(i, eventSeatMaps);
+         waitlistHeads[i] = 0;
+         waitlistSizes[i] = 0;
+         releaseSlot(i, eventGenerations, eventFreeList, eventFreeCount);
+     }
+     rankLeaderboards(eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, leaderboardRanks, 
+                      leaderboardPos, eventGenerations, eventCount);
+     return "Deleted " + to_string(matches) + " events!";
+ }
+ 
+ // Persistence Functions
+ void snapshotUsers(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                    int userCount, string snapshotUsernames[], string snapshotPasswords[], 
+                    string snapshotEmails[], int snapshotUserGenerations[], int snapshotCounts[], 
+                    long long persistState[], mutex& persistLock, condition_variable& persistSignal) {
+     lock_guard<mutex> lock(persistLock);
+     int first = (int)persistState[0] * getMaxUsers();
+     for (int i = 0; i < userCount; i++) {
+         snapshotUsernames[first + i] = usernames[i];
+         snapshotPasswords[first + i] = passwords[i];
+         snapshotEmails[first + i] = emails[i];
+         snapshotUserGenerations[first + i] = userGenerations[i];
+     }
+     snapshotCounts[persistState[0] * 3] = userCount;
+     persistState[1] |= 1;
+     persistSignal.notify_all();
+ }
+ 
+ void snapshotEvents(int changedSlot, string eventNames[], int eventDates[], string eventVenues[], 
+                     string eventCategories[], double eventPrices[], int eventCapacities[], 
+                     int eventAvailable[], int eventGenerations[], unsigned long long eventSeatMaps[], 
+                     int eventCount, string snapshotEventNames[], 
+                     int snapshotEventDates[], string snapshotEventVenues[], string snapshotEventCategories[], 
+                     double snapshotEventPrices[], int snapshotEventCapacities[], int snapshotEventAvailable[], 
+                     int snapshotEventGenerations[], unsigned long long snapshotEventSeatMaps[], 
+                     int snapshotCounts[], int snapshotEventsDirty[], long long persistState[], 
+                     mutex& persistLock, condition_variable& persistSignal) {
+     lock_guard<mutex> lock(persistLock);
+     int first = (int)persistState[0] * getMaxEvents();
+     for (int i = 0; i < eventCount; i++) {
+         snapshotEventNames[first + i] = eventNames[i];
+         snapshotEventDates[first + i] = eventDates[i];
+         snapshotEventVenues[first + i] = eventVenues[i];
+         snapshotEventCategories[first + i] = eventCategories[i];
+         snapshotEventPrices[first + i] = eventPrices[i];
+         snapshotEventCapacities[first + i] = eventCapacities[i];
+         snapshotEventAvailable[first + i] = eventAvailable[i];
+         snapshotEventGenerations[first + i] = eventGenerations[i];
+     }
+     for (int i = 0; i < eventCount * getMaxSeatRows(); i++) {
+         snapshotEventSeatMaps[first * getMaxSeatRows() + i] = eventSeatMaps[i];
+     }
+     snapshotCounts[persistState[0] * 3 + 1] = eventCount;
+     
+     // Flag the partition holding the changed slot, or all of them, for the next write of this buffer
+     int dirty = (int)persistState[0] * getMaxEventPartitions();
+     for (int k = 0; k < getMaxEventPartitions(); k++) {
+         if (changedSlot == -1 || changedSlot / getEventPartitionSize() == k) {
+             snapshotEventsDirty[dirty + k] = 1;
+         }
+     }
+     persistState[1] |= 2;
+     persistSignal.notify_all();
+ }
+ 
+ void snapshotTickets(int changedFrom, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                      int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                      int ticketSeats[], int ticketTiers[], int ticketCount, int snapshotTicketIDs[], 
+                      int snapshotTicketUserIDs[], int snapshotTicketEventIDs[], 
+                      int snapshotTicketQuantities[], double snapshotTicketCosts[], int snapshotTicketDates[], 
+                      int snapshotTicketHours[], int snapshotTicketSeats[], int snapshotTicketTiers[], 
+                      int snapshotCounts[], int snapshotTicketsValid[], int snapshotTicketsDirty[], 
+                      long long persistState[], mutex& persistLock, condition_variable& persistSignal) {
+     // snapshotTicketsValid[b] is how many leading tickets of buffer b still match the live arrays,
+     // so a booking only copies the new ticket instead of the whole history
+     lock_guard<mutex> lock(persistLock);
+     int buffer = (int)persistState[0];
+     snapshotTicketsValid[0] = min(snapshotTicketsValid[0], changedFrom);
+     snapshotTicketsValid[1] = min(snapshotTicketsValid[1], changedFrom);
+     int first = buffer * getMaxTickets();
+     for (int i = snapshotTicketsValid[buffer]; i < ticketCount; i++) {
+         snapshotTicketIDs[first + i] = ticketIDs[i];
+         snapshotTicketUserIDs[first + i] = ticketUserIDs[i];
+         snapshotTicketEventIDs[first + i] = ticketEventIDs[i];
+         snapshotTicketQuantities[first + i] = ticketQuantities[i];
+         snapshotTicketCosts[first + i] = ticketCosts[i];
+         snapshotTicketDates[first + i] = ticketDates[i];
+         snapshotTicketHours[first + i] = ticketHours[i];
+         snapshotTicketSeats[first + i] = ticketSeats[i];
+         snapshotTicketTiers[first + i] = ticketTiers[i];
+     }
+     snapshotTicketsValid[buffer] = ticketCount;
+     snapshotTicketsDirty[buffer] = min(snapshotTicketsDirty[buffer], changedFrom);
+     snapshotCounts[buffer * 3 + 2] = ticketCount;
+     persistState[1] |= 4;
+     persistSignal.notify_all();
+ }
+ 
+ void runPersistenceWorker(string snapshotUsernames[], string snapshotPasswords[], string snapshotEmails[], 
+                           int snapshotUserGenerations[], string snapshotEventNames[], 
+                           int snapshotEventDates[], string snapshotEventVenues[], 
+                           string snapshotEventCategories[], double snapshotEventPrices[], 
+                           int snapshotEventCapacities[], int snapshotEventAvailable[], 
+                           int snapshotEventGenerations[], unsigned long long snapshotEventSeatMaps[], 
+                           int snapshotTicketIDs[], int snapshotTicketUserIDs[], int snapshotTicketEventIDs[], 
+                           int snapshotTicketQuantities[], double snapshotTicketCosts[], 
+                           int snapshotTicketDates[], int snapshotTicketHours[], int snapshotTicketSeats[], 
+                           int snapshotTicketTiers[], int snapshotCounts[], int snapshotEventsDirty[], 
+                           int snapshotTicketsDirty[], int snapshotSeatSlots[], int snapshotSeatCounts[], 
+                           int snapshotWaitlistEventIDs[], int snapshotWaitlistUserIDs[], 
+                           int snapshotWaitlistQuantities[], int snapshotWaitlistCounts[], 
+                           long long persistState[], mutex& persistLock, condition_variable& persistSignal, 
+                           long long metricBuckets[], long long metricStats[], long long traceSpans[], 
+                           long long& traceCount) {
+     unique_lock<mutex> lock(persistLock);
+     while (true) {
+         persistSignal.wait(lock, [persistState]() {
+             return persistState[1] != 0 || persistState[3] != 0;
+         });
+         if (persistState[1] == 0) {
+             break;  // asked to stop and nothing is left to write
+         }
+         if (persistState[3] == 0) {
+             // Let a burst of edits land in the same write
+             lock.unlock();
+             this_thread::sleep_for(chrono::milliseconds(getPersistDelayMillis()));
+             lock.lock();
+         }
+         
+         // Take the pending buffer and point the front end at the other one
+         int tables = (int)persistState[1];
+         int buffer = (int)persistState[0];
+         persistState[0] = 1 - buffer;
+         persistState[1] = 0;
+         persistState[2] = 1;
+         lock.unlock();
+         
+         // Every write is timed here on the worker, with the bytes it actually put on disk
+         long long bytes = 0;
+         if (tables & 1) {
+             int first = buffer * getMaxUsers();
+             long long start = getMicros();
+             long long written = saveUsersToTXT(snapshotUsernames + first, snapshotPasswords + first, 
+                                                snapshotEmails + first, snapshotUserGenerations + first, 
+                                                snapshotCounts[buffer * 3]);
+             finishLockedCall(4, start, written, metricBuckets, metricStats, traceSpans, traceCount, persistLock);
+             bytes += written;
+         }
+         if (tables & 2) {
+             int first = buffer * getMaxEvents();
+             long long start = getMicros();
+             long long written = saveEventsToTXT(snapshotEventNames + first, snapshotEventDates + first, 
+                                      snapshotEventVenues + first, snapshotEventCategories + first, 
+                                      snapshotEventPrices + first, snapshotEventCapacities + first, 
+                                      snapshotEventAvailable + first, snapshotEventGenerations + first, 
+                                      snapshotEventSeatMaps + first * getMaxSeatRows(), 
+                                      snapshotCounts[buffer * 3 + 1], 
+                                      snapshotEventsDirty + buffer * getMaxEventPartitions());
+             finishLockedCall(5, start, written, metricBuckets, metricStats, traceSpans, traceCount, persistLock);
+             bytes += written;
+             for (int k = 0; k < getMaxEventPartitions(); k++) {
+                 snapshotEventsDirty[buffer * getMaxEventPartitions() + k] = 0;
+             }
+         }
+         if (tables & 4) {
+             int first = buffer * getMaxTickets();
+             long long start = getMicros();
+             long long written = saveTicketsToTXT(snapshotTicketIDs + first, snapshotTicketUserIDs + first, 
+                                       snapshotTicketEventIDs + first, snapshotTicketQuantities + first, 
+                                       snapshotTicketCosts + first, snapshotTicketDates + first, 
+                                       snapshotTicketHours + first, snapshotTicketSeats + first, 
+                                       snapshotTicketTiers + first, snapshotCounts[buffer * 3 + 2], 
+                                       snapshotTicketsDirty[buffer]);
+             finishLockedCall(6, start, written, metricBuckets, metricStats, traceSpans, traceCount, persistLock);
+             bytes += written;
+             snapshotTicketsDirty[buffer] = getMaxTickets();
+         }
+         // Events writes only cover their dirty partitions, so seat changes elsewhere still need their records
+         if (tables & 8) {
+             int first = buffer * getMaxEvents();
+             for (int i = 0; i < snapshotSeatCounts[buffer]; i++) {
+                 int eventIndex = snapshotSeatSlots[first + i];
+                 long long start = getMicros();
+                 long long written = writeSeatRecord(eventIndex, snapshotEventAvailable[first + eventIndex]);
+                 written += writeSeatMapRecord(eventIndex, 
+                                               snapshotEventSeatMaps + (first + eventIndex) * getMaxSeatRows());
+                 finishLockedCall(15, start, written, metricBuckets, metricStats, traceSpans, traceCount, 
+                                  persistLock);
+                 bytes += written;
+             }
+         }
+         snapshotSeatCounts[buffer] = 0;
+         if (tables & 16) {
+             int first = buffer * getMaxEvents() * getWaitlistCapacity();
+             long long start = getMicros();
+             long long written = saveWaitlistToTXT(snapshotWaitlistEventIDs + first, 
+                                                   snapshotWaitlistUserIDs + first, 
+                                                   snapshotWaitlistQuantities + first, 
+                                                   snapshotWaitlistCounts[buffer]);
+             finishLockedCall(16, start, written, metricBuckets, metricStats, traceSpans, traceCount, persistLock);
+             bytes += written;
+         }
+         
+         lock.lock();
+         persistState[2] = 0;
+         persistState[4]++;
+         persistState[5] += bytes;
+         persistSignal.notify_all();
+     }
+ }
+ 
+ void snapshotSeatCount(int eventIndex, int available, unsigned long long eventSeatMaps[], 
+                        int snapshotEventAvailable[], unsigned long long snapshotEventSeatMaps[], 
+                        int snapshotSeatSlots[], int snapshotSeatCounts[], long long persistState[], 
+                        mutex& persistLock, condition_variable& persistSignal) {
+     lock_guard<mutex> lock(persistLock);
+     int buffer = (int)persistState[0];
+     snapshotEventAvailable[buffer * getMaxEvents() + eventIndex] = available;
+     for (int row = 0; row < getMaxSeatRows(); row++) {
+         snapshotEventSeatMaps[(buffer * getMaxEvents() + eventIndex) * getMaxSeatRows() + row] = 
+             eventSeatMaps[eventIndex * getMaxSeatRows() + row];
+     }
      
-     return result;
+     bool listed = false;
+     for (int i = 0; i < snapshotSeatCounts[buffer]; i++) {
+         if (snapshotSeatSlots[buffer * getMaxEvents() + i] == eventIndex) {
+             listed = true;
+             break;
+         }
+     }
+     if (!listed) {
+         snapshotSeatSlots[buffer * getMaxEvents() + snapshotSeatCounts[buffer]] = eventIndex;
+         snapshotSeatCounts[buffer]++;
+     }
+     persistState[1] |= 8;
+     persistSignal.notify_all();
  }
  
- string viewUserTickets(string username, int ticketIDs[], string ticketUsernames[], 
-                        string ticketEmails[], int ticketEventIDs[], int ticketQuantities[], 
-                        double ticketCosts[], string ticketDates[], string eventNames[], 
-                        int ticketCount, int eventCount) {
-     bool found = false;
+ void snapshotWaitlist(int waitlistUserIDs[], int waitlistQuantities[], int waitlistHeads[], 
+                       int waitlistSizes[], int eventGenerations[], int eventCount, 
+                       int snapshotWaitlistEventIDs[], int snapshotWaitlistUserIDs[], 
+                       int snapshotWaitlistQuantities[], int snapshotWaitlistCounts[], 
+                       long long persistState[], mutex& persistLock, condition_variable& persistSignal) {
+     // Flattened to one row per request, each queue oldest first
+     lock_guard<mutex> lock(persistLock);
+     int buffer = (int)persistState[0];
+     int first = buffer * getMaxEvents() * getWaitlistCapacity();
+     int rows = 0;
+     for (int i = 0; i < eventCount; i++) {
+         if (!isSlotLive(i, eventGenerations, eventCount)) {
+             continue;
+         }
+         for (int j = 0; j < waitlistSizes[i]; j++) {
+             int position = i * getWaitlistCapacity() + (waitlistHeads[i] + j) % getWaitlistCapacity();
+             snapshotWaitlistEventIDs[first + rows] = makeHandle(i, eventGenerations[i]);
+             snapshotWaitlistUserIDs[first + rows] = waitlistUserIDs[position];
+             snapshotWaitlistQuantities[first + rows] = waitlistQuantities[position];
+             rows++;
+         }
+     }
+     snapshotWaitlistCounts[buffer] = rows;
+     persistState[1] |= 16;
+     persistSignal.notify_all();
+ }
+ 
+ string syncPersistence(long long persistState[], mutex& persistLock, condition_variable& persistSignal) {
+     // Blocks until every snapshot handed over so far is on disk
+     unique_lock<mutex> lock(persistLock);
+     persistSignal.wait(lock, [persistState]() {
+         return persistState[1] == 0 && persistState[2] == 0;
+     });
+     return "All changes are on disk (" + to_string(persistState[4]) + " writes, " + 
+            to_string(persistState[5]) + " bytes this session)!";
+ }
+ 
+ void stopPersistence(thread& persistenceWorker, long long persistState[], mutex& persistLock, 
+                      condition_variable& persistSignal) {
+     {
+         lock_guard<mutex> lock(persistLock);
+         persistState[3] = 1;
+         persistSignal.notify_all();
+     }
+     persistenceWorker.join();
+ }
+ 
+ // Archive Functions
+ string getArchiveFileName(int number) {
+     return "archive_" + to_string(number) + ".txt";
+ }
+ 
+ int getArchiveCount() {
+     // Segments are numbered from 1 with no gaps, the first missing file ends the list
+     int count = 0;
+     while (true) {
+         ifstream file(getArchiveFileName(count + 1).c_str());
+         if (!file.is_open()) {
+             return count;
+         }
+         count++;
+     }
+ }
+ 
+ int splitArchiveLine(string line, string fields[], int maxFields) {
+     int starts[maxFields];
+     int ends[maxFields];
+     int fieldCount = splitColumns(line, starts, ends, maxFields);
+     for (int f = 0; f < fieldCount; f++) {
+         fields[f].assign(line, starts[f], ends[f] - starts[f]);
+     }
+     return fieldCount;
+ }
+ 
+ int findLastArchivedTicketID() {
+     // Only the header line of each segment is read
+     int lastID = 0;
+     int archiveCount = getArchiveCount();
+     for (int number = 1; number <= archiveCount; number++) {
+         ifstream file(getArchiveFileName(number).c_str());
+         string line;
+         string fields[4];
+         if (getline(file, line) && splitArchiveLine(line, fields, 4) == 4 && fields[0] == "ARCHIVE") {
+             lastID = max(lastID, stoi(fields[3]));
+         }
+     }
+     return lastID;
+ }
+ 
+ int findLeftoverEvents(int number, string eventNames[], int eventDates[], string eventVenues[], 
+                        string eventCategories[], int eventGenerations[], int eventCount, bool pastEvents[], 
+                        bool leftoverEvents[]) {
+     // Marks the past events segment number already holds and returns its last ticket ID. They are only
+     // still in memory if the run that wrote the segment stopped before the trimmed tables were saved
+     for (int i = 0; i < eventCount; i++) {
+         leftoverEvents[i] = false;
+     }
+     ifstream file(getArchiveFileName(number).c_str());
+     string line;
+     string fields[8];
+     if (number == 0 || !getline(file, line) || splitArchiveLine(line, fields, 8) != 4 || fields[0] != "ARCHIVE") {
+         return 0;
+     }
+     int lastID = readIntColumn(fields[3], 0, (int)fields[3].length());
+     while (getline(file, line)) {
+         if (line[0] != 'E' || splitArchiveLine(line, fields, 8) != 8) {
+             continue;
+         }
+         int date = parseDate(fields[2]);
+         for (int i = 0; i < eventCount; i++) {
+             if (pastEvents[i] && !leftoverEvents[i] && eventDates[i] == date && eventNames[i] == fields[1] && 
+                 eventVenues[i] == fields[3] && eventCategories[i] == fields[4] && 
+                 isSlotLive(i, eventGenerations, eventCount)) {
+                 leftoverEvents[i] = true;
+                 break;
+             }
+         }
+     }
+     return lastID;
+ }
+ 
+ string archivePastEvents(int today, string eventNames[], int eventDates[], string eventVenues[], 
+                          string eventCategories[], double eventPrices[], int eventCapacities[], 
+                          int eventAvailable[], int eventGenerations[], int eventFreeList[], 
+                          int& eventFreeCount, int eventCount, int ticketIDs[], int ticketUserIDs[], 
+                          int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                          int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                          int& ticketCount, int& lastArchivedTicketID) {
+     bool pastEvents[getMaxEvents()];
+     int pastCount = 0;
+     for (int i = 0; i < eventCount; i++) {
+         pastEvents[i] = isSlotLive(i, eventGenerations, eventCount) && eventDates[i] < today;
+         pastCount += pastEvents[i];
+     }
+     if (pastCount == 0) {
+         return "No past events to archive!";
+     }
      
-     cout << "\n" << bright_cyan << bold << "========== MY BOOKINGS ==========\n" << reset;
+     // Past events and tickets the newest segment already holds leave memory without being written twice.
+     // A leftover event's tickets booked after that segment was cut still go into the new one
+     int newestSegment = getArchiveCount();
+     bool leftoverEvents[getMaxEvents()];
+     int leftoverLastID = findLeftoverEvents(newestSegment, eventNames, eventDates, eventVenues, eventCategories, 
+                                             eventGenerations, eventCount, pastEvents, leftoverEvents);
      
+     // Number the events in the order they are written, -1 is not written
+     int archiveIndex[getMaxEvents()];
+     for (int i = 0; i < eventCount; i++) {
+         archiveIndex[i] = pastEvents[i] && !leftoverEvents[i] ? 0 : -1;
+     }
+     int archivedTickets = 0;
+     int lastID = lastArchivedTicketID;
      for (int i = 0; i < ticketCount; i++) {
-         if (ticketUsernames[i] == username) {
-             found = true;
-             cout << "\n" << bright_yellow << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
-             if (ticketEventIDs[i] >= 0 && ticketEventIDs[i] < eventCount) {
-                 cout << cyan << "Event: " << reset << bright_white << eventNames[ticketEventIDs[i]] << reset << endl;
-             }
-             cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
-             cout << cyan << "Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
-             cout << cyan << "Booking Date: " << reset << ticketDates[i] << endl;
-             cout << grey << "--------------------------------" << reset << endl;
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         if (eventIndex == -1 || !pastEvents[eventIndex] || 
+             (leftoverEvents[eventIndex] && ticketIDs[i] <= leftoverLastID)) {
+             continue;
+         }
+         archiveIndex[eventIndex] = 0;
+         archivedTickets++;
+         lastID = max(lastID, ticketIDs[i]);
+     }
+     int archivedEvents = 0;
+     int leftoverCount = 0;
+     for (int i = 0; i < eventCount; i++) {
+         if (archiveIndex[i] != -1) {
+             archiveIndex[i] = archivedEvents;
+             archivedEvents++;
+         } else if (pastEvents[i]) {
+             leftoverCount++;
          }
      }
      
-     if (!found) {
-         return "\nNo bookings found!";
+     // Header: ARCHIVE|events|tickets|last ticket ID, then E|name|date|venue|category|price|capacity|available
+     // per event and T|ID delta|event|userHandle|quantity|cost|date delta|hour|seat|tier per ticket. Rows point
+     // at the event's line number instead of repeating it, IDs and dates are stored as the change from the
+     // previous ticket, the cost is left empty when it is just price * quantity and the seat is left empty
+     // for general admission. Segments from before seating stop at the hour.
+     string filename = getArchiveFileName(newestSegment + 1);
+     if (archivedEvents > 0) {
+         ofstream file(filename.c_str());
+         if (!file.is_open()) {
+             return "Could not create " + filename + "!";
+         }
+         file << "ARCHIVE|" << archivedEvents << "|" << archivedTickets << "|" << lastID << endl;
+         for (int i = 0; i < eventCount; i++) {
+             if (archiveIndex[i] != -1) {
+                 file << "E|" << eventNames[i] << "|" << formatDate(eventDates[i]) << "|" << eventVenues[i] << "|" 
+                      << eventCategories[i] << "|" << compactNumber(eventPrices[i]) << "|" 
+                      << eventCapacities[i] << "|" << eventAvailable[i] << endl;
+             }
+         }
+         int previousID = 0;
+         int previousDate = 0;
+         for (int i = 0; i < ticketCount; i++) {
+             int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+             if (eventIndex == -1 || archiveIndex[eventIndex] == -1 || 
+                 (leftoverEvents[eventIndex] && ticketIDs[i] <= leftoverLastID)) {
+                 continue;
+             }
+             string cost = compactNumber(ticketCosts[i]);
+             if (cost == compactNumber(eventPrices[eventIndex] * ticketQuantities[i])) {
+                 cost = "";
+             }
+             file << "T|" << ticketIDs[i] - previousID << "|" << archiveIndex[eventIndex] << "|" 
+                  << ticketUserIDs[i] << "|" << ticketQuantities[i] << "|" << cost << "|" 
+                  << ticketDates[i] - previousDate << "|" << ticketHours[i] << "|" 
+                  << (ticketSeats[i] == -1 ? "" : to_string(ticketSeats[i])) << "|" << ticketTiers[i] << endl;
+             previousID = ticketIDs[i];
+             previousDate = ticketDates[i];
+         }
+         bool written = (bool)file;
+         file.close();
+         if (!written) {
+             remove(filename.c_str());
+             return "Could not write " + filename + "!";
+         }
      }
      
-     return "";
- }
- 
- string viewTicketByID(int ticketID, int ticketIDs[], string ticketUsernames[], 
-                       string ticketEmails[], int ticketEventIDs[], int ticketQuantities[], 
-                       double ticketCosts[], string ticketDates[], string eventNames[], 
-                       int ticketCount, int eventCount) {
+     // Only once the segment is safely on disk do the tickets and events leave memory
+     int kept = 0;
      for (int i = 0; i < ticketCount; i++) {
-         if (ticketIDs[i] == ticketID) {
-             cout << "\n" << bright_green << bold << "========== OFFICIAL TICKET ==========\n" << reset;
-             cout << bright_yellow << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
-             cout << cyan << "Name: " << reset << bright_white << ticketUsernames[i] << reset << endl;
-             cout << cyan << "Email: " << reset << ticketEmails[i] << endl;
-             if (ticketEventIDs[i] >= 0 && ticketEventIDs[i] < eventCount) {
-                 cout << cyan << "Event: " << reset << bright_white << eventNames[ticketEventIDs[i]] << reset << endl;
-             }
-             cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
-             cout << cyan << "Total Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
-             cout << cyan << "Booking Date: " << reset << ticketDates[i] << endl;
-             cout << bright_green << "=====================================\n" << reset;
-             return "";
+         int eventIndex = resolveHandle(ticketEventIDs[i], eventGenerations, eventCount);
+         if (eventIndex != -1 && pastEvents[eventIndex]) {
+             continue;
          }
+         moveTicketRow(i, kept, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                       ticketDates, ticketHours, ticketSeats, ticketTiers);
+         kept++;
      }
+     ticketCount = kept;
      
-     return "\nTicket not found!";
+     for (int i = 0; i < eventCount; i++) {
+         if (pastEvents[i]) {
+             eventNames[i] = "";
+             eventVenues[i] = "";
+             eventCategories[i] = "";
+             releaseSlot(i, eventGenerations, eventFreeList, eventFreeCount);
+         }
+     }
+     lastArchivedTicketID = lastID;
+     
+     string result = "Archived " + to_string(archivedEvents) + " past events and " + to_string(archivedTickets) + 
+                     " tickets" + (archivedEvents > 0 ? " to " + filename : "") + "!";
+     if (leftoverCount > 0) {
+         result += " Cleared " + to_string(leftoverCount) + " events already in " + 
+                   getArchiveFileName(newestSegment) + " from memory.";
+     }
+     return result;
  }
  
- string viewAllRegistrations(int ticketIDs[], string ticketUsernames[], string ticketEmails[], 
-                             int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
-                             string ticketDates[], string eventNames[], int ticketCount, 
-                             int eventCount) {
-     cout << "\n" << bright_magenta << bold << "========== ALL REGISTRATIONS ==========\n" << reset;
-     
-     if (ticketCount == 0) {
-         return "\nNo registrations found!";
+ string viewArchivedReports() {
+     int archiveCount = getArchiveCount();
+     if (archiveCount == 0) {
+         return "\nNo archived events found!";
      }
      
-     for (int i = 0; i < ticketCount; i++) {
-         cout << "\n" << bright_yellow << "Registration #" << (i + 1) << reset << endl;
-         cout << cyan << "Ticket ID: " << reset << bright_cyan << "TKT-" << to_string(ticketIDs[i]) << reset << endl;
-         cout << cyan << "User: " << reset << bright_white << ticketUsernames[i] << reset << endl;
-         cout << cyan << "Email: " << reset << ticketEmails[i] << endl;
-         if (ticketEventIDs[i] >= 0 && ticketEventIDs[i] < eventCount) {
-             cout << cyan << "Event: " << reset << bright_white << eventNames[ticketEventIDs[i]] << reset << endl;
+     cout << "\n" << bright_magenta << bold << "========== ARCHIVED EVENT REPORTS ==========\n" << reset;
+     
+     // Each segment is streamed once, totals per event are kept only while its segment is open
+     string eventLines[getMaxEvents()];
+     int eventBookings[getMaxEvents()];
+     double eventTotals[getMaxEvents()];
+     int totalEvents = 0;
+     int totalBookings = 0;
+     double totalRevenue = 0.0;
+     for (int number = 1; number <= archiveCount; number++) {
+         ifstream file(getArchiveFileName(number).c_str());
+         string line;
+         string fields[10];
+         if (!getline(file, line) || splitArchiveLine(line, fields, 10) != 4 || fields[0] != "ARCHIVE") {
+             cout << bright_red << getArchiveFileName(number) << " is not an archive segment, skipped.\n" << reset;
+             continue;
          }
-         cout << cyan << "Quantity: " << reset << bright_yellow << to_string(ticketQuantities[i]) << reset << endl;
-         cout << cyan << "Cost: " << reset << bright_green << "$" << to_string(ticketCosts[i]) << reset << endl;
-         cout << cyan << "Date: " << reset << ticketDates[i] << endl;
-         cout << grey << "--------------------------------" << reset << endl;
+         
+         int eventTotal = 0;
+         double prices[getMaxEvents()];
+         while (getline(file, line)) {
+             int fieldCount = splitArchiveLine(line, fields, 10);
+             if (fields[0] == "E" && fieldCount == 8 && eventTotal < getMaxEvents()) {
+                 eventLines[eventTotal] = fields[1] + " (" + fields[2] + ", " + fields[3] + ")";
+                 prices[eventTotal] = stod(fields[5]);
+                 eventBookings[eventTotal] = 0;
+                 eventTotals[eventTotal] = 0.0;
+                 eventTotal++;
+             } else if (fields[0] == "T" && fieldCount >= 8) {
+                 // A cancelled ticket keeps its row with quantity 0, it is not a booking
+                 int eventIndex = stoi(fields[2]);
+                 int quantity = stoi(fields[4]);
+                 if (eventIndex < 0 || eventIndex >= eventTotal || quantity == 0) {
+                     continue;
+                 }
+                 double cost = fields[5] == "" ? prices[eventIndex] * quantity : stod(fields[5]);
+                 eventBookings[eventIndex]++;
+                 eventTotals[eventIndex] += cost;
+             }
+         }
+         
+         cout << "\n" << bright_cyan << bold << "--- " << getArchiveFileName(number) << " ---\n" << reset;
+         for (int i = 0; i < eventTotal; i++) {
+             cout << "\n" << bright_yellow << "Event: " << reset << bright_white << eventLines[i] << reset << endl;
+             cout << cyan << "Bookings: " << reset << to_string(eventBookings[i]) << endl;
+             cout << cyan << "Revenue: " << reset << bright_green << "$" << to_string(eventTotals[i]) << reset << endl;
+             totalBookings += eventBookings[i];
+             totalRevenue += eventTotals[i];
+         }
+         totalEvents += eventTotal;
      }
      
+     cout << "\n" << bright_cyan << bold << "--- Overall Statistics ---\n" << reset;
+     cout << cyan << "Archive Segments: " << reset << bright_yellow << to_string(archiveCount) << reset << endl;
+     cout << cyan << "Archived Events: " << reset << bright_yellow << to_string(totalEvents) << reset << endl;
+     cout << cyan << "Archived Bookings: " << reset << bright_yellow << to_string(totalBookings) << reset << endl;
+     cout << cyan << "Archived Revenue: " << reset << bright_green << "$" << to_string(totalRevenue) << reset << endl;
+     cout << "\n" << bright_magenta << "============================================\n" << reset;
      return "";
  }
+
+ // Replica Functions
+ void startJournal(ofstream& journal) {
+     // A fresh file rather than a truncated one, so log shippers following the name see the switch even
+     // when the new journal grows past the old one's size; the S line tells followers to reload the data files
+     if (journal.is_open()) {
+         journal.close();
+     }
+     remove("journal.txt");
+     journal.open("journal.txt");
+     journal << "S|" << to_string(getWallMillis()) << endl;
+ }
  
- // Report Functions
- void generateReports(int ticketIDs[], string ticketUsernames[], int ticketEventIDs[], 
-                      int ticketQuantities[], double ticketCosts[], string eventNames[], 
-                      double eventPrices[], int ticketCount, int eventCount) {
-     cout << "\n" << bright_magenta << bold << "========== SALES REPORTS & ANALYTICS ==========\n" << reset;
+ void journalEvent(int slot, string eventNames[], int eventDates[], string eventVenues[], 
+                   string eventCategories[], double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                   int eventGenerations[], int eventCount, ofstream& journal) {
+     if (!journal.is_open()) {
+         return;
+     }
+     journal << "E|" << to_string(getWallMillis()) << "|" << to_string(slot) << "|" 
+             << formatEventLine(slot, eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                eventCapacities, eventAvailable, eventGenerations, eventCount) << endl;
+ }
+ 
+ void journalTickets(int first, int last, int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], 
+                     int ticketQuantities[], double ticketCosts[], int ticketDates[], int ticketHours[], 
+                     int ticketSeats[], int ticketTiers[], ofstream& journal) {
+     // Rows first to last - 1 share one timestamp and one flush
+     if (!journal.is_open() || first < 0 || first >= last) {
+         return;
+     }
+     string stamp = "T|" + to_string(getWallMillis()) + "|";
+     for (int i = first; i < last; i++) {
+         journal << stamp << formatTicketLine(i, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                                              ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers) << "\n";
+     }
+     journal.flush();
+ }
+ 
+ void journalUser(int slot, string usernames[], string emails[], int userGenerations[], ofstream& journal) {
+     // Passwords stay out of the journal, followers never log anyone in
+     if (!journal.is_open()) {
+         return;
+     }
+     journal << "U|" << to_string(getWallMillis()) << "|" << to_string(slot) << "|" << usernames[slot] << "|" 
+             << emails[slot] << "|" << to_string(userGenerations[slot]) << endl;
+ }
+ 
+ int runFollower(string journalPath) {
+     // The replica keeps its own copy of every table it reports on, nothing is shared with the primary
+     string usernames[getMaxUsers()];
+     string passwords[getMaxUsers()];
+     string emails[getMaxUsers()];
+     int userGenerations[getMaxUsers()];
+     int userFreeList[getMaxUsers()];
+     int userFreeCount = 0;
+     int userCount = 0;
      
-     double totalRevenue = calculateTotalRevenue(ticketIDs, ticketCosts, ticketCount);
-     int totalBookings = calculateTotalBookings(ticketIDs, ticketCount);
+     string eventNames[getMaxEvents()];
+     int eventDates[getMaxEvents()];
+     string eventVenues[getMaxEvents()];
+     string eventCategories[getMaxEvents()];
+     double eventPrices[getMaxEvents()];
+     int eventCapacities[getMaxEvents()];
+     int eventAvailable[getMaxEvents()];
+     int eventGenerations[getMaxEvents()];
+     int eventFreeList[getMaxEvents()];
+     int eventFreeCount = 0;
+     int eventCount = 0;
+     double eventRevenue[getMaxEvents()];
+     int eventSeatsSold[getMaxEvents()];
+     int leaderboardRanks[getLeaderboardMetricCount() * getMaxEvents()];
+     int leaderboardPos[getLeaderboardMetricCount() * getMaxEvents()];
      
-     cout << "\n" << bright_cyan << bold << "--- Overall Statistics ---\n" << reset;
-     cout << cyan << "Total Revenue: " << reset << bright_green << "$" << to_string(totalRevenue) << reset << endl;
-     cout << cyan << "Total Bookings: " << reset << bright_yellow << to_string(totalBookings) << reset << endl;
-     cout << cyan << "Total Events: " << reset << bright_yellow << to_string(eventCount) << reset << endl;
+     int ticketIDs[getMaxTickets()];
+     int ticketUserIDs[getMaxTickets()];
+     int ticketEventIDs[getMaxTickets()];
+     int ticketQuantities[getMaxTickets()];
+     double ticketCosts[getMaxTickets()];
+     int ticketDates[getMaxTickets()];
+     int ticketHours[getMaxTickets()];
+     int ticketSeats[getMaxTickets()];
+     int ticketTiers[getMaxTickets()];
+     int ticketIDTable[getTicketIDTableSize()];
+     int ticketCount = 0;
+     long long ticketSegmentOffsets[getMaxTicketSegments()];
+     int ticketSegmentMinIDs[getMaxTicketSegments()];
+     int ticketSegmentMaxIDs[getMaxTicketSegments()];
+     bool ticketSegmentLoaded[getMaxTicketSegments()];
+     int ticketSegmentCount = 0;
      
-     cout << "\n" << bright_cyan << bold << "--- Event-wise Statistics ---\n" << reset;
-     for (int i = 0; i < eventCount; i++) {
-         int bookings = calculateEventBookings(i, ticketEventIDs, ticketCount);
-         double revenue = 0.0;
+     int rollupKeys[getRollupSize()];
+     double rollupRevenue[getRollupSize()];
+     int rollupTickets[getRollupSize()];
+     
+     long long metricBuckets[getMetricCount() * getMetricBucketCount()];
+     long long metricStats[getMetricCount() * getMetricStatCount()];
+     clearMetrics(metricBuckets, metricStats);
+     long long replicaState[9] = {0, 0, 0, 0, 0, 0, 0, 0, -1};
+     mutex replicaLock;
+     
+     loadReplicaTables(usernames, passwords, emails, userGenerations, userFreeList, userFreeCount, userCount, 
+                       eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                       eventAvailable, eventGenerations, eventFreeList, eventFreeCount, eventCount, ticketIDs, 
+                       ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                       ticketSeats, ticketTiers, ticketIDTable, ticketCount, ticketSegmentOffsets, 
+                       ticketSegmentMinIDs, ticketSegmentMaxIDs, ticketSegmentLoaded, ticketSegmentCount, 
+                       replicaState);
+     thread journalTailer(tailJournal, journalPath, &usernames[0], &passwords[0], &emails[0], 
+                          &userGenerations[0], &userFreeList[0], ref(userFreeCount), ref(userCount), 
+                          &eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], 
+                          &eventPrices[0], &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], 
+                          &eventFreeList[0], ref(eventFreeCount), ref(eventCount), &ticketIDs[0], 
+                          &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 
+                          &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0], 
+                          &ticketIDTable[0], ref(ticketCount), &ticketSegmentOffsets[0], 
+                          &ticketSegmentMinIDs[0], &ticketSegmentMaxIDs[0], &ticketSegmentLoaded[0], 
+                          ref(ticketSegmentCount), &replicaState[0], &metricBuckets[0], &metricStats[0], 
+                          ref(replicaLock));
+     
+     displayHeader();
+     // Leaderboards and rollups are rebuilt only when the journal has moved on since they were last built
+     long long builtVersion = -1;
+     bool running = true;
+     
+     while (running) {
+         clearScreen();
+         displayReplicaMenu();
+         string choice = getUserChoice();
          
-         for (int j = 0; j < ticketCount; j++) {
-             if (ticketEventIDs[j] == i) {
-                 revenue += ticketCosts[j];
+         // Input is read before taking the lock so the tailer keeps applying while the user types
+         string searchText = "";
+         if (choice == "2" || choice == "3") {
+             cin.ignore();
+             cout << bright_yellow << (choice == "2" ? "Enter Event Name to Search: " : 
+                                       "Enter Category (Music/Conference/Sports/Other): ") << reset;
+             getline(cin, searchText);
+             while ((int)searchText.length() == 0) {
+                 cout << bright_red << "Search text cannot be empty! Enter again: " << reset;
+                 getline(cin, searchText);
              }
          }
          
-         cout << "\n" << bright_yellow << "Event: " << reset << bright_white << eventNames[i] << reset << endl;
-         cout << cyan << "Bookings: " << reset << to_string(bookings) << endl;
-         cout << cyan << "Revenue: " << reset << bright_green << "$" << to_string(revenue) << reset << endl;
+         if (choice == "9") {
+             running = false;
+             continue;
+         }
+         if (choice != "1" && choice != "2" && choice != "3" && choice != "4" && choice != "5" && 
+             choice != "6" && choice != "7" && choice != "8") {
+             cout << "\n" << bright_red << "Invalid option! Please try again.\n" << reset;
+             pauseScreen();
+             continue;
+         }
+         
+         {
+             lock_guard<mutex> lock(replicaLock);
+             clearScreen();
+             if ((choice == "6" || choice == "7") && replicaState[2] + replicaState[5] != builtVersion) {
+                 eventFreeCount = 0;
+                 for (int i = 0; i < eventCount; i++) {
+                     if (!isSlotLive(i, eventGenerations, eventCount)) {
+                         eventFreeCount++;
+                     }
+                 }
+                 buildLeaderboards(ticketEventIDs, ticketQuantities, ticketCosts, ticketCount, 
+                                   eventCapacities, eventAvailable, eventRevenue, eventSeatsSold, 
+                                   leaderboardRanks, leaderboardPos, eventGenerations, eventCount);
+                 buildRollups(ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, 
+                              ticketCount, rollupKeys, rollupRevenue, rollupTickets, eventGenerations, 
+                              eventCount);
+                 builtVersion = replicaState[2] + replicaState[5];
+             }
+             
+             if (choice == "1") {
+                 printEventList(eventNames, eventDates, eventVenues, eventCategories, eventPrices, 
+                                eventCapacities, eventAvailable, eventGenerations, eventCount);
+             } else if (choice == "2" || choice == "3") {
+                 string result = choice == "2" ? 
+                                 searchEventByName(searchText, eventNames, eventDates, eventVenues, 
+                                                   eventCategories, eventPrices, eventCapacities, 
+                                                   eventAvailable, eventCount) :
+                                 searchEventByCategory(searchText, eventNames, eventDates, eventVenues, 
+                                                       eventCategories, eventPrices, eventCapacities, 
+                                                       eventAvailable, eventCount);
+                 if ((int)result.find("No events found") != -1) {
+                     cout << bright_red << result << reset << endl;
+                 } else {
+                     cout << bright_cyan << bold << "\n========== SEARCH RESULTS ==========\n" << reset;
+                     cout << result << endl;
+                 }
+             } else if (choice == "4") {
+                 string registrations = viewAllRegistrations(ticketIDs, ticketUserIDs, ticketEventIDs, 
+                                                             ticketQuantities, ticketCosts, ticketDates, 
+                                                             eventNames, usernames, emails, ticketCount, 
+                                                             eventGenerations, eventCount, userGenerations, 
+                                                             userCount);
+                 if (registrations != "") {
+                     cout << bright_red << registrations << reset << endl;
+                 }
+             } else if (choice == "5") {
+                 generateReports(ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                                 eventNames, eventPrices, ticketCount, eventGenerations, eventCount);
+             } else if (choice == "6") {
+                 cout << "\n" << bright_magenta << bold << "========== BEST-SELLER LEADERBOARD ==========\n" << reset;
+                 for (int metric = 0; metric < getLeaderboardMetricCount(); metric++) {
+                     string board = viewLeaderboard(metric, eventNames, eventCapacities, eventAvailable, 
+                                                    eventRevenue, eventSeatsSold, leaderboardRanks, 
+                                                    eventCount - eventFreeCount);
+                     if ((int)board.find("No events available") != -1) {
+                         cout << bright_red << board << reset << endl;
+                         break;
+                     }
+                     cout << board;
+                 }
+             } else if (choice == "7") {
+                 cout << "\n" << bright_magenta << bold << "========== SALES ROLLUPS ==========\n" << reset;
+                 cout << viewSalesRollups(-1, eventNames, rollupKeys, rollupRevenue, rollupTickets) << endl;
+             } else {
+                 cout << viewReplicationStatus(journalPath, replicaState, metricBuckets, metricStats) << endl;
+             }
+         }
+         pauseScreen();
      }
      
-     cout << "\n" << bright_magenta << "==========================================\n" << reset;
+     stopJournalTail(journalTailer, journalPath, replicaState, replicaLock);
+     clearScreen();
+     cout << "\n" << bright_green << bold << "*** Replica stopped ***\n" << reset;
+     return 0;
  }
  
- double calculateTotalRevenue(int ticketIDs[], double ticketCosts[], int ticketCount) {
-     double total = 0.0;
-     for (int i = 0; i < ticketCount; i++) {
-         total += ticketCosts[i];
+ void loadReplicaTables(string usernames[], string passwords[], string emails[], int userGenerations[], 
+                        int userFreeList[], int& userFreeCount, int& userCount, string eventNames[], 
+                        int eventDates[], string eventVenues[], string eventCategories[], 
+                        double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                        int eventGenerations[], int eventFreeList[], int& eventFreeCount, int& eventCount, 
+                        int ticketIDs[], int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], 
+                        double ticketCosts[], int ticketDates[], int ticketHours[], int ticketSeats[], 
+                        int ticketTiers[], int ticketIDTable[], int& ticketCount, 
+                        long long ticketSegmentOffsets[], int ticketSegmentMinIDs[], 
+                        int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], int& ticketSegmentCount, 
+                        long long replicaState[]) {
+     // Journal lines written before this moment may already be in the files, replaying them again is harmless
+     replicaState[7] = getWallMillis();
+     userFreeCount = 0;
+     userCount = 0;
+     eventFreeCount = 0;
+     eventCount = 0;
+     ticketCount = 0;
+     loadUsersFromTXT(usernames, passwords, emails, userGenerations, userFreeList, userFreeCount, userCount);
+     loadEventsFromTXT(eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                       eventAvailable, eventGenerations, eventFreeList, eventFreeCount, eventCount);
+     // Reports need every ticket, so the segments are all paged in straight away
+     if (loadTicketIndex(ticketSegmentOffsets, ticketSegmentMinIDs, ticketSegmentMaxIDs, ticketSegmentLoaded, 
+                         ticketSegmentCount, ticketCount)) {
+         bool ticketsLoaded = false;
+         ensureTicketsLoaded(ticketsLoaded, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                             ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, 
+                             ticketSegmentOffsets, ticketSegmentLoaded, ticketSegmentCount, ticketCount, 
+                             usernames, userGenerations, userCount);
+     } else {
+         ticketCount = 0;
+         loadTicketsFromTXT(ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                            ticketDates, ticketHours, ticketSeats, ticketTiers, ticketCount, usernames, 
+                            userGenerations, userCount);
      }
-     return total;
+     buildTicketIDTable(ticketIDTable, ticketIDs, ticketCount);
  }
  
- int calculateTotalBookings(int ticketIDs[], int ticketCount) {
-     return ticketCount;
+ int applyJournalLine(string line, string usernames[], string emails[], int userGenerations[], int& userCount, 
+                      string eventNames[], int eventDates[], string eventVenues[], string eventCategories[], 
+                      double eventPrices[], int eventCapacities[], int eventAvailable[], 
+                      int eventGenerations[], int& eventCount, int ticketIDs[], int ticketUserIDs[], 
+                      int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], int ticketDates[], 
+                      int ticketHours[], int ticketSeats[], int ticketTiers[], int ticketIDTable[], 
+                      int& ticketCount, long long replicaState[], long long metricBuckets[], 
+                      long long metricStats[]) {
+     // Returns 1 when the line was applied, 2 when the tables must be reloaded and 0 for anything else
+     if ((int)line.length() < 3 || line[1] != '|') {
+         return 0;
+     }
+     int stampEnd = (int)line.find('|', 2);
+     if (stampEnd == -1) {
+         stampEnd = (int)line.length();
+     }
+     // Every number is checked before it is converted, a garbage line must not throw in the tailer thread
+     if (!isDigitColumn(line, 2, stampEnd, 18)) {
+         return 0;
+     }
+     long long millis = stoll(line.substr(2, stampEnd - 2));
+     string row = stampEnd < (int)line.length() ? line.substr(stampEnd + 1) : "";
+     
+     if (line[0] == 'S') {
+         // A start older than the loaded tables is already reflected in the files
+         return millis >= replicaState[7] ? 2 : 0;
+     } else if (line[0] == 'E') {
+         int slotEnd = (int)row.find('|');
+         if (!isDigitColumn(row, 0, slotEnd, 9)) {
+             return 0;
+         }
+         int slot = readIntColumn(row, 0, slotEnd);
+         if (slot < 0 || slot >= getMaxEvents()) {
+             return 0;
+         }
+         // Slots this replica never saw stay tombstones until their own line arrives
+         for (int i = eventCount; i < slot; i++) {
+             clearEventRow(i, eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities, 
+                           eventAvailable);
+             eventGenerations[i] = 1;
+         }
+         if (!parseEventLine(row.substr(slotEnd + 1), slot, eventNames, eventDates, eventVenues, 
+                             eventCategories, eventPrices, eventCapacities, eventAvailable, 
+                             eventGenerations)) {
+             return 0;
+         }
+         eventCount = max(eventCount, slot + 1);
+     } else if (line[0] == 'T') {
+         // The row is parsed into the first unused position, then kept there or copied over the older version
+         if (ticketCount >= getMaxTickets() || 
+             !parseTicketLine(row, ticketCount, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                              ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, usernames, 
+                              userGenerations, userCount)) {
+             return 0;
+         }
+         int existing = findTicketIndex(ticketIDs[ticketCount], ticketIDTable, ticketIDs);
+         if (existing == -1) {
+             insertTicketID(ticketCount, ticketIDTable, ticketIDs);
+             ticketCount++;
+         } else {
+             moveTicketRow(ticketCount, existing, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, 
+                           ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers);
+         }
+     } else if (line[0] == 'U') {
+         string fields[4];
+         if (splitArchiveLine(row, fields, 4) != 4 || !isDigitColumn(fields[0], 0, (int)fields[0].length(), 9) || 
+             !isDigitColumn(fields[3], 0, (int)fields[3].length(), 9)) {
+             return 0;
+         }
+         int slot = readIntColumn(fields[0], 0, (int)fields[0].length());
+         if (slot < 0 || slot >= getMaxUsers()) {
+             return 0;
+         }
+         for (int i = userCount; i < slot; i++) {
+             usernames[i] = "";
+             emails[i] = "";
+             userGenerations[i] = 1;
+         }
+         userGenerations[slot] = readIntColumn(fields[3], 0, (int)fields[3].length());
+         bool live = userGenerations[slot] % 2 == 0;
+         usernames[slot] = live ? fields[1] : "";
+         emails[slot] = live ? fields[2] : "";
+         userCount = max(userCount, slot + 1);
+     } else {
+         return 0;
+     }
+     
+     // Lines older than the loaded tables are catch-up replay rather than replication lag
+     long long now = getWallMillis();
+     long long lag = max(0LL, now - millis);
+     if (millis >= replicaState[7]) {
+         recordMetric(13, lag * 1000, (long long)line.length() + 1, metricBuckets, metricStats);
+         replicaState[3] = lag;
+     }
+     replicaState[2]++;
+     replicaState[4] = now;
+     return 1;
  }
  
- int calculateEventBookings(int eventIndex, int ticketEventIDs[], int ticketCount) {
-     int count = 0;
-     for (int i = 0; i < ticketCount; i++) {
-         if (ticketEventIDs[i] == eventIndex) {
-             count++;
+ void tailJournal(string journalPath, string usernames[], string passwords[], string emails[], 
+                  int userGenerations[], int userFreeList[], int& userFreeCount, int& userCount, 
+                  string eventNames[], int eventDates[], string eventVenues[], string eventCategories[], 
+                  double eventPrices[], int eventCapacities[], int eventAvailable[], int eventGenerations[], 
+                  int eventFreeList[], int& eventFreeCount, int& eventCount, int ticketIDs[], 
+                  int ticketUserIDs[], int ticketEventIDs[], int ticketQuantities[], double ticketCosts[], 
+                  int ticketDates[], int ticketHours[], int ticketSeats[], int ticketTiers[], 
+                  int ticketIDTable[], int& ticketCount, long long ticketSegmentOffsets[], 
+                  int ticketSegmentMinIDs[], int ticketSegmentMaxIDs[], bool ticketSegmentLoaded[], 
+                  int& ticketSegmentCount, long long replicaState[], long long metricBuckets[], 
+                  long long metricStats[], mutex& replicaLock) {
+     // Follows journalPath like tail -F: a regular file is re-read from the top when the primary truncates
+     // it, a named pipe is simply read for as long as something writes to it
+     while (true) {
+         {
+             lock_guard<mutex> lock(replicaLock);
+             if (replicaState[0] != 0) {
+                 break;
+             }
+         }
+         ifstream file(journalPath.c_str());
+         if (!file.is_open()) {
+             this_thread::sleep_for(chrono::milliseconds(getJournalPollMillis()));
+             continue;
+         }
+         bool seekable = (long long)file.tellg() != -1;
+         {
+             lock_guard<mutex> lock(replicaLock);
+             replicaState[1] = 0;
+             replicaState[8] = seekable ? getFileSize(journalPath) : -1;
+         }
+         
+         string firstLine = "";
+         string pending = "";
+         long long offset = 0;
+         bool reopen = false;
+         while (!reopen) {
+             string line;
+             if (getline(file, line)) {
+                 offset += (long long)line.length();
+                 // A line without its newline is still being written, it is finished on a later read
+                 if (file.eof()) {
+                     pending += line;
+                     continue;
+                 }
+                 offset++;
+                 line = pending + line;
+                 pending = "";
+                 if (firstLine == "") {
+                     firstLine = line;
+                 }
+                 
+                 lock_guard<mutex> lock(replicaLock);
+                 if (replicaState[0] != 0) {
+                     break;
+                 }
+                 int applied = applyJournalLine(line, usernames, emails, userGenerations, userCount, 
+                                                eventNames, eventDates, eventVenues, eventCategories, 
+                                                eventPrices, eventCapacities, eventAvailable, 
+                                                eventGenerations, eventCount, ticketIDs, ticketUserIDs, 
+                                                ticketEventIDs, ticketQuantities, ticketCosts, ticketDates, 
+                                                ticketHours, ticketSeats, ticketTiers, ticketIDTable, 
+                                                ticketCount, replicaState, metricBuckets, metricStats);
+                 if (applied == 2) {
+                     loadReplicaTables(usernames, passwords, emails, userGenerations, userFreeList, 
+                                       userFreeCount, userCount, eventNames, eventDates, eventVenues, 
+                                       eventCategories, eventPrices, eventCapacities, eventAvailable, 
+                                       eventGenerations, eventFreeList, eventFreeCount, eventCount, ticketIDs, 
+                                       ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, 
+                                       ticketDates, ticketHours, ticketSeats, ticketTiers, ticketIDTable, 
+                                       ticketCount, ticketSegmentOffsets, ticketSegmentMinIDs, 
+                                       ticketSegmentMaxIDs, ticketSegmentLoaded, ticketSegmentCount, 
+                                       replicaState);
+                     replicaState[5]++;
+                 }
+                 replicaState[1] = offset;
+                 continue;
+             }
+             
+             // Caught up: a shorter file or a different first line means the primary started a new journal
+             file.clear();
+             if (seekable) {
+                 long long size = getFileSize(journalPath);
+                 ifstream check(journalPath.c_str());
+                 string checkLine = "";
+                 getline(check, checkLine);
+                 if (size < offset || (firstLine != "" && checkLine != firstLine)) {
+                     reopen = true;
+                     continue;
+                 }
+                 lock_guard<mutex> lock(replicaLock);
+                 replicaState[8] = size;
+             }
+             {
+                 lock_guard<mutex> lock(replicaLock);
+                 if (replicaState[0] != 0) {
+                     break;
+                 }
+             }
+             this_thread::sleep_for(chrono::milliseconds(getJournalPollMillis()));
          }
      }
-     return count;
+     
+     lock_guard<mutex> lock(replicaLock);
+     replicaState[6] = 1;
+ }
+ 
+ void stopJournalTail(thread& journalTailer, string journalPath, long long replicaState[], mutex& replicaLock) {
+     {
+         lock_guard<mutex> lock(replicaLock);
+         replicaState[0] = 1;
+     }
+     // A tailer blocked opening or reading an idle pipe only wakes up when something is written to it
+     for (int wait = 0; wait < 5; wait++) {
+         {
+             lock_guard<mutex> lock(replicaLock);
+             if (replicaState[6] != 0) {
+                 break;
+             }
+         }
+         this_thread::sleep_for(chrono::milliseconds(getJournalPollMillis()));
+     }
+     bool finished;
+     long long journalSize;
+     {
+         lock_guard<mutex> lock(replicaLock);
+         finished = replicaState[6] != 0;
+         journalSize = replicaState[8];
+     }
+     if (!finished && journalSize < 0) {
+         ofstream wake(journalPath.c_str(), ios::app);
+         wake << "\n";
+     }
+     journalTailer.join();
  }
  
+ string viewReplicationStatus(string journalPath, long long replicaState[], long long metricBuckets[], 
+                              long long metricStats[]) {
+     long long now = getWallMillis();
+     string result = "\n========== REPLICATION STATUS ==========\n";
+     result += "Journal: " + journalPath + (replicaState[8] < 0 ? " (pipe)" : "") + "\n";
+     result += "Entries Applied: " + to_string(replicaState[2]) + "\n";
+     result += "Bytes Read: " + to_string(replicaState[1]);
+     if (replicaState[8] >= 0) {
+         result += "  Unread: " + to_string(max(0LL, replicaState[8] - replicaState[1]));
+     }
+     result += "\nReloads: " + to_string(replicaState[5]) + "\n";
+     if (replicaState[2] == 0) {
+         result += "No journal entries applied yet!\n";
+         return result;
+     }
+     result += "Last Lag: " + to_string(replicaState[3]) + " ms  Last Applied: " + 
+               to_string((now - replicaState[4]) / 1000) + " s ago\n";
+     // Builds without metrics never record the lag histogram, so the line is left out there
+     if (metricStats[13 * getMetricStatCount()] > 0) {
+         result += "Lag p50: " + to_string(getMetricPercentile(13, 0.50, metricBuckets, metricStats) / 1000) + 
+                   " ms  p99: " + to_string(getMetricPercentile(13, 0.99, metricBuckets, metricStats) / 1000) + 
+                   " ms  Max: " + to_string(metricStats[13 * getMetricStatCount() + 2] / 1000) + " ms\n";
+     }
+     return result;
+ }
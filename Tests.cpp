@@ -0,0 +1,1165 @@
+/*
+ * Event Registration and Ticketing System - Tests
+ * Checks that every data file round-trips: tables saved and loaded again come back
+ * unchanged, for users.txt, the events_N.txt partitions with events.avail and
+ * events.seats, the tickets_N.txt partitions with tickets.idx, waitlist.txt, the
+ * journal and the archive segments, and that torn events.idx and tickets.idx
+ * headers are ignored. Also checks the gate check-in rules, bulk event updates,
+ * orders that cross into the Last Seats price, waitlist promotion on a fragmented
+ * seat map, the booking rate tokens, cancelling a ticket, handles across slot
+ * reuse and compaction, and kiosk request keys.
+ *
+ * Compile:  g++ -std=c++11 -O2 -pthread Tests.cpp -o Tests
+ * Run:      ./Tests
+ *
+ * The files are written to a new eventtests.XXXXXX folder under $TMPDIR (or /tmp),
+ * never the current directory. Prints one PASS or FAIL line per check and exits
+ * with 1 if any check failed.
+ */
+
+ #define EVENT_SYSTEM_NO_MAIN
+ #ifndef EVENT_SYSTEM_MAX_TICKETS
+ #define EVENT_SYSTEM_MAX_TICKETS 10000  // room for more than one tickets_N.txt partition
+ #endif
+ #include "Project.cpp"
+ #include <sstream>
+ #include <vector>
+ #include <unistd.h>  //for mkdtemp and chdir
+ 
+ // Function Prototypes - Test Functions
+ string enterScratchDirectory();
+ void check(bool passed, string name, int& failures);
+ void testUserFile(int& failures);
+ void testEventFiles(int& failures);
+ void testTicketFiles(int& failures);
+ void testWaitlistFile(int& failures);
+ void testJournal(int& failures);
+ void testArchive(int& failures);
+ void testCheckIn(int& failures);
+ void testBulkUpdate(int& failures);
+ void testPriceTiers(int& failures);
+ void testWaitlistScan(int& failures);
+ void testRateTokens(int& failures);
+ void testCancellation(int& failures);
+ void testCompaction(int& failures);
+ void testRequestKeys(int& failures);
+ 
+ int main() {
+     string directory = enterScratchDirectory();
+     if (directory == "") {
+         cerr << "Could not create a folder for the test files" << endl;
+         return 1;
+     }
+     cout << "Test folder: " << directory << endl;
+     
+     int failures = 0;
+     testUserFile(failures);
+     testEventFiles(failures);
+     testTicketFiles(failures);
+     testWaitlistFile(failures);
+     testJournal(failures);
+     testArchive(failures);
+     testCheckIn(failures);
+     testBulkUpdate(failures);
+     testPriceTiers(failures);
+     testWaitlistScan(failures);
+     testRateTokens(failures);
+     testCancellation(failures);
+     testCompaction(failures);
+     testRequestKeys(failures);
+     
+     cout << (failures == 0 ? "All checks passed" : to_string(failures) + " checks failed") << endl;
+     return failures == 0 ? 0 : 1;
+ }
+ 
+ // Test Functions
+ string enterScratchDirectory() {
+     // A fresh folder per run so the test files can never overwrite a real data set
+     const char* base = getenv("TMPDIR");
+     string pattern = string(base != NULL && base[0] != '\0' ? base : "/tmp") + "/eventtests.XXXXXX";
+     vector<char> path(pattern.begin(), pattern.end());
+     path.push_back('\0');
+     if (mkdtemp(&path[0]) == NULL || chdir(&path[0]) != 0) {
+         return "";
+     }
+     return string(&path[0]);
+ }
+ 
+ void check(bool passed, string name, int& failures) {
+     cout << (passed ? "PASS " : "FAIL ") << name << endl;
+     if (!passed) {
+         failures++;
+     }
+ }
+ 
+ void testUserFile(int& failures) {
+     // Slot 2 is a tombstone, it is written so later slots keep their numbers
+     string usernames[3] = {"alice", "bob", ""};
+     string passwords[3] = {"secret", "hunter2", ""};
+     string emails[3] = {"alice@example.com", "bob@example.com", ""};
+     int userGenerations[3] = {0, 2, 1};
+     saveUsersToTXT(usernames, passwords, emails, userGenerations, 3);
+     
+     vector<string> loadedNames(getMaxUsers()), loadedPasswords(getMaxUsers()), loadedEmails(getMaxUsers());
+     vector<int> loadedGenerations(getMaxUsers()), freeList(getMaxUsers());
+     int freeCount = 0;
+     int userCount = 0;
+     loadUsersFromTXT(&loadedNames[0], &loadedPasswords[0], &loadedEmails[0], &loadedGenerations[0], &freeList[0],
+                      freeCount, userCount);
+     
+     bool same = userCount == 3;
+     for (int i = 0; same && i < 3; i++) {
+         same = loadedNames[i] == usernames[i] && loadedPasswords[i] == passwords[i] &&
+                loadedEmails[i] == emails[i] && loadedGenerations[i] == userGenerations[i];
+     }
+     check(same, "users.txt round-trips", failures);
+     check(freeCount == 1 && freeList[0] == 2, "users.txt tombstone goes back on the free list", failures);
+ }
+ 
+ void testEventFiles(int& failures) {
+     // More events than one partition holds, slot 7 deleted and slot 3 with seats sold in two rows
+     int eventCount = getEventPartitionSize() + 8;
+     vector<string> eventNames(getMaxEvents()), eventVenues(getMaxEvents()), eventCategories(getMaxEvents());
+     vector<int> eventDates(getMaxEvents()), eventCapacities(getMaxEvents()), eventAvailable(getMaxEvents());
+     vector<int> eventGenerations(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     for (int i = 0; i < eventCount; i++) {
+         eventNames[i] = "Event " + to_string(i);
+         eventDates[i] = 20000 + i;
+         eventVenues[i] = "Venue " + to_string(i % 3);
+         eventCategories[i] = i % 2 == 0 ? "Music" : "Sports";
+         eventPrices[i] = 10.25 + i;
+         eventCapacities[i] = 100 + i;
+         eventAvailable[i] = 50 + i;
+         eventGenerations[i] = 2 * (i % 3);
+     }
+     eventNames[7] = "";
+     eventVenues[7] = "";
+     eventCategories[7] = "";
+     eventGenerations[7] = 3;
+     eventSeatMaps[3 * getMaxSeatRows()] = 0xF0F0F0F0F0F0F0F0ULL;
+     eventSeatMaps[3 * getMaxSeatRows() + getMaxSeatRows() - 1] = 1;
+     vector<int> dirtyPartitions(getMaxEventPartitions(), 1);
+     saveEventsToTXT(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0],
+                     &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], &eventSeatMaps[0], eventCount,
+                     &dirtyPartitions[0]);
+     
+     vector<string> loadedNames(getMaxEvents()), loadedVenues(getMaxEvents()), loadedCategories(getMaxEvents());
+     vector<int> loadedDates(getMaxEvents()), loadedCapacities(getMaxEvents()), loadedAvailable(getMaxEvents());
+     vector<int> loadedGenerations(getMaxEvents()), freeList(getMaxEvents());
+     vector<double> loadedPrices(getMaxEvents());
+     vector<unsigned long long> loadedSeatMaps(getMaxEvents() * getMaxSeatRows());
+     int freeCount = 0;
+     int loadedCount = 0;
+     loadEventsFromTXT(&loadedNames[0], &loadedDates[0], &loadedVenues[0], &loadedCategories[0], &loadedPrices[0],
+                       &loadedCapacities[0], &loadedAvailable[0], &loadedGenerations[0], &freeList[0], freeCount,
+                       loadedCount);
+     loadSeatRecords(&loadedAvailable[0], &loadedGenerations[0], loadedCount);
+     loadSeatMaps(&loadedSeatMaps[0], &loadedGenerations[0], loadedCount);
+     
+     bool same = loadedCount == eventCount;
+     for (int i = 0; same && i < eventCount; i++) {
+         same = loadedGenerations[i] == eventGenerations[i];
+         if (same && i != 7) {
+             same = loadedNames[i] == eventNames[i] && loadedDates[i] == eventDates[i] &&
+                    loadedVenues[i] == eventVenues[i] && loadedCategories[i] == eventCategories[i] &&
+                    loadedPrices[i] == eventPrices[i] && loadedCapacities[i] == eventCapacities[i] &&
+                    loadedAvailable[i] == eventAvailable[i];
+         }
+     }
+     check(same, "events_N.txt partitions round-trip", failures);
+     check(freeCount == 1 && freeList[0] == 7, "events_N.txt tombstone goes back on the free list", failures);
+     check(loadedSeatMaps == eventSeatMaps, "events.seats round-trips", failures);
+     
+     // A booking rewrites one events.avail record in place
+     writeSeatRecord(5, 12);
+     loadSeatRecords(&loadedAvailable[0], &loadedGenerations[0], loadedCount);
+     check(loadedAvailable[5] == 12 && loadedAvailable[4] == eventAvailable[4], "events.avail record round-trips",
+           failures);
+     
+     // A header cut off mid-write reads as no manifest, the load falls back to events.txt and there is none
+     ofstream torn("events.idx");
+     torn << "123|";
+     torn.close();
+     loadedCount = 0;
+     freeCount = 0;
+     loadEventsFromTXT(&loadedNames[0], &loadedDates[0], &loadedVenues[0], &loadedCategories[0], &loadedPrices[0],
+                       &loadedCapacities[0], &loadedAvailable[0], &loadedGenerations[0], &freeList[0], freeCount,
+                       loadedCount);
+     check(loadedCount == 0, "events.idx torn header is ignored", failures);
+ }
+ 
+ void testTicketFiles(int& failures) {
+     // Enough tickets for two partitions, with cancelled, seated and Last Seats rows
+     string usernames[2] = {"alice", "bob"};
+     int userGenerations[2] = {0, 2};
+     int ticketCount = getTicketSegmentSize() + 100;
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets());
+     vector<double> ticketCosts(getMaxTickets());
+     for (int i = 0; i < ticketCount; i++) {
+         ticketIDs[i] = 1001 + 2 * i;
+         ticketUserIDs[i] = makeHandle(i % 2, userGenerations[i % 2]);
+         ticketEventIDs[i] = makeHandle(i % 40, 2 * (i % 3));
+         ticketQuantities[i] = i % 7 == 0 ? 0 : 1 + i % 4;
+         ticketCosts[i] = 12.5 * ticketQuantities[i];
+         ticketDates[i] = 20000 + i % 300;
+         ticketHours[i] = i % 24;
+         ticketSeats[i] = i % 5 == 0 ? -1 : i % (getSeatsPerRow() * getMaxSeatRows());
+         ticketTiers[i] = i % 2;
+     }
+     saveTicketsToTXT(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0],
+                      &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0], ticketCount, 0);
+     
+     vector<int> loadedIDs(getMaxTickets()), loadedUserIDs(getMaxTickets()), loadedEventIDs(getMaxTickets());
+     vector<int> loadedQuantities(getMaxTickets()), loadedDates(getMaxTickets()), loadedHours(getMaxTickets());
+     vector<int> loadedSeats(getMaxTickets()), loadedTiers(getMaxTickets());
+     vector<double> loadedCosts(getMaxTickets());
+     int loadedCount = 0;
+     loadTicketsFromTXT(&loadedIDs[0], &loadedUserIDs[0], &loadedEventIDs[0], &loadedQuantities[0], &loadedCosts[0],
+                        &loadedDates[0], &loadedHours[0], &loadedSeats[0], &loadedTiers[0], loadedCount, usernames,
+                        userGenerations, 2);
+     bool same = loadedCount == ticketCount;
+     for (int i = 0; same && i < ticketCount; i++) {
+         same = loadedIDs[i] == ticketIDs[i] && loadedUserIDs[i] == ticketUserIDs[i] &&
+                loadedEventIDs[i] == ticketEventIDs[i] && loadedQuantities[i] == ticketQuantities[i] &&
+                loadedCosts[i] == ticketCosts[i] && loadedDates[i] == ticketDates[i] &&
+                loadedHours[i] == ticketHours[i] && loadedSeats[i] == ticketSeats[i] &&
+                loadedTiers[i] == ticketTiers[i];
+     }
+     check(same, "tickets_N.txt partitions round-trip", failures);
+     
+     vector<long long> segmentOffsets(getMaxTicketSegments());
+     vector<int> segmentMinIDs(getMaxTicketSegments()), segmentMaxIDs(getMaxTicketSegments());
+     bool* segmentLoaded = new bool[getMaxTicketSegments()];
+     int segmentCount = 0;
+     int indexedCount = 0;
+     bool indexed = loadTicketIndex(&segmentOffsets[0], &segmentMinIDs[0], &segmentMaxIDs[0], segmentLoaded,
+                                    segmentCount, indexedCount);
+     check(indexed && segmentCount == 2 && indexedCount == ticketCount && segmentMinIDs[0] == ticketIDs[0] &&
+           segmentMaxIDs[1] == ticketIDs[ticketCount - 1], "tickets.idx round-trips", failures);
+     
+     // Paging the second partition in on its own gives the same rows
+     int first = getTicketSegmentSize();
+     loadedIDs.assign(getMaxTickets(), 0);
+     loadTicketSegment(1, &loadedIDs[0], &loadedUserIDs[0], &loadedEventIDs[0], &loadedQuantities[0],
+                       &loadedCosts[0], &loadedDates[0], &loadedHours[0], &loadedSeats[0], &loadedTiers[0],
+                       segmentLoaded, indexedCount, usernames, userGenerations, 2);
+     same = segmentLoaded[1] && loadedIDs[first - 1] == 0;
+     for (int i = first; same && i < ticketCount; i++) {
+         same = loadedIDs[i] == ticketIDs[i] && loadedSeats[i] == ticketSeats[i] && loadedTiers[i] == ticketTiers[i];
+     }
+     check(same, "tickets_N.txt partition pages in on its own", failures);
+     delete[] segmentLoaded;
+     
+     // A later booking rewrites the last partition only
+     long long firstSize = getFileSize(getTicketPartitionFileName(0));
+     ticketQuantities[ticketCount - 1] = 9;
+     saveTicketsToTXT(&ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0],
+                      &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0], ticketCount,
+                      ticketCount - 1);
+     loadTicketsFromTXT(&loadedIDs[0], &loadedUserIDs[0], &loadedEventIDs[0], &loadedQuantities[0], &loadedCosts[0],
+                        &loadedDates[0], &loadedHours[0], &loadedSeats[0], &loadedTiers[0], loadedCount, usernames,
+                        userGenerations, 2);
+     check(loadedCount == ticketCount && loadedQuantities[ticketCount - 1] == 9 &&
+           getFileSize(getTicketPartitionFileName(0)) == firstSize, "tickets_N.txt dirty partition round-trips",
+           failures);
+     
+     // A row from before user handles names the user and an email, and stops at the hour
+     bool parsed = parseTicketLine("1009|bob|bob@example.com|3|2|50|01-02-2025|14", 0, &loadedIDs[0],
+                                   &loadedUserIDs[0], &loadedEventIDs[0], &loadedQuantities[0], &loadedCosts[0],
+                                   &loadedDates[0], &loadedHours[0], &loadedSeats[0], &loadedTiers[0], usernames,
+                                   userGenerations, 2);
+     check(parsed && loadedIDs[0] == 1009 && loadedUserIDs[0] == makeHandle(1, 2) && loadedEventIDs[0] == 3 &&
+           loadedQuantities[0] == 2 && loadedCosts[0] == 50 && loadedDates[0] == parseDate("01-02-2025") &&
+           loadedHours[0] == 14 && loadedSeats[0] == -1 && loadedTiers[0] == 1, "legacy ticket row migrates",
+           failures);
+     
+     // A torn or damaged index is refused instead of throwing, the caller then reads the partitions
+     string damaged[3] = {"123|", "-|" + to_string(getTicketSegmentSize()),
+                          "5|" + to_string(getTicketSegmentSize()) + "\n12|x|3"};
+     bool refused = true;
+     for (int d = 0; d < 3; d++) {
+         ofstream torn("tickets.idx");
+         torn << damaged[d] << "\n";
+         torn.close();
+         segmentLoaded = new bool[getMaxTicketSegments()];
+         refused = refused && !loadTicketIndex(&segmentOffsets[0], &segmentMinIDs[0], &segmentMaxIDs[0],
+                                               segmentLoaded, segmentCount, indexedCount);
+         delete[] segmentLoaded;
+     }
+     check(refused, "tickets.idx torn fields are refused", failures);
+     
+     for (int k = 0; remove(getTicketPartitionFileName(k).c_str()) == 0; k++) {
+     }
+     remove("tickets.idx");
+ }
+ 
+ void testWaitlistFile(int& failures) {
+     // Event 2 was deleted after its request was saved, that row is dropped on load
+     int eventGenerations[3] = {0, 2, 3};
+     int rowEvents[4] = {makeHandle(1, 2), makeHandle(0, 0), makeHandle(1, 2), makeHandle(2, 2)};
+     int rowUsers[4] = {5, 3, 6, 7};
+     int rowQuantities[4] = {2, 1, 4, 3};
+     saveWaitlistToTXT(rowEvents, rowUsers, rowQuantities, 4);
+     
+     vector<int> waitlistUserIDs(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistQuantities(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistHeads(getMaxEvents()), waitlistSizes(getMaxEvents());
+     loadWaitlistFromTXT(&waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0], &waitlistSizes[0],
+                         eventGenerations, 3);
+     int second = getWaitlistCapacity();
+     check(waitlistSizes[0] == 1 && waitlistUserIDs[0] == 3 && waitlistQuantities[0] == 1 && waitlistSizes[1] == 2 &&
+           waitlistUserIDs[second] == 5 && waitlistQuantities[second] == 2 && waitlistUserIDs[second + 1] == 6 &&
+           waitlistQuantities[second + 1] == 4 && waitlistSizes[2] == 0, "waitlist.txt round-trips in queue order",
+           failures);
+ }
+ 
+ void testJournal(int& failures) {
+     string usernames[2] = {"alice", "bob"};
+     string emails[2] = {"alice@example.com", "bob@example.com"};
+     int userGenerations[2] = {0, 2};
+     string eventNames[2] = {"Concert", "Match"};
+     int eventDates[2] = {20100, 20200};
+     string eventVenues[2] = {"Hall", "Stadium"};
+     string eventCategories[2] = {"Music", "Sports"};
+     double eventPrices[2] = {40.5, 25};
+     int eventCapacities[2] = {200, 5000};
+     int eventAvailable[2] = {150, 4000};
+     int eventGenerations[2] = {0, 4};
+     int ticketIDs[3] = {1001, 1002, 1003};
+     int ticketUserIDs[3] = {makeHandle(0, 0), makeHandle(1, 2), makeHandle(0, 0)};
+     int ticketEventIDs[3] = {makeHandle(0, 0), makeHandle(1, 4), makeHandle(1, 4)};
+     int ticketQuantities[3] = {2, 0, 3};
+     double ticketCosts[3] = {81, 0, 75};
+     int ticketDates[3] = {20001, 20002, 20003};
+     int ticketHours[3] = {9, 10, 23};
+     int ticketSeats[3] = {65, -1, -1};
+     int ticketTiers[3] = {1, 0, 0};
+     
+     ofstream journal;
+     startJournal(journal);
+     for (int i = 0; i < 2; i++) {
+         journalUser(i, usernames, emails, userGenerations, journal);
+         journalEvent(i, eventNames, eventDates, eventVenues, eventCategories, eventPrices, eventCapacities,
+                      eventAvailable, eventGenerations, 2, journal);
+     }
+     journalTickets(0, 3, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities, ticketCosts, ticketDates,
+                    ticketHours, ticketSeats, ticketTiers, journal);
+     journal.close();
+     
+     // A follower with empty tables replays the journal
+     vector<string> followerNames(getMaxUsers()), followerEmails(getMaxUsers());
+     vector<int> followerUserGenerations(getMaxUsers());
+     vector<string> followerEventNames(getMaxEvents()), followerVenues(getMaxEvents());
+     vector<string> followerCategories(getMaxEvents());
+     vector<int> followerDates(getMaxEvents()), followerCapacities(getMaxEvents()), followerAvailable(getMaxEvents());
+     vector<int> followerEventGenerations(getMaxEvents());
+     vector<double> followerPrices(getMaxEvents());
+     vector<int> followerIDs(getMaxTickets()), followerUserIDs(getMaxTickets()), followerEventIDs(getMaxTickets());
+     vector<int> followerQuantities(getMaxTickets()), followerTicketDates(getMaxTickets());
+     vector<int> followerHours(getMaxTickets()), followerSeats(getMaxTickets()), followerTiers(getMaxTickets());
+     vector<double> followerCosts(getMaxTickets());
+     vector<int> followerIDTable(getTicketIDTableSize());
+     vector<long long> metricBuckets(getMetricCount() * getMetricBucketCount());
+     vector<long long> metricStats(getMetricCount() * getMetricStatCount());
+     long long replicaState[9] = {0, 0, 0, 0, 0, 0, 0, 0, -1};
+     int userCount = 0;
+     int eventCount = 0;
+     int ticketCount = 0;
+     clearMetrics(&metricBuckets[0], &metricStats[0]);
+     buildTicketIDTable(&followerIDTable[0], &followerIDs[0], 0);
+     
+     ifstream file("journal.txt");
+     string line;
+     int applied = 0;
+     int reloads = 0;
+     while (getline(file, line)) {
+         int result = applyJournalLine(line, &followerNames[0], &followerEmails[0], &followerUserGenerations[0],
+                                       userCount, &followerEventNames[0], &followerDates[0], &followerVenues[0],
+                                       &followerCategories[0], &followerPrices[0], &followerCapacities[0],
+                                       &followerAvailable[0], &followerEventGenerations[0], eventCount,
+                                       &followerIDs[0], &followerUserIDs[0], &followerEventIDs[0],
+                                       &followerQuantities[0], &followerCosts[0], &followerTicketDates[0],
+                                       &followerHours[0], &followerSeats[0], &followerTiers[0],
+                                       &followerIDTable[0], ticketCount, replicaState, &metricBuckets[0],
+                                       &metricStats[0]);
+         applied += result == 1;
+         reloads += result == 2;
+     }
+     file.close();
+     check(applied == 7 && reloads == 1, "journal.txt lines all apply", failures);
+     
+     bool same = userCount == 2 && eventCount == 2 && ticketCount == 3;
+     for (int i = 0; same && i < 2; i++) {
+         same = followerNames[i] == usernames[i] && followerEmails[i] == emails[i] &&
+                followerUserGenerations[i] == userGenerations[i] && followerEventNames[i] == eventNames[i] &&
+                followerDates[i] == eventDates[i] && followerVenues[i] == eventVenues[i] &&
+                followerCategories[i] == eventCategories[i] && followerPrices[i] == eventPrices[i] &&
+                followerCapacities[i] == eventCapacities[i] && followerAvailable[i] == eventAvailable[i] &&
+                followerEventGenerations[i] == eventGenerations[i];
+     }
+     for (int i = 0; same && i < 3; i++) {
+         same = followerIDs[i] == ticketIDs[i] && followerUserIDs[i] == ticketUserIDs[i] &&
+                followerEventIDs[i] == ticketEventIDs[i] && followerQuantities[i] == ticketQuantities[i] &&
+                followerCosts[i] == ticketCosts[i] && followerTicketDates[i] == ticketDates[i] &&
+                followerHours[i] == ticketHours[i] && followerSeats[i] == ticketSeats[i] &&
+                followerTiers[i] == ticketTiers[i];
+     }
+     check(same, "journal.txt round-trips users, events and tickets", failures);
+     remove("journal.txt");
+ }
+ 
+ void testArchive(int& failures) {
+     // Two past events, one with a cancelled ticket, and one still to come
+     int today = getCurrentDate();
+     string eventNames[3] = {"Old Concert", "Old Match", "Next Concert"};
+     int eventDates[3] = {today - 30, today - 2, today + 30};
+     string eventVenues[3] = {"Hall", "Stadium", "Hall"};
+     string eventCategories[3] = {"Music", "Sports", "Music"};
+     double eventPrices[3] = {40, 25, 50};
+     int eventCapacities[3] = {100, 100, 100};
+     int eventAvailable[3] = {97, 99, 99};
+     int eventGenerations[3] = {0, 0, 0};
+     int eventFreeList[3];
+     int eventFreeCount = 0;
+     int ticketIDs[5] = {1001, 1002, 1003, 1004, 1005};
+     int ticketUserIDs[5] = {0, 1, 0, 1, 0};
+     int ticketEventIDs[5] = {0, 1, 0, 2, 0};
+     int ticketQuantities[5] = {2, 1, 0, 1, 1};
+     double ticketCosts[5] = {80, 31.25, 0, 50, 40};
+     int ticketDates[5] = {today - 60, today - 50, today - 40, today - 5, today - 35};
+     int ticketHours[5] = {9, 10, 11, 12, 13};
+     int ticketSeats[5] = {3, -1, 4, -1, -1};
+     int ticketTiers[5] = {0, 1, 0, 0, 0};
+     int ticketCount = 5;
+     int lastArchivedTicketID = 0;
+     
+     // A copy of the tables as they were before archiving, like after a crash before the trimmed save
+     string copyNames[3] = {eventNames[0], eventNames[1], eventNames[2]};
+     string copyVenues[3] = {eventVenues[0], eventVenues[1], eventVenues[2]};
+     string copyCategories[3] = {eventCategories[0], eventCategories[1], eventCategories[2]};
+     int copyGenerations[3] = {0, 0, 0};
+     int copyIDs[5] = {1001, 1002, 1003, 1004, 1005};
+     int copyEventIDs[5] = {0, 1, 0, 2, 0};
+     int copyCount = 5;
+     int copyLastID = 0;
+     
+     string result = archivePastEvents(today, eventNames, eventDates, eventVenues, eventCategories, eventPrices,
+                                       eventCapacities, eventAvailable, eventGenerations, eventFreeList,
+                                       eventFreeCount, 3, ticketIDs, ticketUserIDs, ticketEventIDs, ticketQuantities,
+                                       ticketCosts, ticketDates, ticketHours, ticketSeats, ticketTiers, ticketCount,
+                                       lastArchivedTicketID);
+     check(getArchiveCount() == 1 && ticketCount == 1 && ticketIDs[0] == 1004 && lastArchivedTicketID == 1005 &&
+           findLastArchivedTicketID() == 1005, "archive_N.txt keeps the last archived ticket ID", failures);
+     
+     // Cancelled tickets are kept in the segment but are not bookings, the report prints straight to cout
+     ostringstream sink;
+     streambuf* console = cout.rdbuf(sink.rdbuf());
+     viewArchivedReports();
+     cout.rdbuf(console);
+     string report = sink.str();
+     check(report.find("Archived Events: 2") != string::npos && report.find("Archived Bookings: 3") != string::npos &&
+           report.find("Archived Revenue: $151.250000") != string::npos, "archive_N.txt round-trips into reports",
+           failures);
+     
+     // The seat and tier columns come back from the segment
+     ifstream segment(getArchiveFileName(1).c_str());
+     string line;
+     string fields[10];
+     int seated = 0;
+     int lastSeats = 0;
+     while (getline(segment, line)) {
+         if (line[0] == 'T' && splitArchiveLine(line, fields, 10) == 10) {
+             seated += fields[8] != "";
+             lastSeats += fields[9] == "1";
+         }
+     }
+     segment.close();
+     check(seated == 2 && lastSeats == 1, "archive_N.txt keeps seats and tiers", failures);
+     
+     // Archiving the untrimmed copy again writes no second segment
+     archivePastEvents(today, copyNames, eventDates, copyVenues, copyCategories, eventPrices, eventCapacities,
+                       eventAvailable, copyGenerations, eventFreeList, eventFreeCount, 3, copyIDs, ticketUserIDs,
+                       copyEventIDs, ticketQuantities, ticketCosts, ticketDates, ticketHours, ticketSeats,
+                       ticketTiers, copyCount, copyLastID);
+     check(getArchiveCount() == 1 && copyCount == 1 && copyIDs[0] == 1004,
+           "archive_N.txt rows are not archived twice after a crash", failures);
+     remove(getArchiveFileName(1).c_str());
+ }
+ 
+ void testCheckIn(int& failures) {
+     // Long after the first tickets were archived: every live ID sits past the span the bitmap covers
+     int first = 1001 + getCheckInSpan() + 10;
+     int eventGenerations[2] = {0, 0};
+     int ticketIDs[6];
+     int ticketEventIDs[6] = {0, 1, 0, 1, 0, 1};
+     int ticketQuantities[6] = {1, 2, 0, 1, 1, 3};
+     for (int i = 0; i < 6; i++) {
+         ticketIDs[i] = first + i;
+     }
+     int ticketCount = 6;
+     int lastArchivedTicketID = first - 1;
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     buildTicketIDTable(&ticketIDTable[0], ticketIDs, ticketCount);
+     vector<unsigned long long> checkInBloom(getBloomFilterWords()), checkInBitmap(getCheckInWords());
+     vector<long long> metricBuckets(getMetricCount() * getMetricBucketCount());
+     vector<long long> metricStats(getMetricCount() * getMetricStatCount());
+     clearMetrics(&metricBuckets[0], &metricStats[0]);
+     long long checkInState[9] = {-1, 0, 0, 0, 0, 0, 0, 0, 0};
+     ofstream checkInLog;
+     syncCheckInTables(&checkInBloom[0], &checkInBitmap[0], ticketIDs, ticketCount, lastArchivedTicketID,
+                       checkInState);
+     
+     // Each scan is one batch so checkInState counts exactly one result
+     int scans[6] = {first, first, first + 100, first + 2, first + 1, first + 1};
+     int gates[6] = {-1, -1, -1, -1, 0, -1};
+     // An ID that was never issued but gets past the filter, like a false positive
+     addToBloomFilter(first + 100, &checkInBloom[0]);
+     int results[6];
+     for (int i = 0; i < 6; i++) {
+         long long before[6];
+         for (int r = 0; r < 6; r++) {
+             before[r] = checkInState[2 + r];
+         }
+         checkInBatch(to_string(scans[i]), gates[i], &checkInBloom[0], &checkInBitmap[0], &ticketIDTable[0],
+                      ticketIDs, ticketEventIDs, ticketQuantities, eventGenerations, 2, checkInState, checkInLog,
+                      &metricBuckets[0], &metricStats[0]);
+         results[i] = -1;
+         for (int r = 0; r < 6; r++) {
+             if (checkInState[2 + r] == before[r] + 1) {
+                 results[i] = r;
+             }
+         }
+     }
+     check(checkInState[8] == first && results[0] == 0, "check-in admits IDs past the old fixed span", failures);
+     check(results[1] == 1, "check-in rejects a second scan of the same ticket", failures);
+     check(mayContainTicketID(first + 100, &checkInBloom[0]) && results[2] == 2,
+           "check-in Bloom false positive falls through to the ticket table", failures);
+     check(results[3] == 3 && results[4] == 4 && results[5] == 0,
+           "check-in rejects cancelled and wrong-event tickets", failures);
+     checkInLog.close();
+     
+     // An archive takes out the first and third tickets but leaves the second, booked for a future event, so
+     // the lowest live ID sits below the last archived one. Its admission comes back from checkins.txt
+     int keptIDs[4] = {first + 1, first + 3, first + 4, first + 5};
+     int keptEventIDs[4] = {1, 1, 0, 1};
+     int keptQuantities[4] = {2, 1, 1, 3};
+     buildTicketIDTable(&ticketIDTable[0], keptIDs, 4);
+     syncCheckInTables(&checkInBloom[0], &checkInBitmap[0], keptIDs, 4, first + 2, checkInState);
+     int before = (int)checkInState[3];
+     checkInBatch(to_string(first + 1), -1, &checkInBloom[0], &checkInBitmap[0], &ticketIDTable[0], keptIDs,
+                  keptEventIDs, keptQuantities, eventGenerations, 2, checkInState, checkInLog, &metricBuckets[0],
+                  &metricStats[0]);
+     check(checkInState[8] == first + 1 && checkInState[3] == before + 1,
+           "check-in bitmap is rebuilt from checkins.txt when the lowest live ID moves", failures);
+     checkInLog.close();
+     remove("checkins.txt");
+ }
+ 
+ void testBulkUpdate(int& failures) {
+     // Slot 3 is deleted, slot 4 is general admission and slot 5 is a seated event close to the seat map limit
+     int eventCount = 6;
+     string names[6] = {"Gig", "Derby", "Jam", "", "Festival", "Opera"};
+     string categories[6] = {"Music", "Sports", "Music Live", "", "Music", "Music"};
+     string venues[6] = {"Hall", "Music", "Hall", "", "Arena", "Hall"};
+     int dates[6] = {20010, 20020, 20030, 0, 20040, 20050};
+     double prices[6] = {30, 10, 20, 0, 50, 40};
+     int capacities[6] = {100, 200, 300, 0, 5000, getSeatsPerRow() * getMaxSeatRows() - 10};
+     int available[6] = {100, 0, 300, 0, 5000, 50};
+     vector<int> eventGenerations(getMaxEvents()), eventFreeList(getMaxEvents());
+     vector<string> eventNames(getMaxEvents()), eventVenues(getMaxEvents()), eventCategories(getMaxEvents());
+     vector<int> eventDates(getMaxEvents()), eventCapacities(getMaxEvents()), eventAvailable(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents()), eventRevenue(getMaxEvents());
+     for (int i = 0; i < eventCount; i++) {
+         eventNames[i] = names[i];
+         eventCategories[i] = categories[i];
+         eventVenues[i] = venues[i];
+         eventDates[i] = dates[i];
+         eventPrices[i] = prices[i];
+         eventCapacities[i] = capacities[i];
+         eventAvailable[i] = available[i];
+     }
+     eventGenerations[3] = 1;
+     eventFreeList[0] = 3;
+     int eventFreeCount = 1;
+     int liveCount = eventCount - eventFreeCount;
+     
+     vector<int> selected(getMaxEvents());
+     int byCategory = selectEvents("Music", "", 0, 20045, &eventCategories[0], &eventVenues[0], &eventDates[0],
+                                   &eventGenerations[0], eventCount, &selected[0]);
+     check(byCategory == 2 && selected[0] && selected[4] && !selected[1] && !selected[2] && !selected[5],
+           "bulk select matches the category exactly and not the venue", failures);
+     int byVenue = selectEvents("", "Hall", 0, 99999, &eventCategories[0], &eventVenues[0], &eventDates[0],
+                                &eventGenerations[0], eventCount, &selected[0]);
+     int byBoth = selectEvents("Music", "Hall", 0, 99999, &eventCategories[0], &eventVenues[0], &eventDates[0],
+                               &eventGenerations[0], eventCount, &selected[0]);
+     check(byVenue == 3 && byBoth == 2 && selected[0] && selected[5] && !selected[2],
+           "bulk select combines category, venue and dates", failures);
+     
+     // The indexes only list live events, like after loading and compacting
+     vector<int> eventDateIndex(getMaxEvents()), eventPriceIndex(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     int liveSlots[5] = {0, 1, 2, 4, 5};
+     for (int i = 0; i < liveCount; i++) {
+         eventDateIndex[i] = liveSlots[i];
+         eventPriceIndex[i] = liveSlots[i];
+     }
+     sort(eventDateIndex.begin(), eventDateIndex.begin() + liveCount, [&eventDates](int a, int b) {
+         return eventDates[a] < eventDates[b];
+     });
+     sort(eventPriceIndex.begin(), eventPriceIndex.begin() + liveCount, [&eventPrices](int a, int b) {
+         return eventPrices[a] < eventPrices[b];
+     });
+     int availableCount = 0;
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     vector<int> eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> waitlistHeads(getMaxEvents()), waitlistSizes(getMaxEvents());
+     int noTickets[1] = {0};
+     double noCosts[1] = {0};
+     buildLeaderboards(noTickets, noTickets, noCosts, 0, &eventCapacities[0], &eventAvailable[0], &eventRevenue[0],
+                       &eventSeatsSold[0], &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0],
+                       eventCount);
+     buildRollups(noTickets, noTickets, noCosts, noTickets, noTickets, 0, &rollupKeys[0], &rollupRevenue[0],
+                  &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     
+     // Adding seats to every Music event in the Hall would push the Opera past the seat map
+     string result = bulkUpdateEvents(1, 20, &selected[0], &eventNames[0], &eventDates[0], &eventVenues[0],
+                                      &eventCategories[0], &eventPrices[0], &eventCapacities[0], &eventAvailable[0],
+                                      &eventDateIndex[0], &eventPriceIndex[0], &availableEvents[0], &availablePos[0],
+                                      availableCount, &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                                      &leaderboardPos[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0],
+                                      &eventTiers[0], &eventTierSeatLimits[0], &eventTierDateLimits[0],
+                                      &eventSeatMaps[0], &waitlistHeads[0], &waitlistSizes[0], &eventGenerations[0],
+                                      &eventFreeList[0], eventFreeCount, eventCount);
+     check(result.find("Cannot") == 0 && eventCapacities[0] == 100 && eventCapacities[5] == capacities[5],
+           "bulk add capacity refuses to grow a seated event past the seat map", failures);
+     
+     // General admission events have no map to outgrow
+     selectEvents("", "Arena", 0, 99999, &eventCategories[0], &eventVenues[0], &eventDates[0], &eventGenerations[0],
+                  eventCount, &selected[0]);
+     bulkUpdateEvents(1, 20, &selected[0], &eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0],
+                      &eventPrices[0], &eventCapacities[0], &eventAvailable[0], &eventDateIndex[0],
+                      &eventPriceIndex[0], &availableEvents[0], &availablePos[0], availableCount, &eventRevenue[0],
+                      &eventSeatsSold[0], &leaderboardRanks[0], &leaderboardPos[0], &rollupKeys[0],
+                      &rollupRevenue[0], &rollupTickets[0], &eventTiers[0], &eventTierSeatLimits[0],
+                      &eventTierDateLimits[0], &eventSeatMaps[0], &waitlistHeads[0], &waitlistSizes[0],
+                      &eventGenerations[0], &eventFreeList[0], eventFreeCount, eventCount);
+     check(eventCapacities[4] == 5020 && eventAvailable[4] == 5020, "bulk add capacity grows general admission",
+           failures);
+     
+     // Deleting the Hall events leaves only the Derby and the Festival in both indexes, still sorted
+     selectEvents("", "Hall", 0, 99999, &eventCategories[0], &eventVenues[0], &eventDates[0], &eventGenerations[0],
+                  eventCount, &selected[0]);
+     bulkUpdateEvents(2, 0, &selected[0], &eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0],
+                      &eventPrices[0], &eventCapacities[0], &eventAvailable[0], &eventDateIndex[0],
+                      &eventPriceIndex[0], &availableEvents[0], &availablePos[0], availableCount, &eventRevenue[0],
+                      &eventSeatsSold[0], &leaderboardRanks[0], &leaderboardPos[0], &rollupKeys[0],
+                      &rollupRevenue[0], &rollupTickets[0], &eventTiers[0], &eventTierSeatLimits[0],
+                      &eventTierDateLimits[0], &eventSeatMaps[0], &waitlistHeads[0], &waitlistSizes[0],
+                      &eventGenerations[0], &eventFreeList[0], eventFreeCount, eventCount);
+     liveCount = eventCount - eventFreeCount;
+     check(liveCount == 2 && eventDateIndex[0] == 1 && eventDateIndex[1] == 4 && eventPriceIndex[0] == 1 &&
+           eventPriceIndex[1] == 4, "bulk delete removes events from the date and price indexes", failures);
+     check(availableCount == 1 && availableEvents[0] == 4 && availablePos[0] == -1 && availablePos[5] == -1,
+           "bulk delete removes events from the available set", failures);
+ }
+
+ void testPriceTiers(int& failures) {
+     // Two general admission events three seats above the last seats limit, one still in its early-bird
+     // window and one past it
+     int today = getCurrentDate();
+     int eventCount = 2;
+     vector<string> eventNames(getMaxEvents(), "Gig");
+     vector<int> eventDates(getMaxEvents()), eventCapacities(getMaxEvents(), 5000), eventAvailable(getMaxEvents());
+     vector<int> eventGenerations(getMaxEvents()), eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents(), 50), eventRevenue(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets()), ticketDateIndex(getMaxTickets());
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(getMaxTickets());
+     vector<long long> userRateTimes(getMaxUsers()), eventRateTimes(getMaxEvents());
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     int ticketCount = 0;
+     int availableCount = 0;
+     int limit = getLastSeatsLimit(5000);
+     eventDates[0] = today + getEarlyBirdDays() + 30;
+     eventDates[1] = today + getEarlyBirdDays() - 10;
+     eventAvailable[0] = limit + 3;
+     eventAvailable[1] = limit + 3;
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 0, &eventCapacities[0],
+                       &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                       &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0], 0,
+                  &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(today, &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], 0);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], 0);
+     auto book = [&](int eventIndex, int quantity) {
+         return bookTicket(0, eventIndex, quantity, &eventNames[0], &eventPrices[0], &eventAvailable[0],
+                           &availableEvents[0], &availablePos[0], availableCount, &eventCapacities[0],
+                           &eventSeatMaps[0], &eventDates[0], &eventTiers[0], &eventTierSeatLimits[0],
+                           &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                           &leaderboardPos[0], &eventGenerations[0], 0, eventCount, &ticketIDs[0],
+                           &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0],
+                           &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                           &ticketDateIndex[0], &ticketIDTable[0], &rollupKeys[0], &rollupRevenue[0],
+                           &rollupTickets[0], ticketCount, 0, -1, &userRateTimes[0], &eventRateTimes[0],
+                           &purchaseKeys[0], &purchaseCounts[0]);
+     };
+     
+     // Five seats: three at the cached tier up to the boundary, two at the Last Seats price
+     double lastSeatsPrice = 50 * getPriceTierMultiplier(2);
+     for (int e = 0; e < eventCount; e++) {
+         int tier = e == 0 ? 0 : 1;
+         double tierPrice = 50 * getPriceTierMultiplier(tier);
+         bool quoted = eventTiers[e] == tier &&
+                       getSeatsAtTierPrice(e, 5, &eventAvailable[0], &eventTiers[0], &eventTierSeatLimits[0]) == 3 &&
+                       getOrderCost(e, 5, &eventPrices[0], &eventAvailable[0], &eventTiers[0],
+                                    &eventTierSeatLimits[0]) == 3 * tierPrice + 2 * lastSeatsPrice;
+         string result = book(e, 5);
+         int split = ticketCount - 1;
+         check(quoted && ticketCount == e * 2 + 1 && ticketCosts[split] == 3 * tierPrice + 2 * lastSeatsPrice &&
+               ticketTiers[split] == tier && result.find("2 of these seats") != string::npos,
+               "order crossing into Last Seats from " + getPriceTierName(tier) + " is split at the boundary",
+               failures);
+         
+         // The event is now below the limit, the next order is Last Seats throughout
+         book(e, 1);
+         int next = ticketCount - 1;
+         check(eventTiers[e] == 2 && ticketTiers[next] == 2 && ticketCosts[next] == lastSeatsPrice &&
+               getSeatsAtTierPrice(e, 4, &eventAvailable[0], &eventTiers[0], &eventTierSeatLimits[0]) == 4 &&
+               getOrderCost(e, 4, &eventPrices[0], &eventAvailable[0], &eventTiers[0],
+                            &eventTierSeatLimits[0]) == 4 * lastSeatsPrice,
+               "booking after the boundary from " + getPriceTierName(tier) + " flips the tier to Last Seats",
+               failures);
+     }
+ }
+
+ void testWaitlistScan(int& failures) {
+     // A seated event of two rows where every other seat is sold: 64 seats free, none of them side by side
+     int eventCount = 1;
+     int userCount = 11;
+     vector<string> eventNames(getMaxEvents(), "Play"), usernames(getMaxUsers(), "fan");
+     vector<int> eventDates(getMaxEvents(), getCurrentDate() + 60), eventCapacities(getMaxEvents(), 128);
+     vector<int> eventAvailable(getMaxEvents(), 64), eventGenerations(getMaxEvents()), userGenerations(getMaxUsers());
+     vector<int> eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents(), 30), eventRevenue(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets()), ticketDateIndex(getMaxTickets());
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(getMaxTickets());
+     vector<long long> userRateTimes(getMaxUsers()), eventRateTimes(getMaxEvents());
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     vector<int> waitlistUserIDs(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistQuantities(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistHeads(getMaxEvents()), waitlistSizes(getMaxEvents());
+     int ticketCount = 0;
+     int availableCount = 0;
+     eventSeatMaps[0] = 0xAAAAAAAAAAAAAAAAULL;
+     eventSeatMaps[1] = 0xAAAAAAAAAAAAAAAAULL;
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 0, &eventCapacities[0],
+                       &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                       &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0], 0,
+                  &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], 0);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], 0);
+     auto promote = [&]() {
+         return promoteWaitlist(0, &eventNames[0], &eventPrices[0], &eventAvailable[0], &availableEvents[0],
+                                &availablePos[0], availableCount, &eventCapacities[0], &eventSeatMaps[0],
+                                &eventDates[0], &eventTiers[0], &eventTierSeatLimits[0], &eventTierDateLimits[0],
+                                &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0], &leaderboardPos[0],
+                                &eventGenerations[0], 0, eventCount, &ticketIDs[0], &ticketUserIDs[0],
+                                &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0],
+                                &ticketHours[0], &ticketSeats[0], &ticketTiers[0], &ticketDateIndex[0],
+                                &ticketIDTable[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0],
+                                ticketCount, 0, &waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0],
+                                &waitlistSizes[0], &usernames[0], &userGenerations[0], userCount,
+                                &userRateTimes[0], &eventRateTimes[0], &purchaseKeys[0], &purchaseCounts[0]);
+     };
+     auto join = [&](int userHandle, int quantity) {
+         joinWaitlist(0, userHandle, quantity, &waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0],
+                      &waitlistSizes[0]);
+     };
+     
+     // The head wants three seats together, there are enough seats but no block. It keeps its place and
+     // the single seat behind it is booked
+     join(0, 3);
+     join(1, 1);
+     promote();
+     check(ticketCount == 1 && ticketUserIDs[0] == 1 && eventAvailable[0] == 63 && waitlistSizes[0] == 1 &&
+           waitlistUserIDs[waitlistHeads[0]] == 0 &&
+           !isWaitlistShortOfSeats(0, &eventAvailable[0], &waitlistQuantities[0], &waitlistHeads[0],
+                                   &waitlistSizes[0]), "waitlist head without a seat block keeps its place",
+           failures);
+     
+     // Eight more pairs queue behind it, the single seat after them is past the scan limit and waits
+     for (int u = 2; u < 2 + getWaitlistScanLimit(); u++) {
+         join(u, 2);
+     }
+     join(2 + getWaitlistScanLimit(), 1);
+     promote();
+     check(ticketCount == 1 && waitlistSizes[0] == getWaitlistScanLimit() + 2 &&
+           waitlistUserIDs[waitlistHeads[0]] == 0, "waitlist scan stops after getWaitlistScanLimit() requests",
+           failures);
+     
+     // Once fewer seats are left than the head asks for, new bookings queue behind it
+     eventAvailable[0] = 2;
+     check(isWaitlistShortOfSeats(0, &eventAvailable[0], &waitlistQuantities[0], &waitlistHeads[0],
+                                  &waitlistSizes[0]), "waitlist head short of seats holds new bookings back", failures);
+ }
+
+ void testRateTokens(int& failures) {
+     // Slot 0 is general admission, slot 1 is sold out, slot 2 is seated with every other seat sold and
+     // slot 3 has just taken a burst of bookings
+     long long now = 1000000;
+     int eventCount = 4;
+     vector<string> eventNames(getMaxEvents(), "Final");
+     vector<int> eventDates(getMaxEvents(), getCurrentDate() + 60), eventCapacities(getMaxEvents(), 5000);
+     vector<int> eventAvailable(getMaxEvents(), 5000), eventGenerations(getMaxEvents());
+     vector<int> eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents(), 80), eventRevenue(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets()), ticketDateIndex(getMaxTickets());
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(getMaxTickets());
+     vector<long long> userRateTimes(getMaxUsers()), eventRateTimes(getMaxEvents());
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     int ticketCount = 0;
+     int availableCount = 0;
+     eventAvailable[1] = 0;
+     eventCapacities[2] = 64;
+     eventAvailable[2] = 32;
+     eventSeatMaps[2 * getMaxSeatRows()] = 0xAAAAAAAAAAAAAAAAULL;
+     eventRateTimes[3] = now + (long long)getEventBookingInterval() * getEventBookingBurst();
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 0, &eventCapacities[0],
+                       &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                       &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0], 0,
+                  &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], 0);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], 0);
+     auto book = [&](int userHandle, int eventIndex, int quantity) {
+         return bookTicket(userHandle, eventIndex, quantity, &eventNames[0], &eventPrices[0], &eventAvailable[0],
+                           &availableEvents[0], &availablePos[0], availableCount, &eventCapacities[0],
+                           &eventSeatMaps[0], &eventDates[0], &eventTiers[0], &eventTierSeatLimits[0],
+                           &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                           &leaderboardPos[0], &eventGenerations[0], 0, eventCount, &ticketIDs[0],
+                           &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0],
+                           &ticketDates[0], &ticketHours[0], &ticketSeats[0], &ticketTiers[0],
+                           &ticketDateIndex[0], &ticketIDTable[0], &rollupKeys[0], &rollupRevenue[0],
+                           &rollupTickets[0], ticketCount, 0, now, &userRateTimes[0], &eventRateTimes[0],
+                           &purchaseKeys[0], &purchaseCounts[0]);
+     };
+     
+     // Over the per-customer cap, sold out, and no block of two seats: refused before any token is taken
+     vector<long long> userBefore = userRateTimes;
+     vector<long long> eventBefore = eventRateTimes;
+     string overCap = book(0, 0, getTicketCapPerUser() + 1);
+     string soldOut = book(0, 1, 1);
+     string noBlock = book(0, 2, 2);
+     check(ticketCount == 0 && overCap.find("Limit is") == 0 && soldOut.find("Not enough seats") == 0 &&
+           noBlock.find("No 2 adjacent seats") == 0 && userRateTimes == userBefore && eventRateTimes == eventBefore,
+           "refused booking takes no rate tokens", failures);
+     
+     // The event bucket is empty, the customer's token is handed back
+     string busy = book(1, 3, 1);
+     check(ticketCount == 0 && busy.find("This event is taking too many bookings") == 0 &&
+           userRateTimes[1] == userBefore[1] && eventRateTimes[3] == eventBefore[3],
+           "event bucket refusal gives back the customer's token", failures);
+     
+     // A customer can book getUserBookingBurst() times back to back, the next attempt waits
+     for (int i = 0; i < getUserBookingBurst(); i++) {
+         book(2, 0, 1);
+     }
+     string sixth = book(2, 0, 1);
+     check(ticketCount == getUserBookingBurst() && sixth.find("Too many booking attempts") == 0 &&
+           eventRateTimes[0] == now + (long long)getEventBookingInterval() * getUserBookingBurst(),
+           "booking after the customer's burst is refused", failures);
+ }
+
+ void testCancellation(int& failures) {
+     // One general admission event with four seats left
+     int eventCount = 1;
+     int userCount = 3;
+     vector<string> eventNames(getMaxEvents(), "Derby"), usernames(getMaxUsers(), "fan");
+     vector<int> eventDates(getMaxEvents(), getCurrentDate() + 60), eventCapacities(getMaxEvents(), 5000);
+     vector<int> eventAvailable(getMaxEvents(), 4), eventGenerations(getMaxEvents()), userGenerations(getMaxUsers());
+     vector<int> eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents(), 45), eventRevenue(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets()), ticketDateIndex(getMaxTickets());
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(getMaxTickets());
+     vector<long long> userRateTimes(getMaxUsers()), eventRateTimes(getMaxEvents());
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     vector<int> waitlistUserIDs(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistQuantities(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistHeads(getMaxEvents()), waitlistSizes(getMaxEvents());
+     int ticketCount = 0;
+     int availableCount = 0;
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 0, &eventCapacities[0],
+                       &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                       &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0], 0,
+                  &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], 0);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], 0);
+     auto cancel = [&](int ticketID, int userHandle) {
+         int eventIndex = -1;
+         return cancelTicket(ticketID, userHandle, &ticketIDTable[0], &ticketIDs[0], &ticketUserIDs[0],
+                             &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0],
+                             &ticketHours[0], &ticketSeats[0], &eventAvailable[0], &eventPrices[0],
+                             &availableEvents[0], &availablePos[0], availableCount, &eventCapacities[0],
+                             &eventSeatMaps[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                             &leaderboardPos[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0],
+                             &eventGenerations[0], 0, eventCount, &purchaseKeys[0], &purchaseCounts[0], eventIndex);
+     };
+     
+     // The first customer buys the last four seats, two more join the waitlist in turn
+     bookTicket(0, 0, 4, &eventNames[0], &eventPrices[0], &eventAvailable[0], &availableEvents[0], &availablePos[0],
+                availableCount, &eventCapacities[0], &eventSeatMaps[0], &eventDates[0], &eventTiers[0],
+                &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0],
+                &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0], 0, eventCount, &ticketIDs[0],
+                &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0],
+                &ticketHours[0], &ticketSeats[0], &ticketTiers[0], &ticketDateIndex[0], &ticketIDTable[0],
+                &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], ticketCount, 0, -1, &userRateTimes[0],
+                &eventRateTimes[0], &purchaseKeys[0], &purchaseCounts[0]);
+     int bookedID = ticketIDs[0];
+     joinWaitlist(0, 1, 3, &waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0], &waitlistSizes[0]);
+     joinWaitlist(0, 2, 2, &waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0], &waitlistSizes[0]);
+     
+     // Cancelling takes the sale out of every running total
+     string result = cancel(bookedID, 0);
+     double revenue = 0;
+     int rolledUp = readRollup(1, 0, ticketDates[0], &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], revenue);
+     int held = getPurchaseCount(0, makeHandle(0, 0), &purchaseKeys[0], &purchaseCounts[0]);
+     check(result.find("cancelled") != string::npos && ticketQuantities[0] == 0 && ticketCosts[0] == 0 &&
+           eventAvailable[0] == 4 && availableCount == 1 && eventRevenue[0] == 0 && eventSeatsSold[0] == 0 &&
+           rolledUp == 0 && revenue == 0 && held == 0,
+           "cancel returns seats, revenue, rollups and the purchase count", failures);
+     check(cancel(bookedID, 0).find("already cancelled") != string::npos && eventAvailable[0] == 4,
+           "cancel refuses a ticket that is already cancelled", failures);
+     
+     // The returned seats go to the oldest request, the one behind it needs more than is left and waits
+     promoteWaitlist(0, &eventNames[0], &eventPrices[0], &eventAvailable[0], &availableEvents[0], &availablePos[0],
+                     availableCount, &eventCapacities[0], &eventSeatMaps[0], &eventDates[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0],
+                     &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0], 0, eventCount, &ticketIDs[0],
+                     &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0],
+                     &ticketHours[0], &ticketSeats[0], &ticketTiers[0], &ticketDateIndex[0], &ticketIDTable[0],
+                     &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], ticketCount, 0, &waitlistUserIDs[0],
+                     &waitlistQuantities[0], &waitlistHeads[0], &waitlistSizes[0], &usernames[0],
+                     &userGenerations[0], userCount, &userRateTimes[0], &eventRateTimes[0], &purchaseKeys[0],
+                     &purchaseCounts[0]);
+     check(ticketCount == 2 && ticketUserIDs[1] == 1 && ticketQuantities[1] == 3 && eventAvailable[0] == 1 &&
+           waitlistSizes[0] == 1 && waitlistUserIDs[waitlistHeads[0]] == 2,
+           "returned seats go to the oldest waitlist request first", failures);
+     check(ticketIDs[1] > bookedID && findTicketIndex(bookedID, &ticketIDTable[0], &ticketIDs[0]) == 0,
+           "cancelled ticket ID is never reused", failures);
+ }
+
+ void testCompaction(int& failures) {
+     vector<string> eventNames(getMaxEvents()), eventVenues(getMaxEvents()), eventCategories(getMaxEvents());
+     vector<int> eventDates(getMaxEvents()), eventCapacities(getMaxEvents()), eventAvailable(getMaxEvents());
+     vector<int> eventGenerations(getMaxEvents()), eventFreeList(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> waitlistUserIDs(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistQuantities(getMaxEvents() * getWaitlistCapacity());
+     vector<int> waitlistHeads(getMaxEvents()), waitlistSizes(getMaxEvents());
+     int eventCount = 0;
+     int eventFreeCount = 0;
+     for (int i = 0; i < 3; i++) {
+         int slot = allocateSlot(&eventGenerations[0], &eventFreeList[0], eventFreeCount, eventCount, getMaxEvents());
+         eventNames[slot] = "Event " + to_string(i);
+     }
+     int ticketEventIDs[3] = {makeHandle(0, 0), 0, makeHandle(2, 0)};
+     
+     // Slot 0 is deleted and reused, the ticket for the old event must not follow it to the new one
+     releaseSlot(0, &eventGenerations[0], &eventFreeList[0], eventFreeCount);
+     allocateSlot(&eventGenerations[0], &eventFreeList[0], eventFreeCount, eventCount, getMaxEvents());
+     eventNames[0] = "Reused";
+     ticketEventIDs[1] = makeHandle(0, eventGenerations[0]);
+     check(resolveHandle(ticketEventIDs[0], &eventGenerations[0], eventCount) == -1 &&
+           resolveHandle(ticketEventIDs[1], &eventGenerations[0], eventCount) == 0,
+           "handle stops resolving once its slot is deleted and reused", failures);
+     
+     // Deleting slot 1 leaves a tombstone, compaction moves slot 2 down and starts every generation over
+     releaseSlot(1, &eventGenerations[0], &eventFreeList[0], eventFreeCount);
+     bool moved = compactEvents(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0],
+                                &eventPrices[0], &eventCapacities[0], &eventAvailable[0], &eventGenerations[0],
+                                eventFreeCount, eventCount, ticketEventIDs, 3, &waitlistUserIDs[0],
+                                &waitlistQuantities[0], &waitlistHeads[0], &waitlistSizes[0], &eventSeatMaps[0]);
+     int reused = resolveHandle(ticketEventIDs[1], &eventGenerations[0], eventCount);
+     int last = resolveHandle(ticketEventIDs[2], &eventGenerations[0], eventCount);
+     check(moved && eventCount == 2 && eventGenerations[0] == 0 && eventGenerations[1] == 0 &&
+           ticketEventIDs[0] == -1 && reused == 0 && eventNames[reused] == "Reused" && last == 1 &&
+           eventNames[last] == "Event 2", "handles resolve again after compaction resets generations", failures);
+     
+     // A slot that was reused many times is compacted even with no tombstone left
+     eventGenerations[1] = getGenerationLimit();
+     ticketEventIDs[2] = makeHandle(1, getGenerationLimit());
+     moved = compactEvents(&eventNames[0], &eventDates[0], &eventVenues[0], &eventCategories[0], &eventPrices[0],
+                           &eventCapacities[0], &eventAvailable[0], &eventGenerations[0], eventFreeCount, eventCount,
+                           ticketEventIDs, 3, &waitlistUserIDs[0], &waitlistQuantities[0], &waitlistHeads[0],
+                           &waitlistSizes[0], &eventSeatMaps[0]);
+     check(moved && eventGenerations[1] == 0 && ticketEventIDs[2] == makeHandle(1, 0),
+           "compaction starts old generations over before handles overflow", failures);
+ }
+
+ void testRequestKeys(int& failures) {
+     // Two general admission events, the kiosk sends its request key with each booking
+     int eventCount = 2;
+     long long now = 1700000000;
+     vector<string> eventNames(getMaxEvents(), "Expo");
+     vector<int> eventDates(getMaxEvents(), getCurrentDate() + 60), eventCapacities(getMaxEvents(), 5000);
+     vector<int> eventAvailable(getMaxEvents(), 5000), eventGenerations(getMaxEvents());
+     vector<int> eventSeatsSold(getMaxEvents()), eventTiers(getMaxEvents());
+     vector<int> eventTierSeatLimits(getMaxEvents()), eventTierDateLimits(getMaxEvents());
+     vector<int> availableEvents(getMaxEvents()), availablePos(getMaxEvents());
+     vector<double> eventPrices(getMaxEvents(), 15), eventRevenue(getMaxEvents());
+     vector<unsigned long long> eventSeatMaps(getMaxEvents() * getMaxSeatRows(), 0);
+     vector<int> leaderboardRanks(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> leaderboardPos(getLeaderboardMetricCount() * getMaxEvents());
+     vector<int> rollupKeys(getRollupSize()), rollupTickets(getRollupSize());
+     vector<double> rollupRevenue(getRollupSize());
+     vector<int> ticketIDs(getMaxTickets()), ticketUserIDs(getMaxTickets()), ticketEventIDs(getMaxTickets());
+     vector<int> ticketQuantities(getMaxTickets()), ticketDates(getMaxTickets()), ticketHours(getMaxTickets());
+     vector<int> ticketSeats(getMaxTickets()), ticketTiers(getMaxTickets()), ticketDateIndex(getMaxTickets());
+     vector<int> ticketIDTable(getTicketIDTableSize());
+     vector<double> ticketCosts(getMaxTickets());
+     vector<long long> userRateTimes(getMaxUsers()), eventRateTimes(getMaxEvents());
+     vector<long long> purchaseKeys(getPurchaseTableSize());
+     vector<int> purchaseCounts(getPurchaseTableSize());
+     vector<unsigned long long> requestKeyHashes(getRequestKeyTableSize());
+     vector<int> requestKeyTicketIDs(getRequestKeyTableSize());
+     vector<long long> requestKeyTimes(getRequestKeyTableSize());
+     int ticketCount = 0;
+     int availableCount = 0;
+     clearRequestKeys(&requestKeyHashes[0], &requestKeyTicketIDs[0], &requestKeyTimes[0]);
+     buildAvailableSet(&eventAvailable[0], &eventPrices[0], eventCount, &availableEvents[0], &availablePos[0],
+                       availableCount);
+     buildLeaderboards(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], 0, &eventCapacities[0],
+                       &eventAvailable[0], &eventRevenue[0], &eventSeatsSold[0], &leaderboardRanks[0],
+                       &leaderboardPos[0], &eventGenerations[0], eventCount);
+     buildRollups(&ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketDates[0], &ticketHours[0], 0,
+                  &rollupKeys[0], &rollupRevenue[0], &rollupTickets[0], &eventGenerations[0], eventCount);
+     buildPriceTiers(getCurrentDate(), &eventDates[0], &eventCapacities[0], &eventAvailable[0], &eventTiers[0],
+                     &eventTierSeatLimits[0], &eventTierDateLimits[0], &eventGenerations[0], eventCount);
+     buildTicketIDTable(&ticketIDTable[0], &ticketIDs[0], 0);
+     buildPurchaseCounts(&purchaseKeys[0], &purchaseCounts[0], &ticketUserIDs[0], &ticketEventIDs[0],
+                         &ticketQuantities[0], 0);
+     // Like the booking menu: a key seen within the window gets the original ticket back, anything else books
+     auto request = [&](string requestKey, int userHandle, int eventIndex, long long when) {
+         int repeatTicketID = findRequestKey(hashRequestKey(requestKey, userHandle), when, &requestKeyHashes[0],
+                                             &requestKeyTicketIDs[0], &requestKeyTimes[0]);
+         if (repeatTicketID != -1) {
+             return repeatBooking(repeatTicketID, eventIndex, &ticketIDTable[0], &eventNames[0], &ticketIDs[0],
+                                  &ticketEventIDs[0], &ticketQuantities[0], &ticketCosts[0], &ticketSeats[0],
+                                  &ticketTiers[0], &eventGenerations[0], eventCount);
+         }
+         int ticketsBefore = ticketCount;
+         string result = bookTicket(userHandle, eventIndex, 2, &eventNames[0], &eventPrices[0], &eventAvailable[0],
+                                    &availableEvents[0], &availablePos[0], availableCount, &eventCapacities[0],
+                                    &eventSeatMaps[0], &eventDates[0], &eventTiers[0], &eventTierSeatLimits[0],
+                                    &eventTierDateLimits[0], &eventRevenue[0], &eventSeatsSold[0],
+                                    &leaderboardRanks[0], &leaderboardPos[0], &eventGenerations[0], 0, eventCount,
+                                    &ticketIDs[0], &ticketUserIDs[0], &ticketEventIDs[0], &ticketQuantities[0],
+                                    &ticketCosts[0], &ticketDates[0], &ticketHours[0], &ticketSeats[0],
+                                    &ticketTiers[0], &ticketDateIndex[0], &ticketIDTable[0], &rollupKeys[0],
+                                    &rollupRevenue[0], &rollupTickets[0], ticketCount, 0, -1, &userRateTimes[0],
+                                    &eventRateTimes[0], &purchaseKeys[0], &purchaseCounts[0]);
+         if (ticketCount > ticketsBefore) {
+             rememberRequestKey(hashRequestKey(requestKey, userHandle), ticketIDs[ticketCount - 1], when,
+                                &requestKeyHashes[0], &requestKeyTicketIDs[0], &requestKeyTimes[0]);
+         }
+         return result;
+     };
+     
+     request("kiosk-7", 0, 0, now);
+     int firstID = ticketIDs[0];
+     string retry = request("kiosk-7", 0, 0, now + getRequestKeySeconds() - 1);
+     check(ticketCount == 1 && eventAvailable[0] == 4998 && retry.find("Request already handled") == 0 &&
+           retry.find("TKT-" + to_string(firstID)) != string::npos,
+           "request key retry returns the original ticket without booking again", failures);
+     
+     // Another customer may pick the same key, and the key does not carry over to another event
+     string otherUser = request("kiosk-7", 1, 0, now + 1);
+     string otherEvent = request("kiosk-7", 0, 1, now + 1);
+     check(ticketCount == 2 && ticketUserIDs[1] == 1 && otherUser.find("Ticket booked") == 0 &&
+           otherEvent.find("another event") != string::npos && eventAvailable[1] == 5000,
+           "request key is only a repeat for the same customer and event", failures);
+     
+     // Once the window has passed the same key books a new ticket
+     string expired = request("kiosk-7", 0, 0, now + getRequestKeySeconds());
+     check(ticketCount == 3 && ticketUserIDs[2] == 0 && ticketIDs[2] != firstID &&
+           expired.find("Ticket booked") == 0, "expired request key books again", failures);
+ }